@@ -0,0 +1,804 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "math/matrix.h"
+#include "math/Quaternion.h"
+#include "math/vector.h"
+#include "performance/benchmark.h"
+#include "physics/broadphase.h"
+#include "system/camera.h"
+#include "system/context.h"
+#include "system/depth_sort.h"
+#include "system/entities.h"
+#include "system/light_clusters.h"
+#include "system/light_discs.h"
+#include "system/NullRenderer.h"
+#include "system/ObjectPool.h"
+#include "system/ObjLoader.h"
+#include "system/scene.h"
+#include "system/yaml_parser.h"
+
+using namespace Gamma;
+
+constexpr static u32 POOL_SIZE = 50000;
+constexpr static u32 MATRIX_OPERATIONS = 100000;
+constexpr static u32 TOTAL_LIGHTS = 10000;
+constexpr static u32 OBJ_GRID_SIZE = 128;
+constexpr static u32 YAML_MESHES = 500;
+constexpr static u32 TOTAL_BULLETS = 10000;
+constexpr static u32 TOTAL_TARGETS = 500;
+constexpr static u32 DEPTH_SORT_SIZE = 100000;
+
+/**
+ * BenchmarkOptions
+ * ----------------
+ */
+struct BenchmarkOptions {
+  u32 warmup = 3;
+  u32 repetitions = 15;
+  float threshold = 0.1f;
+  const char* filter = nullptr;
+  const char* outputPath = "benchmark_results.json";
+  const char* baselinePath = nullptr;
+  bool list = false;
+};
+
+static std::mt19937 rng(1234);
+
+static float Gm_RandomInRange(float low, float high) {
+  return std::uniform_real_distribution<float>(low, high)(rng);
+}
+
+static Vec3f Gm_RandomPosition(float range) {
+  return Vec3f(
+    Gm_RandomInRange(-range, range),
+    Gm_RandomInRange(-range, range),
+    Gm_RandomInRange(-range, range)
+  );
+}
+
+/**
+ * Gm_FillObjectPool
+ * -----------------
+ *
+ * Resets a pool, and fills it with randomly placed objects.
+ */
+static void Gm_FillObjectPool(ObjectPool& pool, u32 total) {
+  pool.reset();
+
+  for (u32 i = 0; i < total; i++) {
+    auto& object = pool.createObject();
+
+    object.position = Gm_RandomPosition(1000.f);
+    object.scale = Vec3f(1.f);
+    object.rotation = Quaternion(1.f, 0, 0, 0);
+  }
+
+  pool.showAll();
+}
+
+/**
+ * Gm_WriteObjFile
+ * ---------------
+ *
+ * Writes a triangulated grid with texture coordinates
+ * and normals to a temporary .obj file.
+ */
+static std::string Gm_WriteObjFile(u32 size) {
+  auto path = (std::filesystem::temp_directory_path() / "gamma_benchmark.obj").string();
+  FILE* file = fopen(path.c_str(), "w");
+
+  for (u32 z = 0; z <= size; z++) {
+    for (u32 x = 0; x <= size; x++) {
+      fprintf(file, "v %f %f %f\n", (float)x, Gm_RandomInRange(0.f, 1.f), (float)z);
+      fprintf(file, "vt %f %f\n", (float)x / (float)size, (float)z / (float)size);
+      fprintf(file, "vn 0.000000 1.000000 0.000000\n");
+    }
+  }
+
+  for (u32 z = 0; z < size; z++) {
+    for (u32 x = 0; x < size; x++) {
+      u32 v1 = z * (size + 1) + x + 1;
+      u32 v2 = v1 + 1;
+      u32 v3 = v1 + size + 1;
+      u32 v4 = v3 + 1;
+
+      fprintf(file, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", v1, v1, v1, v3, v3, v3, v2, v2, v2);
+      fprintf(file, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", v2, v2, v2, v3, v3, v3, v4, v4, v4);
+    }
+  }
+
+  fclose(file);
+
+  return path;
+}
+
+/**
+ * Gm_WriteYamlFile
+ * ----------------
+ *
+ * Writes a scene-like .yaml file to a temporary file.
+ */
+static std::string Gm_WriteYamlFile(u32 totalMeshes) {
+  auto path = (std::filesystem::temp_directory_path() / "gamma_benchmark.yaml").string();
+  FILE* file = fopen(path.c_str(), "w");
+
+  fprintf(file, "meshes: {\n");
+
+  for (u32 i = 0; i < totalMeshes; i++) {
+    fprintf(file, "  mesh_%u: {\n", i);
+    fprintf(file, "    max: %u\n", 100 + i);
+    fprintf(file, "    texture: ./game/textures/mesh_%u.png\n", i);
+    fprintf(file, "    plane: {\n");
+    fprintf(file, "      size: 16\n");
+    fprintf(file, "      useLoopingTexture: true\n");
+    fprintf(file, "    }\n");
+    fprintf(file, "    model: [\n");
+    fprintf(file, "      ./game/models/mesh_%u_lod1.obj,\n", i);
+    fprintf(file, "      ./game/models/mesh_%u_lod2.obj\n", i);
+    fprintf(file, "    ]\n");
+    fprintf(file, "  }\n");
+  }
+
+  fprintf(file, "}\n");
+  fclose(file);
+
+  return path;
+}
+
+static void Gm_AddObjectPoolBenchmarks(std::vector<BenchmarkCase>& benchmarks) {
+  // ObjectPools are too large for the stack
+  static auto* pool = new ObjectPool();
+  static Camera camera;
+
+  pool->reserve(POOL_SIZE);
+
+  benchmarks.push_back({
+    "object_pool/create",
+    POOL_SIZE,
+    []() { pool->reset(); },
+    []() {
+      for (u32 i = 0; i < POOL_SIZE; i++) {
+        pool->createObject();
+      }
+    }
+  });
+
+  benchmarks.push_back({
+    "object_pool/remove",
+    POOL_SIZE / 2,
+    []() { Gm_FillObjectPool(*pool, POOL_SIZE); },
+    []() {
+      // Remove every other object to exercise moves
+      // from the middle of the pool
+      for (u32 i = 0; i < POOL_SIZE; i += 2) {
+        pool->removeById((u16)i);
+      }
+    }
+  });
+
+  benchmarks.push_back({
+    "object_pool/partition_by_distance",
+    POOL_SIZE,
+    []() { Gm_FillObjectPool(*pool, POOL_SIZE); },
+    []() { pool->partitionByDistance(0, 800.f, Vec3f(0.f)); }
+  });
+
+  benchmarks.push_back({
+    "object_pool/partition_by_visibility",
+    POOL_SIZE,
+    []() { Gm_FillObjectPool(*pool, POOL_SIZE); },
+    []() { pool->partitionByVisibility(camera); }
+  });
+
+  benchmarks.push_back({
+    "object_pool/sort_by_depth",
+    POOL_SIZE,
+    []() { Gm_FillObjectPool(*pool, POOL_SIZE); },
+    []() { pool->sortByDepth(0, (u16)pool->totalVisible(), camera, DepthSortOrder::BACK_TO_FRONT); }
+  });
+}
+
+/**
+ * Gm_AddDepthSortBenchmarks
+ * -------------------------
+ *
+ * Sorts index lists rather than ObjectPools, which are
+ * limited to 0xffff objects.
+ */
+static void Gm_AddDepthSortBenchmarks(std::vector<BenchmarkCase>& benchmarks) {
+  static std::vector<Vec3f> positions;
+  static std::vector<float> depths(DEPTH_SORT_SIZE);
+  static std::vector<u32> indices(DEPTH_SORT_SIZE);
+  static Camera camera;
+
+  for (u32 i = 0; i < DEPTH_SORT_SIZE; i++) {
+    positions.push_back(Gm_RandomPosition(1000.f));
+  }
+
+  static auto computeDepths = []() {
+    Vec3f cameraDirection = camera.orientation.getDirection();
+
+    for (u32 i = 0; i < DEPTH_SORT_SIZE; i++) {
+      depths[i] = Vec3f::dot(cameraDirection, positions[indices[i]] - camera.position);
+    }
+  };
+
+  benchmarks.push_back({
+    "depth_sort/indices_100k",
+    DEPTH_SORT_SIZE,
+    []() {
+      for (u32 i = 0; i < DEPTH_SORT_SIZE; i++) {
+        indices[i] = i;
+      }
+
+      std::shuffle(indices.begin(), indices.end(), rng);
+
+      computeDepths();
+    },
+    []() { Gm_SortByDepth(depths.data(), indices.data(), DEPTH_SORT_SIZE, DepthSortOrder::FRONT_TO_BACK); }
+  });
+
+  // Indices sorted on a previous frame, after the camera
+  // has moved slightly
+  benchmarks.push_back({
+    "depth_sort/indices_100k_coherent",
+    DEPTH_SORT_SIZE,
+    []() {
+      camera.position = Vec3f(0.f);
+
+      for (u32 i = 0; i < DEPTH_SORT_SIZE; i++) {
+        indices[i] = i;
+      }
+
+      computeDepths();
+
+      Gm_SortByDepth(depths.data(), indices.data(), DEPTH_SORT_SIZE, DepthSortOrder::FRONT_TO_BACK);
+
+      camera.position = Vec3f(0.5f, 0.f, 0.5f);
+
+      computeDepths();
+    },
+    []() { Gm_SortByDepth(depths.data(), indices.data(), DEPTH_SORT_SIZE, DepthSortOrder::FRONT_TO_BACK); }
+  });
+}
+
+static void Gm_AddSceneBenchmarks(std::vector<BenchmarkCase>& benchmarks) {
+  static auto* context = new GmContext();
+
+  context->renderer = new NullRenderer(context);
+
+  Gm_AddMesh(context, "benchmark_cube", POOL_SIZE, Mesh::Cube());
+
+  for (u32 i = 0; i < POOL_SIZE; i++) {
+    auto& object = Gm_CreateObjectFrom(context, 0);
+
+    object.position = Gm_RandomPosition(1000.f);
+    object.color = Vec3f(1.f, 0.5f, 0.2f);
+  }
+
+  benchmarks.push_back({
+    "scene/commit",
+    POOL_SIZE,
+    nullptr,
+    []() {
+      for (auto& object : context->scene.meshes[0]->objects) {
+        object.position.y += 0.1f;
+        object.rotation = Quaternion::fromAxisAngle(Vec3f(0, 1.f, 0), object.position.y);
+
+        Gm_Commit(context, object);
+      }
+    }
+  });
+
+  for (u32 i = 0; i < 500; i++) {
+    auto& light = Gm_CreateLight(context, LightType::POINT);
+
+    light.position = Gm_RandomPosition(1000.f);
+    light.radius = Gm_RandomInRange(50.f, 300.f);
+  }
+
+  benchmarks.push_back({
+    "scene/null_render",
+    1,
+    []() { context->scene.meshes[0]->objects.changed = true; },
+    []() { context->renderer->render(); }
+  });
+}
+
+static void Gm_AddMathBenchmarks(std::vector<BenchmarkCase>& benchmarks) {
+  static std::vector<Matrix4f> matrices;
+  static std::vector<Quaternion> quaternions;
+  static std::vector<Vec3f> vectors;
+  // Results are written separately from the inputs,
+  // so every repetition operates on the same values
+  static std::vector<Matrix4f> matrixResults(MATRIX_OPERATIONS);
+  static std::vector<Quaternion> quaternionResults(MATRIX_OPERATIONS);
+  static std::vector<Vec3f> vectorResults(MATRIX_OPERATIONS);
+
+  for (u32 i = 0; i < MATRIX_OPERATIONS; i++) {
+    auto rotation = Quaternion::fromAxisAngle(Gm_RandomPosition(1.f).unit(), Gm_RandomInRange(0.f, 3.f));
+
+    matrices.push_back(Matrix4f::transformation(Gm_RandomPosition(100.f), Vec3f(2.f), rotation));
+    quaternions.push_back(rotation);
+    vectors.push_back(Gm_RandomPosition(100.f));
+  }
+
+  benchmarks.push_back({
+    "math/matrix_multiply",
+    MATRIX_OPERATIONS - 1,
+    nullptr,
+    []() {
+      for (u32 i = 0; i < MATRIX_OPERATIONS - 1; i++) {
+        matrixResults[i] = matrices[i] * matrices[i + 1];
+      }
+    }
+  });
+
+  benchmarks.push_back({
+    "math/matrix_transformation",
+    MATRIX_OPERATIONS,
+    nullptr,
+    []() {
+      for (u32 i = 0; i < MATRIX_OPERATIONS; i++) {
+        matrixResults[i] = Matrix4f::transformation(vectors[i], Vec3f(2.f), quaternions[i]).transpose();
+      }
+    }
+  });
+
+  benchmarks.push_back({
+    "math/matrix_inverse",
+    MATRIX_OPERATIONS,
+    nullptr,
+    []() {
+      for (u32 i = 0; i < MATRIX_OPERATIONS; i++) {
+        matrixResults[i] = matrices[i].inverse();
+      }
+    }
+  });
+
+  benchmarks.push_back({
+    "math/matrix_transform_vec3f",
+    MATRIX_OPERATIONS,
+    nullptr,
+    []() {
+      for (u32 i = 0; i < MATRIX_OPERATIONS; i++) {
+        vectorResults[i] = matrices[i].transformVec3f(vectors[i]);
+      }
+    }
+  });
+
+  benchmarks.push_back({
+    "math/quaternion_multiply",
+    MATRIX_OPERATIONS - 1,
+    nullptr,
+    []() {
+      for (u32 i = 0; i < MATRIX_OPERATIONS - 1; i++) {
+        quaternionResults[i] = quaternions[i] * quaternions[i + 1];
+      }
+    }
+  });
+
+  benchmarks.push_back({
+    "math/quaternion_slerp",
+    MATRIX_OPERATIONS - 1,
+    nullptr,
+    []() {
+      for (u32 i = 0; i < MATRIX_OPERATIONS - 1; i++) {
+        quaternionResults[i] = Quaternion::slerp(quaternions[i], quaternions[i + 1], 0.5f);
+      }
+    }
+  });
+
+  benchmarks.push_back({
+    "math/quaternion_to_matrix",
+    MATRIX_OPERATIONS,
+    nullptr,
+    []() {
+      for (u32 i = 0; i < MATRIX_OPERATIONS; i++) {
+        matrixResults[i] = quaternions[i].toMatrix4f();
+      }
+    }
+  });
+}
+
+static void Gm_AddLoaderBenchmarks(std::vector<BenchmarkCase>& benchmarks) {
+  static std::string objPath = Gm_WriteObjFile(OBJ_GRID_SIZE);
+  static std::string yamlPath = Gm_WriteYamlFile(YAML_MESHES);
+
+  benchmarks.push_back({
+    "loaders/obj_faces",
+    OBJ_GRID_SIZE * OBJ_GRID_SIZE * 2,
+    nullptr,
+    []() {
+      ObjLoader obj(objPath.c_str());
+    }
+  });
+
+  benchmarks.push_back({
+    "loaders/yaml_meshes",
+    YAML_MESHES,
+    nullptr,
+    []() {
+      auto& yaml = Gm_ParseYamlFile(yamlPath.c_str());
+
+      Gm_FreeYamlObject(&yaml);
+    }
+  });
+}
+
+/**
+ * Gm_DeleteMesh
+ * -------------
+ *
+ * Gm_FreeMesh() leaves the Mesh itself and its vector
+ * capacity allocated, which adds up quickly when meshes
+ * are generated over many repetitions.
+ */
+static void Gm_DeleteMesh(Mesh* mesh) {
+  Gm_FreeMesh(mesh);
+
+  delete mesh;
+}
+
+/**
+ * Gm_AddGeometryBenchmarks
+ * ------------------------
+ *
+ * Covers procedural mesh generation and normal/tangent
+ * computation at several sizes, up to terrain-sized planes.
+ * Large meshes are only created once their benchmarks run.
+ *
+ * benchmarks/baselines/geometry_serial.json holds results
+ * from the serial generators and normal/tangent sums these
+ * replaced, for use with --compare.
+ */
+static void Gm_AddGeometryBenchmarks(std::vector<BenchmarkCase>& benchmarks) {
+  static Mesh* sphere = Mesh::Sphere(60);
+
+  benchmarks.push_back({
+    "geometry/compute_normals",
+    sphere->faceElements.size() / 3,
+    nullptr,
+    []() { Gm_ComputeNormals(sphere); }
+  });
+
+  benchmarks.push_back({
+    "geometry/compute_tangents",
+    sphere->faceElements.size() / 3,
+    nullptr,
+    []() { Gm_ComputeTangents(sphere); }
+  });
+
+  for (u32 size : { 256, 1024, 2048 }) {
+    u64 totalTriangles = (u64)(size - 1) * (size - 1) * 4;
+
+    benchmarks.push_back({
+      "geometry/plane_" + std::to_string(size),
+      (u64)size * size,
+      nullptr,
+      [size]() { Gm_DeleteMesh(Mesh::Plane(size)); }
+    });
+
+    // Planes are shared between their normal/tangent benchmarks,
+    // keeping only one alive at a time since the largest take
+    // several hundred MB
+    static std::map<u32, Mesh*> planes;
+
+    auto createPlane = [size]() {
+      if (planes[size] != nullptr) {
+        return;
+      }
+
+      for (auto& [planeSize, plane] : planes) {
+        if (plane != nullptr) {
+          Gm_DeleteMesh(plane);
+
+          plane = nullptr;
+        }
+      }
+
+      planes[size] = Mesh::Plane(size);
+    };
+
+    benchmarks.push_back({
+      "geometry/compute_normals_plane_" + std::to_string(size),
+      totalTriangles,
+      createPlane,
+      [size]() { Gm_ComputeNormals(planes[size]); }
+    });
+
+    benchmarks.push_back({
+      "geometry/compute_tangents_plane_" + std::to_string(size),
+      totalTriangles,
+      createPlane,
+      [size]() { Gm_ComputeTangents(planes[size]); }
+    });
+  }
+
+  for (u32 divisions : { 30, 60, 120 }) {
+    benchmarks.push_back({
+      "geometry/sphere_" + std::to_string(divisions),
+      1,
+      nullptr,
+      [divisions]() { Gm_DeleteMesh(Mesh::Sphere((u8)divisions)); }
+    });
+  }
+
+  for (u32 slices : { 256, 4096 }) {
+    benchmarks.push_back({
+      "geometry/disc_" + std::to_string(slices),
+      slices,
+      nullptr,
+      [slices]() { Gm_DeleteMesh(Mesh::Disc(slices)); }
+    });
+
+    benchmarks.push_back({
+      "geometry/cylinder_" + std::to_string(slices),
+      slices,
+      nullptr,
+      [slices]() { Gm_DeleteMesh(Mesh::Cylinder(slices)); }
+    });
+  }
+}
+
+static void Gm_AddLightDiscBenchmarks(std::vector<BenchmarkCase>& benchmarks) {
+  static std::vector<Light> lights;
+  static std::vector<Disc> discs;
+  static Camera camera;
+  static Area<u32> resolution = { 1920, 1080 };
+
+  for (u32 i = 0; i < TOTAL_LIGHTS; i++) {
+    Light light;
+
+    light.position = Gm_RandomPosition(1000.f);
+    light.radius = Gm_RandomInRange(50.f, 500.f);
+
+    lights.push_back(light);
+  }
+
+  discs.resize(TOTAL_LIGHTS);
+
+  benchmarks.push_back({
+    "lights/configure_discs",
+    TOTAL_LIGHTS,
+    nullptr,
+    []() {
+      auto matProjection = Matrix4f::glPerspective(resolution, camera.fov, 1.f, 10000.f);
+      auto matView = Gm_GetCameraViewMatrix(camera);
+      float aspectRatio = (float)resolution.width / (float)resolution.height;
+
+      for (u32 i = 0; i < TOTAL_LIGHTS; i++) {
+        Gm_ConfigureLightDisc(discs[i], lights[i], matProjection, matView, aspectRatio);
+      }
+    }
+  });
+}
+
+static void Gm_AddLightClusterBenchmarks(std::vector<BenchmarkCase>& benchmarks) {
+  static std::vector<Light> lights;
+  static std::vector<Light*> lights1k;
+  static std::vector<Light*> lights10k;
+  static LightClusters lightClusters;
+  static Camera camera;
+  static Area<u32> resolution = { 1920, 1080 };
+
+  lights.resize(TOTAL_LIGHTS);
+
+  for (u32 i = 0; i < TOTAL_LIGHTS; i++) {
+    auto& light = lights[i];
+
+    light.position = Vec3f(Gm_RandomInRange(-2000.f, 2000.f), Gm_RandomInRange(-500.f, 500.f), Gm_RandomInRange(0.f, 5000.f));
+    light.radius = Gm_RandomInRange(50.f, 500.f);
+
+    if (i < 1000) {
+      lights1k.push_back(&light);
+    }
+
+    lights10k.push_back(&light);
+  }
+
+  benchmarks.push_back({
+    "lights/clusters_1k",
+    lights1k.size(),
+    nullptr,
+    []() { Gm_BuildLightClusters(lightClusters, lights1k, camera, resolution); }
+  });
+
+  benchmarks.push_back({
+    "lights/clusters_10k",
+    lights10k.size(),
+    nullptr,
+    []() { Gm_BuildLightClusters(lightClusters, lights10k, camera, resolution); }
+  });
+}
+
+static void Gm_AddBroadphaseBenchmarks(std::vector<BenchmarkCase>& benchmarks) {
+  static CollisionLayer bullets;
+  static CollisionLayer targets;
+  static CollisionGrid grid;
+  static std::vector<CollisionPair> pairs;
+
+  // Bullets and targets spread over a 4000x4000 arena,
+  // with the grid built over bullets as in fleet
+  for (u32 i = 0; i < TOTAL_BULLETS; i++) {
+    Gm_AddCollider(bullets, i, Gm_RandomInRange(-2000.f, 2000.f), Gm_RandomInRange(-2000.f, 2000.f), Gm_RandomInRange(2.f, 6.f));
+  }
+
+  for (u32 i = 0; i < TOTAL_TARGETS; i++) {
+    Gm_AddCollider(targets, i, Gm_RandomInRange(-2000.f, 2000.f), Gm_RandomInRange(-2000.f, 2000.f), Gm_RandomInRange(20.f, 60.f));
+  }
+
+  benchmarks.push_back({
+    "physics/broadphase_10k_500",
+    TOTAL_BULLETS,
+    nullptr,
+    []() {
+      Gm_BuildCollisionGrid(grid, bullets);
+      Gm_FindCollisionPairs(grid, targets, CollisionShape::AABB, pairs);
+    }
+  });
+}
+
+static void Gm_PrintUsage() {
+  printf(
+    "Usage: gamma_benchmarks [options]\n"
+    "  --filter <text>        Only run benchmarks whose names contain <text>\n"
+    "  --warmup <count>       Unmeasured repetitions per benchmark (default 3)\n"
+    "  --repetitions <count>  Measured repetitions per benchmark (default 15)\n"
+    "  --quick                Run each benchmark once, e.g. as a smoke test\n"
+    "  --list                 List benchmark names without running them\n"
+    "  --output <path>        Where to write JSON results (default benchmark_results.json)\n"
+    "  --compare <path>       Compare results against a saved baseline\n"
+    "  --threshold <percent>  Slowdown flagged as a regression (default 10)\n"
+  );
+}
+
+static bool Gm_ParseOptions(int argc, char* argv[], BenchmarkOptions& options) {
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+    if (strcmp(arg, "--quick") == 0) {
+      options.warmup = 0;
+      options.repetitions = 1;
+
+      continue;
+    }
+
+    if (strcmp(arg, "--list") == 0) {
+      options.list = true;
+
+      continue;
+    }
+
+    if (value == nullptr) {
+      return false;
+    }
+
+    if (strcmp(arg, "--filter") == 0) {
+      options.filter = value;
+    } else if (strcmp(arg, "--warmup") == 0) {
+      options.warmup = (u32)atoi(value);
+    } else if (strcmp(arg, "--repetitions") == 0) {
+      options.repetitions = (u32)atoi(value);
+    } else if (strcmp(arg, "--output") == 0) {
+      options.outputPath = value;
+    } else if (strcmp(arg, "--compare") == 0) {
+      options.baselinePath = value;
+    } else if (strcmp(arg, "--threshold") == 0) {
+      options.threshold = (float)atof(value) / 100.f;
+    } else {
+      return false;
+    }
+
+    i++;
+  }
+
+  return true;
+}
+
+int main(int argc, char* argv[]) {
+  BenchmarkOptions options;
+  std::vector<BenchmarkCase> benchmarks;
+  std::vector<BenchmarkResult> results;
+
+  if (!Gm_ParseOptions(argc, argv, options)) {
+    Gm_PrintUsage();
+
+    return 1;
+  }
+
+  Gm_AddObjectPoolBenchmarks(benchmarks);
+  Gm_AddDepthSortBenchmarks(benchmarks);
+  Gm_AddSceneBenchmarks(benchmarks);
+  Gm_AddMathBenchmarks(benchmarks);
+  Gm_AddLoaderBenchmarks(benchmarks);
+  Gm_AddGeometryBenchmarks(benchmarks);
+  Gm_AddLightDiscBenchmarks(benchmarks);
+  Gm_AddLightClusterBenchmarks(benchmarks);
+  Gm_AddBroadphaseBenchmarks(benchmarks);
+
+  auto isFiltered = [&](const BenchmarkCase& benchmark) {
+    return options.filter != nullptr && benchmark.name.find(options.filter) == std::string::npos;
+  };
+
+  // Fail on filters which match nothing, so typos (or missing
+  // benchmarks) aren't mistaken for passing runs
+  bool hasMatches = std::any_of(benchmarks.begin(), benchmarks.end(), [&](const BenchmarkCase& benchmark) {
+    return !isFiltered(benchmark);
+  });
+
+  if (!hasMatches) {
+    printf("No benchmarks match '%s'\n", options.filter);
+
+    return 1;
+  }
+
+  if (options.list) {
+    for (auto& benchmark : benchmarks) {
+      if (!isFiltered(benchmark)) {
+        printf("%s\n", benchmark.name.c_str());
+      }
+    }
+
+    return 0;
+  }
+
+  printf("%-40s %14s %14s %12s\n", "Benchmark", "median (us)", "p95 (us)", "ns/op");
+
+  for (auto& benchmark : benchmarks) {
+    if (isFiltered(benchmark)) {
+      continue;
+    }
+
+    auto result = Gm_MeasureBenchmark(benchmark, options.warmup, options.repetitions);
+
+    printf(
+      "%-40s %14.1f %14.1f %12.2f\n",
+      result.name.c_str(),
+      result.medianNanoseconds / 1000.0,
+      result.p95Nanoseconds / 1000.0,
+      result.nanosecondsPerOperation
+    );
+
+    results.push_back(result);
+  }
+
+  if (!Gm_WriteBenchmarkResults(options.outputPath, results)) {
+    printf("Failed to write results to %s\n", options.outputPath);
+
+    return 1;
+  }
+
+  printf("\nWrote %zu results to %s\n", results.size(), options.outputPath);
+
+  if (options.baselinePath != nullptr) {
+    auto baseline = Gm_ReadBenchmarkResults(options.baselinePath);
+
+    if (baseline.size() == 0) {
+      printf("Failed to read baseline results from %s\n", options.baselinePath);
+
+      return 1;
+    }
+
+    printf("\nComparing against %s (threshold %.0f%%):\n", options.baselinePath, options.threshold * 100.f);
+
+    u32 totalRegressions = Gm_CompareBenchmarkResults(baseline, results, options.threshold);
+
+    if (totalRegressions > 0) {
+      printf("\n%u benchmark(s) regressed\n", totalRegressions);
+
+      return 1;
+    }
+  }
+
+  return 0;
+}
\ No newline at end of file
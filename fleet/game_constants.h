@@ -3,8 +3,11 @@
 typedef unsigned short u16;
 
 constexpr static float MAX_DT = 1.f / 30.f;
+constexpr static float HEADLESS_DT = 1.f / 60.f;
 constexpr static float LEVEL_1_ALTITUDE = 5000.f;
 constexpr static float PLAYER_ACCELERATION_RATE = 5000.f;
 constexpr static float MAX_VELOCITY = 500.f;
 constexpr static u16 TOTAL_PLAYER_BULLETS = 100;
-constexpr static u16 TOTAL_ENEMY_BULLETS = 500;
\ No newline at end of file
+constexpr static u16 TOTAL_ENEMY_BULLETS = 500;
+constexpr static float PLAYER_BULLET_LIFETIME = 0.75f;
+constexpr static float ENEMY_BULLET_LIFETIME = 4.f;
\ No newline at end of file
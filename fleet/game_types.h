@@ -9,13 +9,6 @@ struct Bounds {
   Vec3f bottom;
 };
 
-struct Bullet {
-  Vec3f velocity = Vec3f(0.f);
-  Vec3f position = Vec3f(0.f);
-  Vec3f color = Vec3f(0.f);
-  float scale = 0.f;
-};
-
 struct Enemy {
   u16 index = 0;
   Vec3f velocity = Vec3f(0.f);
@@ -49,11 +42,18 @@ struct GameState {
   float levelStartTime = 0.f;
 
   u8 bulletTier = 2;
-  std::vector<Bullet> playerBullets;
-  std::vector<Bullet> enemyBullets;
+  Projectiles playerBullets;
+  Projectiles enemyBullets;
   float lastPlayerBulletFireTime = 0.f;
-  u16 nextPlayerBulletIndex = 0;
-  u16 nextEnemyBulletIndex = 0;
+  u32 totalPlayerHits = 0;
+
+  CollisionLayer playerBulletColliders;
+  CollisionLayer enemyBulletColliders;
+  CollisionLayer enemyColliders;
+  CollisionLayer playerColliders;
+  CollisionGrid playerBulletGrid;
+  CollisionGrid enemyBulletGrid;
+  std::vector<CollisionPair> collisionPairs;
 
   std::vector<EnemySpawn> remainingEnemySpawns;
 
@@ -1,3 +1,9 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
 #include <vector>
 
 #include "Gamma.h"
@@ -41,60 +47,29 @@ internal bool isScrolledOutOfBounds(const GameState& state, const Vec3f& positio
   return position.z < (state.gameFieldCenter.z + state.bounds.bottom.z);
 }
 
-internal bool isBulletColliding(const Bullet& bullet, const Vec3f& target, float padding) {
-  if (bullet.scale == 0.f) {
-    return false;
-  }
-
-  if (
-    (bullet.position.x + bullet.scale < target.x - padding) ||
-    (bullet.position.x - bullet.scale > target.x + padding) ||
-    (bullet.position.z + bullet.scale < target.z - padding) ||
-    (bullet.position.z - bullet.scale > target.z + padding)
-  ) {
-    return false;
-  }
-
-  return true;
-}
+internal void spawnPlayerBullet(GmContext* context, GameState& state, Projectile bullet) {
+  bullet.lifetime = PLAYER_BULLET_LIFETIME;
 
-internal void spawnPlayerBullet(GmContext* context, GameState& state, const Bullet& bullet) {
-  state.playerBullets[state.nextPlayerBulletIndex] = bullet;
-
-  if (++state.nextPlayerBulletIndex >= TOTAL_PLAYER_BULLETS) {
-    state.nextPlayerBulletIndex = 0;
-  }
+  Gm_SpawnProjectile(state.playerBullets, bullet);
 }
 
-internal void spawnEnemyBullet(GmContext* context, GameState& state, const Bullet& bullet) {
-  state.enemyBullets[state.nextEnemyBulletIndex] = bullet;
+internal void spawnEnemyBullet(GmContext* context, GameState& state, Projectile bullet) {
+  bullet.lifetime = ENEMY_BULLET_LIFETIME;
 
-  if (++state.nextEnemyBulletIndex >= TOTAL_ENEMY_BULLETS) {
-    state.nextEnemyBulletIndex = 0;
-  }
+  Gm_SpawnProjectile(state.enemyBullets, bullet);
 }
 
-internal Object& requestEnemyObject(GmContext* context, const std::string& objectName, u32 totalActiveEntities) {
-  auto& existingObjects = objects(objectName);
-
-  if (existingObjects.totalActive() > totalActiveEntities) {
-    // When there are more active objects than active entities,
-    // reuse an existing object. Pick the first one with a scale
-    // of 0, used to mark objects as eligible for reuse.
-    for (auto& object : existingObjects) {
-      if (object.scale.x == 0.f) {
-        return object;
-      }
-    }
-  }
+internal Object& requestEnemyObject(GmContext* context, const std::string& meshName) {
+  // Reuse the objects of destroyed enemies where possible
+  auto* object = objects(meshName).acquireInactiveObject();
 
-  return create_object_from(objectName);
+  return object != nullptr ? *object : create_object_from(meshName);
 }
 
 internal void spawnEnemy(GmContext* context, GameState& state, EnemyType type, const Vec3f offset) {
   switch (type) {
     case SPIRAL_SHIP:
-      auto& ship = requestEnemyObject(context, "spiral-ship", state.spiralShips.size());
+      auto& ship = requestEnemyObject(context, "spiral-ship");
 
       ship.position = state.gameFieldCenter + offset;
       ship.scale = Vec3f(20.f);
@@ -110,33 +85,93 @@ internal void spawnEnemy(GmContext* context, GameState& state, EnemyType type, c
   }
 }
 
+internal void handlePlayerBulletCollisions(GmContext* context, GameState& state) {
+  auto& spiralShipObjects = objects("spiral-ship");
+  auto& bulletColliders = state.playerBulletColliders;
+  auto& enemyColliders = state.enemyColliders;
+  auto& pairs = state.collisionPairs;
+
+  Gm_ClearCollisionLayer(bulletColliders);
+  Gm_ClearCollisionLayer(enemyColliders);
+
+  auto& bullets = state.playerBullets;
+
+  for (u32 i = 0; i < bullets.total; i++) {
+    Gm_AddCollider(bulletColliders, i, bullets.x[i], bullets.z[i], bullets.scale[i]);
+  }
+
+  for (u32 i = 0; i < state.spiralShips.size(); i++) {
+    auto& object = *spiralShipObjects.getById(state.spiralShips[i].index);
+
+    Gm_AddCollider(enemyColliders, i, object.position.x, object.position.z, object.scale.x);
+  }
+
+  Gm_BuildCollisionGrid(state.playerBulletGrid, bulletColliders);
+  Gm_FindCollisionPairs(state.playerBulletGrid, enemyColliders, CollisionShape::AABB, pairs);
+
+  for (auto& pair : pairs) {
+    // Bullets are spent on the first ship they hit
+    if (bullets.lifetime[pair.a] > 0.f) {
+      state.spiralShips[pair.b].health -= 10.f;
+
+      Gm_KillProjectile(bullets, pair.a);
+    }
+  }
+}
+
+internal void handleEnemyBulletCollisions(GmContext* context, GameState& state) {
+  auto& player = get_player();
+  auto& bulletColliders = state.enemyBulletColliders;
+  auto& playerColliders = state.playerColliders;
+  auto& pairs = state.collisionPairs;
+
+  Gm_ClearCollisionLayer(bulletColliders);
+  Gm_ClearCollisionLayer(playerColliders);
+
+  auto& bullets = state.enemyBullets;
+
+  for (u32 i = 0; i < bullets.total; i++) {
+    Gm_AddCollider(bulletColliders, i, bullets.x[i], bullets.z[i], bullets.scale[i]);
+  }
+
+  Gm_AddCollider(playerColliders, 0, player.position.x, player.position.z, player.scale.x);
+
+  Gm_BuildCollisionGrid(state.enemyBulletGrid, bulletColliders);
+  Gm_FindCollisionPairs(state.enemyBulletGrid, playerColliders, CollisionShape::AABB, pairs);
+
+  for (auto& pair : pairs) {
+    Gm_KillProjectile(bullets, pair.a);
+
+    state.totalPlayerHits++;
+  }
+}
+
 internal void updateSpiralShips(GmContext* context, GameState& state, float dt) {
+  GM_PROFILE_SCOPE("updateSpiralShips");
+
   const float scrollDistance = 2000.f * dt;
   auto& spiralShipObjects = objects("spiral-ship");
   float t = get_scene_time();
   u32 index = 0;
 
-  while (index < state.spiralShips.size()) {
-    auto& entity = state.spiralShips[index];
-    auto& object = spiralShipObjects[entity.index];
+  for (auto& entity : state.spiralShips) {
+    auto& object = *spiralShipObjects.getById(entity.index);
 
     object.position += entity.velocity * dt;
     object.position.z += scrollDistance;
+  }
 
-    for (auto& bullet : state.playerBullets) {
-      if (isBulletColliding(bullet, object.position, object.scale.x)) {
-        entity.health -= 10.f;
-        bullet.scale = 0.f;
-      }
-    }
+  handlePlayerBulletCollisions(context, state);
 
-    if (isScrolledOutOfBounds(state, object.position) || entity.health <= 0.f) {
-      Gm_VectorRemove(state.spiralShips, entity);
+  while (index < state.spiralShips.size()) {
+    auto& entity = state.spiralShips[index];
+    auto& object = *spiralShipObjects.getById(entity.index);
 
-      // @todo hide/animate out destroyed ships
-      object.scale = Vec3f(0.f);
+    if (isScrolledOutOfBounds(state, object.position) || entity.health <= 0.f) {
+      // @todo animate out destroyed ships
+      spiralShipObjects.deactivateById(entity.index);
 
-      commit(object);
+      Gm_VectorRemove(state.spiralShips, entity);
 
       continue;
     }
@@ -218,20 +253,16 @@ internal void initializeMeshes(GmContext* context, GameState& state) {
   // mesh("bullet")->emissivity = 0.5f;
   // mesh("enemy-bullet")->emissivity = 0.5f;
 
+  // Bullet instances are written directly by the projectile
+  // system, which controls how many of them are visible
   for (u16 i = 0; i < TOTAL_PLAYER_BULLETS; i++) {
-    auto& bullet = create_object_from("bullet");
-    auto& glow = create_object_from("bullet-glow");
-
-    bullet.scale = Vec3f(0.f);
-    glow.scale = Vec3f(0.f);
+    create_object_from("bullet");
+    create_object_from("bullet-glow");
   }
 
   for (u16 i = 0; i < TOTAL_ENEMY_BULLETS; i++) {
-    auto& bullet = create_object_from("enemy-bullet");
-    auto& glow = create_object_from("enemy-bullet-glow");
-
-    bullet.scale = Vec3f(0.f);
-    glow.scale = Vec3f(0.);
+    create_object_from("enemy-bullet");
+    create_object_from("enemy-bullet-glow");
   }
 
   auto& ocean = create_object_from("ocean");
@@ -256,8 +287,8 @@ internal void initializeMeshes(GmContext* context, GameState& state) {
 internal void initializeEntities(GmContext* context, GameState& state) {
   add_mesh("spiral-ship", 10, Mesh::Cube());
 
-  state.playerBullets.resize(TOTAL_PLAYER_BULLETS);
-  state.enemyBullets.resize(TOTAL_ENEMY_BULLETS);
+  Gm_ReserveProjectiles(state.playerBullets, TOTAL_PLAYER_BULLETS);
+  Gm_ReserveProjectiles(state.enemyBullets, TOTAL_ENEMY_BULLETS);
 }
 
 internal void initializeGame(GmContext* context, GameState& state) {
@@ -278,6 +309,8 @@ internal void initializeGame(GmContext* context, GameState& state) {
 }
 
 internal void updateScrollOffset(GmContext* context, GameState& state, float dt) {
+  GM_PROFILE_SCOPE("updateScrollOffset");
+
   auto& camera = get_camera();
   const float scrollDistance = 2000.f * dt;
 
@@ -287,6 +320,8 @@ internal void updateScrollOffset(GmContext* context, GameState& state, float dt)
 }
 
 internal void handleInput(GmContext* context, GameState& state, float dt) {
+  GM_PROFILE_SCOPE("handleInput");
+
   auto& input = get_input();
   Vec3f acceleration;
 
@@ -355,6 +390,8 @@ internal void handleInput(GmContext* context, GameState& state, float dt) {
 }
 
 internal void updatePlayerShips(GmContext* context, GameState& state, float dt) {
+  GM_PROFILE_SCOPE("updatePlayerShips");
+
   auto& camera = get_camera();
   auto& player = get_player();
   float roll = -0.25f * (state.velocity.x / MAX_VELOCITY);
@@ -367,10 +404,14 @@ internal void updatePlayerShips(GmContext* context, GameState& state, float dt)
 }
 
 internal void updateEnemyShips(GmContext* context, GameState& state, float dt) {
+  GM_PROFILE_SCOPE("updateEnemyShips");
+
   updateSpiralShips(context, state, dt);
 }
 
 internal void handleNewEnemySpawns(GmContext* context, GameState& state, float dt) {
+  GM_PROFILE_SCOPE("handleNewEnemySpawns");
+
   float runningTime = time_since(state.levelStartTime);
 
   while (1) {
@@ -391,6 +432,8 @@ internal void handleNewEnemySpawns(GmContext* context, GameState& state, float d
 }
 
 internal void updatePlayerBullets(GmContext* context, GameState& state, float dt) {
+  GM_PROFILE_SCOPE("updatePlayerBullets");
+
   auto& input = get_input();
   const float scrollDistance = 2000.f * dt;
 
@@ -447,58 +490,24 @@ internal void updatePlayerBullets(GmContext* context, GameState& state, float dt
     state.lastPlayerBulletFireTime = get_scene_time();
   }
 
-  // Update bullet/glow position
-  auto& bullets = objects("bullet");
-  auto& glows = objects("bullet-glow");
-
-  for (u16 i = 0; i < TOTAL_PLAYER_BULLETS; i++) {
-    auto& playerBullet = state.playerBullets[i];
-    auto& bullet = bullets[i];
-    auto& glow = glows[i];
-
-    playerBullet.position += playerBullet.velocity * dt;
-    playerBullet.position.z += scrollDistance;
-
-    bullet.position = glow.position = playerBullet.position;
-    bullet.color = playerBullet.color;
-    bullet.scale = Vec3f(playerBullet.scale);
-
-    glow.position = bullet.position;
-    glow.color = Vec3f(playerBullet.color);
-    glow.scale = Vec3f(playerBullet.scale * 2.f);
-
-    commit(bullet);
-    commit(glow);
-  }
+  Gm_UpdateProjectiles(state.playerBullets, dt, Vec3f(0, 0, scrollDistance));
+  Gm_WriteProjectileInstances(state.playerBullets, objects("bullet"), objects("bullet-glow"), 2.f);
 }
 
 internal void updateEnemyBullets(GmContext* context, GameState& state, float dt) {
-  auto& bullets = objects("enemy-bullet");
-  auto& glows = objects("enemy-bullet-glow");
-  const float scrollDistance = 2000.f * dt;
-
-  for (u16 i = 0; i < TOTAL_ENEMY_BULLETS; i++) {
-    auto& enemyBullet = state.enemyBullets[i];
-    auto& bullet = bullets[i];
-    auto& glow = glows[i];
+  GM_PROFILE_SCOPE("updateEnemyBullets");
 
-    enemyBullet.position += enemyBullet.velocity * dt;
-    enemyBullet.position.z += scrollDistance;
-
-    bullet.position = glow.position = enemyBullet.position;
-    bullet.color = enemyBullet.color;
-    bullet.scale = Vec3f(enemyBullet.scale);
+  const float scrollDistance = 2000.f * dt;
 
-    glow.position = bullet.position;
-    glow.color = Vec3f(enemyBullet.color);
-    glow.scale = Vec3f(enemyBullet.scale * 2.f);
+  handleEnemyBulletCollisions(context, state);
 
-    commit(bullet);
-    commit(glow);
-  }
+  Gm_UpdateProjectiles(state.enemyBullets, dt, Vec3f(0, 0, scrollDistance));
+  Gm_WriteProjectileInstances(state.enemyBullets, objects("enemy-bullet"), objects("enemy-bullet-glow"), 2.f);
 }
 
 internal void updateLights(GmContext* context, GameState& state, float dt) {
+  GM_PROFILE_SCOPE("updateLights");
+
   auto& player = get_player();
   auto& flash = get_light("muzzle-flash");
 
@@ -510,6 +519,8 @@ internal void updateLights(GmContext* context, GameState& state, float dt) {
 }
 
 internal void updateOcean(GmContext* context, GameState& state, float dt) {
+  GM_PROFILE_SCOPE("updateOcean");
+
   auto& camera = get_camera();
   auto& ocean = objects("ocean")[0];
   auto& floor = objects("ocean-floor")[0];
@@ -523,6 +534,8 @@ internal void updateOcean(GmContext* context, GameState& state, float dt) {
 }
 
 internal void updateGame(GmContext* context, GameState& state, float dt) {
+  GM_PROFILE_SCOPE("updateGame");
+
   auto& camera = get_camera();
   auto& input = get_input();
   const float scrollDistance = 2000.f * dt;
@@ -544,17 +557,138 @@ internal void updateGame(GmContext* context, GameState& state, float dt) {
     add_debug_message("Camera: " + Gm_ToString(camera.position));
     add_debug_message("Velocity: " + Gm_ToString(state.velocity));
     add_debug_message("Position: " + Gm_ToString(state.offset));
+    add_debug_message("Hits: " + std::to_string(state.totalPlayerHits));
   #endif
 }
 
+/**
+ * RunOptions
+ * ----------
+ *
+ * Command-line options for automated runs:
+ *
+ *  --headless     Run without a window, using the NullRenderer
+ *  --offscreen    Render with OpenGL to an offscreen surface
+ *  --frames <N>   Exit after N frames, printing frame times
+ *                 (and GPU render pass times, if available)
+ *  --record <f>   Record per-frame input and timing to a file
+ *  --replay <f>   Replay recorded input and timing, exiting
+ *                 after the last recorded frame
+ *  --hitch-budget <ms>
+ *                 Dump recent frame timings when a frame is
+ *                 slower than this (0 to disable)
+ */
+struct RunOptions {
+  bool headless = false;
+  bool offscreen = false;
+  u32 frames = 0;
+  const char* recordPath = nullptr;
+  const char* replayPath = nullptr;
+  float hitchBudget = -1.f;
+};
+
+/**
+ * PassTimeTotal
+ * -------------
+ *
+ * Accumulated GPU time for a render pass over a run.
+ */
+struct PassTimeTotal {
+  u64 gpuNanoseconds = 0;
+  u32 samples = 0;
+};
+
+static RunOptions parseRunOptions(int argc, char* argv[]) {
+  RunOptions options;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--headless") == 0) {
+      options.headless = true;
+    } else if (strcmp(argv[i], "--offscreen") == 0) {
+      options.offscreen = true;
+    } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+      options.frames = (u32)atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+      options.recordPath = argv[++i];
+    } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+      options.replayPath = argv[++i];
+    } else if (strcmp(argv[i], "--hitch-budget") == 0 && i + 1 < argc) {
+      options.hitchBudget = (float)atof(argv[++i]);
+    }
+  }
+
+  return options;
+}
+
+static void printFrameTimes(u32 frames, u64 totalMicroseconds, u64 maxFrameMicroseconds, const FrameTimeSummary& summary) {
+  float averageMilliseconds = (float)totalMicroseconds / (float)frames / 1000.f;
+
+  printf("Frames: %u\n", frames);
+  printf("Total: %.1fms\n", (float)totalMicroseconds / 1000.f);
+  printf("Average frame: %.3fms (%.0f fps)\n", averageMilliseconds, 1000.f / averageMilliseconds);
+  printf("Max frame: %.3fms\n", (float)maxFrameMicroseconds / 1000.f);
+  printf("Frame p50: %.3fms\n", summary.p50 / 1000.f);
+  printf("Frame p90: %.3fms\n", summary.p90 / 1000.f);
+  printf("Frame p99: %.3fms\n", summary.p99 / 1000.f);
+  printf("Frame p99.9: %.3fms\n", summary.p999 / 1000.f);
+}
+
+static void accumulatePassTimes(std::map<std::string, PassTimeTotal>& totals, const std::vector<RenderPassTime>& passTimes) {
+  for (auto& passTime : passTimes) {
+    auto& total = totals[passTime.name];
+
+    total.gpuNanoseconds += passTime.gpuNanoseconds;
+    total.samples++;
+  }
+}
+
+static void printPassTimes(const std::map<std::string, PassTimeTotal>& totals) {
+  for (auto& [ name, total ] : totals) {
+    printf("GPU %s: %.3fms\n", name.c_str(), (float)total.gpuNanoseconds / (float)total.samples / 1000000.f);
+  }
+}
+
 int main(int argc, char* argv[]) {
   using namespace Gamma;
 
+  auto options = parseRunOptions(argc, argv);
   auto* context = Gm_CreateContext();
   GameState state;
 
-  Gm_OpenWindow(context, "Fleet", { 1200, 675 });
-  Gm_SetRenderMode(context, GmRenderMode::OPENGL);
+  if (options.headless) {
+    Gm_SetRenderMode(context, GmRenderMode::HEADLESS);
+  } else if (options.offscreen) {
+    Gm_OpenOffscreenWindow(context, { 1200, 675 });
+    Gm_SetRenderMode(context, GmRenderMode::OPENGL);
+  } else {
+    Gm_OpenWindow(context, "Fleet", { 1200, 675 });
+    Gm_SetRenderMode(context, GmRenderMode::OPENGL);
+  }
+
+  // Headless and offscreen runs are uncapped, so advance the
+  // game at a fixed rate to keep simulated time independent
+  // of speed
+  if (options.headless || options.offscreen) {
+    context->fixedDeltaTime = HEADLESS_DT;
+  }
+
+  if (options.hitchBudget >= 0.f) {
+    context->frameStats.setHitchBudget(u64(options.hitchBudget * 1000.f));
+  }
+
+  // Summarize recent frames in dev tools, and whole runs
+  // for --frames
+  context->frameStats.setWindows({ 600, 0 });
+
+  if (options.replayPath != nullptr) {
+    if (!Gm_ReplayInput(context, options.replayPath)) {
+      Gm_DestroyContext(context);
+
+      return 1;
+    }
+  } else if (options.recordPath != nullptr) {
+    Gm_RecordInput(context, options.recordPath);
+  }
 
   initializeGame(context, state);
 
@@ -585,7 +719,13 @@ int main(int argc, char* argv[]) {
     }
   });
 
-  while (!context->window.closed) {
+  u32 frame = 0;
+  u64 runStartMicroseconds = Gm_GetMicroseconds();
+  u64 maxFrameMicroseconds = 0;
+  std::map<std::string, PassTimeTotal> passTimeTotals;
+
+  while (!context->window.closed && (options.frames == 0 || frame < options.frames)) {
+    u64 frameStartMicroseconds = Gm_GetMicroseconds();
     float dt = Gm_GetDeltaTime(context);
 
     Gm_HandleFrameStart(context);
@@ -610,6 +750,18 @@ int main(int argc, char* argv[]) {
 
     Gm_RenderScene(context);
     Gm_HandleFrameEnd(context);
+
+    maxFrameMicroseconds = std::max(maxFrameMicroseconds, Gm_GetMicroseconds() - frameStartMicroseconds);
+    frame++;
+
+    if (options.frames > 0) {
+      accumulatePassTimes(passTimeTotals, context->renderer->getRenderStats().passTimes);
+    }
+  }
+
+  if (options.frames > 0 && frame > 0) {
+    printFrameTimes(frame, Gm_GetMicroseconds() - runStartMicroseconds, maxFrameMicroseconds, context->frameStats.getSummary(1));
+    printPassTimes(passTimeTotals);
   }
 
   Gm_DestroyContext(context);
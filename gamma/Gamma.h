@@ -5,6 +5,9 @@
 #include "math/utilities.h"
 #include "math/vector.h"
 #include "performance/benchmark.h"
+#include "performance/profiler.h"
+#include "physics/broadphase.h"
+#include "physics/projectiles.h"
 #include "system/console.h"
 #include "system/context.h"
 #include "system/entities.h"
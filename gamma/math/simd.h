@@ -0,0 +1,17 @@
+#pragma once
+
+/**
+ * GAMMA_USE_SSE
+ * -------------
+ *
+ * Set to 1 when SSE intrinsics are available to the target,
+ * which is always the case for x64 builds. Code using SSE
+ * should provide a scalar path for when it is 0.
+ */
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64)
+  #include <xmmintrin.h>
+
+  #define GAMMA_USE_SSE 1
+#else
+  #define GAMMA_USE_SSE 0
+#endif
\ No newline at end of file
@@ -55,5 +55,5 @@ inline float Gm_LerpCircularf(float a, float b, float alpha, float maxRange) {
 }
 
 inline float Gm_EaseInOut(float t) {
-  return -(std::cosf(Gm_PI * t) - 1.f) / 2.f;
+  return -(cosf(Gm_PI * t) - 1.f) / 2.f;
 }
\ No newline at end of file
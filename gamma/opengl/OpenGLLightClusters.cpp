@@ -0,0 +1,85 @@
+#include "glew.h"
+
+#include "opengl/OpenGLLightClusters.h"
+
+namespace Gamma {
+  enum GLBuffer {
+    LIGHTS,
+    CLUSTERS,
+    LIGHT_INDICES
+  };
+
+  constexpr static u32 INITIAL_STREAM_REGION_SIZE = 0x40000;
+
+  void OpenGLLightClusters::init() {
+    GLint offsetAlignment;
+
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+
+    alignment = (u32)offsetAlignment;
+
+    stream.init((INITIAL_STREAM_REGION_SIZE + alignment - 1) / alignment * alignment);
+  }
+
+  void OpenGLLightClusters::destroy() {
+    stream.destroy();
+  }
+
+  /**
+   * Appends cluster data to the stream, recording its range
+   * for binding.
+   */
+  void OpenGLLightClusters::append(u32 index, const void* data, u32 size) {
+    offsets[index] = stream.append(data, size, alignment);
+    sizes[index] = size;
+  }
+
+  /**
+   * Binds the cluster buffer ranges to shader storage
+   * binding points 0 (lights), 1 (clusters) and
+   * 2 (light indices).
+   */
+  void OpenGLLightClusters::bind() {
+    GLuint buffer = stream.getBuffer();
+
+    for (u32 i = 0; i < 3; i++) {
+      // Empty ranges can't be bound, but are never
+      // read from by shaders either
+      if (sizes[i] > 0) {
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, i, buffer, offsets[i], sizes[i]);
+      }
+    }
+  }
+
+  const LightClusters& OpenGLLightClusters::getClusters() const {
+    return clusters;
+  }
+
+  /**
+   * Bins the provided lights into clusters on the CPU,
+   * then streams the lights, clusters and light index
+   * list to the shader storage buffer.
+   */
+  void OpenGLLightClusters::update(const std::vector<Light*>& lights, const Area<u32>& resolution, const Camera& camera) {
+    Gm_BuildLightClusters(clusters, lights, camera, resolution);
+
+    clusteredLights.resize(lights.size());
+
+    for (u32 i = 0; i < lights.size(); i++) {
+      auto& light = *lights[i];
+      auto& clusteredLight = clusteredLights[i];
+
+      clusteredLight.position = light.position;
+      clusteredLight.radius = light.radius;
+      clusteredLight.color = light.color;
+      clusteredLight.power = light.power;
+      clusteredLight.direction = light.direction.unit();
+      clusteredLight.fov = light.fov;
+      clusteredLight.type = light.type;
+    }
+
+    append(GLBuffer::LIGHTS, clusteredLights.data(), clusteredLights.size() * sizeof(ClusteredLight));
+    append(GLBuffer::CLUSTERS, clusters.clusters.data(), clusters.clusters.size() * sizeof(LightCluster));
+    append(GLBuffer::LIGHT_INDICES, clusters.lightIndices.data(), clusters.lightIndices.size() * sizeof(u32));
+  }
+}
\ No newline at end of file
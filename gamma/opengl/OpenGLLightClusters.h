@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+
+#include "math/plane.h"
+#include "math/vector.h"
+#include "opengl/OpenGLStreamBuffer.h"
+#include "system/camera.h"
+#include "system/entities.h"
+#include "system/light_clusters.h"
+#include "system/traits.h"
+#include "system/type_aliases.h"
+
+namespace Gamma {
+  /**
+   * ClusteredLight
+   * --------------
+   *
+   * A point or spot light, laid out to match the
+   * std430 light struct in the clustered light shader.
+   */
+  struct ClusteredLight {
+    Vec3f position;
+    float radius;
+    Vec3f color;
+    float power;
+    Vec3f direction;
+    float fov;
+    u32 type;
+    u32 padding[3];
+  };
+
+  class OpenGLLightClusters : public Initable, public Destroyable {
+  public:
+    virtual void init() override;
+    virtual void destroy() override;
+    void bind();
+    const LightClusters& getClusters() const;
+    void update(const std::vector<Light*>& lights, const Area<u32>& resolution, const Camera& camera);
+
+  private:
+    LightClusters clusters;
+    std::vector<ClusteredLight> clusteredLights;
+    /**
+     * Shader storage buffer stream for cluster data, and the
+     * ranges written to it on the last update.
+     *
+     * [0] Lights
+     * [1] Clusters (offset, count)
+     * [2] Light indices
+     */
+    OpenGLStreamBuffer stream;
+    u32 offsets[3] = { 0, 0, 0 };
+    u32 sizes[3] = { 0, 0, 0 };
+    u32 alignment = 1;
+
+    void append(u32 index, const void* data, u32 size);
+  };
+}
\ No newline at end of file
@@ -10,11 +10,7 @@
 
 namespace Gamma {
   constexpr static u32 DISC_SLICES = 16;
-
-  enum GLBuffer {
-    VERTEX,
-    DISC
-  };
+  constexpr static u32 INITIAL_DISC_CAPACITY = 256;
 
   enum GLAttribute {
     VERTEX_POSITION,
@@ -28,17 +24,6 @@ namespace Gamma {
     DISC_LIGHT_FOV
   };
 
-  static inline Matrix4f getLightViewMatrix(const Camera& camera) {
-    Orientation viewOrientation = camera.orientation.invert();
-
-    viewOrientation.roll *= -1.f;  // @hack
-
-    return (
-      Matrix4f::rotation(viewOrientation) *
-      Matrix4f::translation(camera.position.invert())
-    );
-  }
-
   static inline Matrix4f getLightProjectionMatrix(const Area<u32>& resolution, const float fov) {
     const static float near = 1.f;
     const static float far = 10000.f;
@@ -48,9 +33,11 @@ namespace Gamma {
 
   void OpenGLLightDisc::init() {
     glGenVertexArrays(1, &vao);
-    glGenBuffers(2, &buffers[0]);
+    glGenBuffers(1, &vertexBuffer);
     glBindVertexArray(vao);
 
+    discStream.init(INITIAL_DISC_CAPACITY * sizeof(Disc));
+
     // Create the vertices for each slice of the disc
     Vec2f vertexPositions[DISC_SLICES * 3];
 
@@ -70,17 +57,42 @@ namespace Gamma {
     }
 
     // Buffer disc vertices
-    glBindBuffer(GL_ARRAY_BUFFER, buffers[GLBuffer::VERTEX]);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
     glBufferData(GL_ARRAY_BUFFER, sizeof(Vec2f) * DISC_SLICES * 3, vertexPositions, GL_STATIC_DRAW);
 
     // Define disc vertex attributes
-    glBindBuffer(GL_ARRAY_BUFFER, buffers[GLBuffer::VERTEX]);
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
 
     glEnableVertexAttribArray(GLAttribute::VERTEX_POSITION);
     glVertexAttribPointer(GLAttribute::VERTEX_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(Vec2f), (void*)0);
 
+    // Disc instance attributes are defined once the
+    // VAO is first bound for drawing
+    discStreamVersion = 0;
+  }
+
+  void OpenGLLightDisc::destroy() {
+    glDeleteVertexArrays(1, &vao);
+    glDeleteBuffers(1, &vertexBuffer);
+
+    discStream.destroy();
+  }
+
+  /**
+   * Binds the disc VAO, first (re)defining its disc instance
+   * attributes if the disc stream has been reallocated.
+   */
+  void OpenGLLightDisc::bindVertexArray() {
+    glBindVertexArray(vao);
+
+    if (discStreamVersion == discStream.getVersion()) {
+      return;
+    }
+
+    discStreamVersion = discStream.getVersion();
+
     // Define disc instance attributes
-    glBindBuffer(GL_ARRAY_BUFFER, buffers[GLBuffer::DISC]);
+    glBindBuffer(GL_ARRAY_BUFFER, discStream.getBuffer());
 
     glEnableVertexAttribArray(GLAttribute::DISC_OFFSET);
     glVertexAttribPointer(GLAttribute::DISC_OFFSET, 2, GL_FLOAT, GL_FALSE, sizeof(Disc), (void*)offsetof(Disc, offset));
@@ -91,97 +103,75 @@ namespace Gamma {
     glVertexAttribDivisor(GLAttribute::DISC_SCALE, 1);
 
     glEnableVertexAttribArray(GLAttribute::DISC_LIGHT_POSITION);
-    glVertexAttribPointer(GLAttribute::DISC_LIGHT_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(Disc), (void*)(offsetof(Disc, light) + offsetof(Light, position)));
+    glVertexAttribPointer(GLAttribute::DISC_LIGHT_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(Disc), (void*)offsetof(Disc, position));
     glVertexAttribDivisor(GLAttribute::DISC_LIGHT_POSITION, 1);
 
     glEnableVertexAttribArray(GLAttribute::DISC_LIGHT_RADIUS);
-    glVertexAttribPointer(GLAttribute::DISC_LIGHT_RADIUS, 1, GL_FLOAT, GL_FALSE, sizeof(Disc), (void*)(offsetof(Disc, light) + offsetof(Light, radius)));
+    glVertexAttribPointer(GLAttribute::DISC_LIGHT_RADIUS, 1, GL_FLOAT, GL_FALSE, sizeof(Disc), (void*)offsetof(Disc, radius));
     glVertexAttribDivisor(GLAttribute::DISC_LIGHT_RADIUS, 1);
 
     glEnableVertexAttribArray(GLAttribute::DISC_LIGHT_COLOR);
-    glVertexAttribPointer(GLAttribute::DISC_LIGHT_COLOR, 3, GL_FLOAT, GL_FALSE, sizeof(Disc), (void*)(offsetof(Disc, light) + offsetof(Light, color)));
+    glVertexAttribPointer(GLAttribute::DISC_LIGHT_COLOR, 3, GL_FLOAT, GL_FALSE, sizeof(Disc), (void*)offsetof(Disc, color));
     glVertexAttribDivisor(GLAttribute::DISC_LIGHT_COLOR, 1);
 
     glEnableVertexAttribArray(GLAttribute::DISC_LIGHT_POWER);
-    glVertexAttribPointer(GLAttribute::DISC_LIGHT_POWER, 1, GL_FLOAT, GL_FALSE, sizeof(Disc), (void*)(offsetof(Disc, light) + offsetof(Light, power)));
+    glVertexAttribPointer(GLAttribute::DISC_LIGHT_POWER, 1, GL_FLOAT, GL_FALSE, sizeof(Disc), (void*)offsetof(Disc, power));
     glVertexAttribDivisor(GLAttribute::DISC_LIGHT_POWER, 1);
 
     glEnableVertexAttribArray(GLAttribute::DISC_LIGHT_DIRECTION);
-    glVertexAttribPointer(GLAttribute::DISC_LIGHT_DIRECTION, 3, GL_FLOAT, GL_FALSE, sizeof(Disc), (void*)(offsetof(Disc, light) + offsetof(Light, direction)));
+    glVertexAttribPointer(GLAttribute::DISC_LIGHT_DIRECTION, 3, GL_FLOAT, GL_FALSE, sizeof(Disc), (void*)offsetof(Disc, direction));
     glVertexAttribDivisor(GLAttribute::DISC_LIGHT_DIRECTION, 1);
 
     glEnableVertexAttribArray(GLAttribute::DISC_LIGHT_FOV);
-    glVertexAttribPointer(GLAttribute::DISC_LIGHT_FOV, 1, GL_FLOAT, GL_FALSE, sizeof(Disc), (void*)(offsetof(Disc, light) + offsetof(Light, fov)));
+    glVertexAttribPointer(GLAttribute::DISC_LIGHT_FOV, 1, GL_FLOAT, GL_FALSE, sizeof(Disc), (void*)offsetof(Disc, fov));
     glVertexAttribDivisor(GLAttribute::DISC_LIGHT_FOV, 1);
   }
 
-  void OpenGLLightDisc::destroy() {
-    // @todo
-  }
-
-  void OpenGLLightDisc::configureDisc(Disc& disc, const Light& light, const Matrix4f& matProjection, const Matrix4f& matView, float resolutionAspectRatio) {
-    Vec3f localLightPosition = matView.transformVec3f(light.position);
-
-    disc.light = light;
-
-    if (light.power == 0.f) {
-      disc.offset = Vec2f(0.f);
-      disc.scale = Vec2f(0.f);
-    } else if (localLightPosition.z > 0.1f) {
-      // Light source in front of the camera
-      Vec3f screenLightPosition = matProjection.transformVec3f(localLightPosition) / localLightPosition.z;
-
-      disc.offset = Vec2f(screenLightPosition.x, screenLightPosition.y);
-      // @todo use 1 + log(light.power) or similar for scaling term
-      disc.scale.x = 1.5f * light.radius / localLightPosition.z;
-      disc.scale.y = 1.5f * light.radius / localLightPosition.z * resolutionAspectRatio;
-    } else {
-      // Light source behind the camera; scale to cover
-      // screen when within range, and scale to 0 when
-      // out of range
-      float scale = localLightPosition.magnitude() < light.radius ? 2.f : 0.f;
-
-      disc.offset = Vec2f(0.f);
-      disc.scale = Vec2f(scale);
-    }
-  }
-
   void OpenGLLightDisc::draw(const Light& light, const Area<u32>& resolution, const Camera& camera) {
-    Disc discs[1];
-    auto& disc = discs[0];
+    Disc disc;
     float aspectRatio = (float)resolution.width / (float)resolution.height;
     Matrix4f matProjection = getLightProjectionMatrix(resolution, camera.fov);
-    Matrix4f matView = getLightViewMatrix(camera);
+    Matrix4f matView = Gm_GetCameraViewMatrix(camera);
 
-    configureDisc(disc, light, matProjection, matView, aspectRatio);
-
-    glBindBuffer(GL_ARRAY_BUFFER, buffers[GLBuffer::DISC]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(Disc), discs, GL_DYNAMIC_DRAW);
+    if (!Gm_ConfigureLightDisc(disc, light, matProjection, matView, aspectRatio)) {
+      return;
+    }
 
-    glBindVertexArray(vao);
-    glDrawArrays(GL_TRIANGLES, 0, DISC_SLICES * 3);
+    drawDiscs(&disc, 1);
   }
 
   void OpenGLLightDisc::draw(const std::vector<Light*>& lights, const Area<u32>& resolution, const Camera& camera) {
-    // @todo avoid reallocating/freeing the disc array on each draw
-    Disc* discs = new Disc[lights.size()];
     float aspectRatio = (float)resolution.width / (float)resolution.height;
     Matrix4f matProjection = getLightProjectionMatrix(resolution, camera.fov);
-    Matrix4f matView = getLightViewMatrix(camera);
+    Matrix4f matView = Gm_GetCameraViewMatrix(camera);
+    u32 totalDiscs = 0;
+
+    discs.resize(lights.size());
 
-    for (u32 i = 0; i < lights.size(); i++) {
-      auto& light = *lights[i];
-      auto& disc = discs[i];
+    // Only generate discs for lights which are on-screen
+    // and have a nonzero power
+    for (auto* light : lights) {
+      if (Gm_ConfigureLightDisc(discs[totalDiscs], *light, matProjection, matView, aspectRatio)) {
+        totalDiscs++;
+      }
+    }
 
-      configureDisc(disc, light, matProjection, matView, aspectRatio);
+    if (totalDiscs == 0) {
+      return;
     }
 
-    glBindBuffer(GL_ARRAY_BUFFER, buffers[GLBuffer::DISC]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(Disc) * lights.size(), discs, GL_DYNAMIC_DRAW);
+    drawDiscs(discs.data(), totalDiscs);
+  }
+
+  /**
+   * Appends disc instances to the disc stream, and draws
+   * them starting from their position within the stream.
+   */
+  void OpenGLLightDisc::drawDiscs(const Disc* discs, u32 totalDiscs) {
+    u32 offset = discStream.append(discs, sizeof(Disc) * totalDiscs, sizeof(Disc));
 
-    glBindVertexArray(vao);
-    glDrawArraysInstanced(GL_TRIANGLES, 0, DISC_SLICES * 3, lights.size());
+    bindVertexArray();
 
-    delete[] discs;
+    glDrawArraysInstancedBaseInstance(GL_TRIANGLES, 0, DISC_SLICES * 3, totalDiscs, offset / sizeof(Disc));
   }
 }
\ No newline at end of file
@@ -3,17 +3,13 @@
 #include <vector>
 
 #include "math/plane.h"
+#include "opengl/OpenGLStreamBuffer.h"
 #include "system/entities.h"
+#include "system/light_discs.h"
 #include "system/traits.h"
 #include "system/type_aliases.h"
 
 namespace Gamma {
-  struct Disc {
-    Vec2f offset;
-    Vec2f scale;
-    Light light;
-  };
-
   class OpenGLLightDisc : public Initable, public Destroyable {
   public:
     virtual void init() override;
@@ -23,14 +19,16 @@ namespace Gamma {
 
   private:
     GLuint vao;
+    GLuint vertexBuffer;
     /**
-     * Buffers for light disc attributes.
-     *
-     * [0] Vertex
-     * [2] Disc instances (scale, offset, light)
+     * Stream for disc instances (scale, offset, light),
+     * which are regenerated every frame.
      */
-    GLuint buffers[2];
+    OpenGLStreamBuffer discStream;
+    u32 discStreamVersion = 0;
+    std::vector<Disc> discs;
 
-    void configureDisc(Disc& disc, const Light& light, const Matrix4f& matProjection, const Matrix4f& matView, float resolutionAspectRatio);
+    void bindVertexArray();
+    void drawDiscs(const Disc* discs, u32 totalDiscs);
   };
 }
\ No newline at end of file
@@ -1,81 +1,59 @@
 #include "opengl/errors.h"
+#include "opengl/geometry_buffer.h"
 #include "opengl/indirect_buffer.h"
+#include "opengl/instance_buffer.h"
 #include "opengl/OpenGLMesh.h"
+#include "performance/memory.h"
 #include "system/console.h"
 #include "system/flags.h"
 
 #include "glew.h"
 
-namespace Gamma {
-  const enum GLBuffer {
-    VERTEX,
-    COLOR,
-    MATRIX
-  };
-
-  const enum GLAttribute {
-    VERTEX_POSITION,
-    VERTEX_NORMAL,
-    VERTEX_TANGENT,
-    VERTEX_UV,
-    MODEL_COLOR,
-    MODEL_MATRIX
-  };
+#define NO_INSTANCE_INDEX 0xffffffff
 
+namespace Gamma {
   OpenGLMesh::OpenGLMesh(Mesh* mesh) {
     sourceMesh = mesh;
 
     glGenVertexArrays(1, &vao);
-    glGenBuffers(3, &buffers[0]);
-    glGenBuffers(1, &ebo);
-    glBindVertexArray(vao);
-
-    auto& vertices = mesh->vertices;
-    auto& faceElements = mesh->faceElements;
+    glGenBuffers(1, &indexBuffer);
 
-    // Buffer vertex data
-    glBindBuffer(GL_ARRAY_BUFFER, buffers[GLBuffer::VERTEX]);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
-    
-    // Buffer vertex element data
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, faceElements.size() * sizeof(u32), faceElements.data(), GL_STATIC_DRAW);
+    // Buffer vertex/face element data, and reserve
+    // instance data for the full object pool
+    geometry = Gm_AllocateGeometry(mesh->vertices, mesh->faceElements, mesh->geometryKey);
+    instances = Gm_AllocateInstances(mesh->objects.max());
 
-    // Define vertex attributes
-    glBindBuffer(GL_ARRAY_BUFFER, buffers[GLBuffer::VERTEX]);
-
-    glEnableVertexAttribArray(GLAttribute::VERTEX_POSITION);
-    glVertexAttribPointer(GLAttribute::VERTEX_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+    // Define vertex and color/matrix attributes
+    glBindVertexArray(vao);
 
-    glEnableVertexAttribArray(GLAttribute::VERTEX_NORMAL);
-    glVertexAttribPointer(GLAttribute::VERTEX_NORMAL, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+    Gm_DefineGeometryAttributes();
+    Gm_DefineInstanceAttributes();
 
-    glEnableVertexAttribArray(GLAttribute::VERTEX_TANGENT);
-    glVertexAttribPointer(GLAttribute::VERTEX_TANGENT, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tangent));
+    geometryVersion = Gm_GetGeometryBufferVersion();
+    instanceVersion = Gm_GetInstanceBufferVersion();
 
-    glEnableVertexAttribArray(GLAttribute::VERTEX_UV);
-    glVertexAttribPointer(GLAttribute::VERTEX_UV, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, uv));
+    // Define visible object index attributes. These are only
+    // enabled when drawing from a visible index list; otherwise,
+    // shaders receive the constant NO_INSTANCE_INDEX, and use
+    // the per-instance color/matrix attributes directly.
+    glBindBuffer(GL_ARRAY_BUFFER, indexBuffer);
+    glVertexAttribIPointer(GLAttribute::INSTANCE_INDEX, 1, GL_UNSIGNED_INT, sizeof(u32), (void*)0);
+    glVertexAttribDivisor(GLAttribute::INSTANCE_INDEX, 1);
+    glVertexAttribI1ui(GLAttribute::INSTANCE_INDEX, NO_INSTANCE_INDEX);
+  }
 
-    // Define color attributes
-    glBindBuffer(GL_ARRAY_BUFFER, buffers[GLBuffer::COLOR]);
-    glEnableVertexAttribArray(GLAttribute::MODEL_COLOR);
-    glVertexAttribIPointer(GLAttribute::MODEL_COLOR, 1, GL_UNSIGNED_INT, sizeof(pVec4), (void*)0);
-    glVertexAttribDivisor(GLAttribute::MODEL_COLOR, 1);
+  OpenGLMesh::~OpenGLMesh() {
+    glDeleteVertexArrays(1, &vao);
+    glDeleteBuffers(1, &indexBuffer);
 
-    // Define matrix attributes
-    glBindBuffer(GL_ARRAY_BUFFER, buffers[GLBuffer::MATRIX]);
+    Gm_TrackMemory(MemoryCategory::GPU_MESHES, -(s64)indexBufferSize);
 
-    for (u32 i = 0; i < 4; i++) {
-      glEnableVertexAttribArray(GLAttribute::MODEL_MATRIX + i);
-      glVertexAttribPointer(GLAttribute::MODEL_MATRIX + i, 4, GL_FLOAT, GL_FALSE, sizeof(Matrix4f), (void*)(i * 4 * sizeof(float)));
-      glVertexAttribDivisor(GLAttribute::MODEL_MATRIX + i, 1);
+    if (useVertexStream) {
+      vertexStream.destroy();
     }
-  }
 
-  OpenGLMesh::~OpenGLMesh() {
-    glDeleteVertexArrays(1, &vao);
-    glDeleteBuffers(3, &buffers[0]);
-    glDeleteBuffers(1, &ebo);
+    Gm_FreeGeometry(geometry);
+    Gm_FreeInstances(instances);
 
     if (glTexture != nullptr) {
       delete glTexture;
@@ -86,6 +64,133 @@ namespace Gamma {
     }
   }
 
+  /**
+   * Enables or disables the visible object index attribute
+   * for the mesh VAO, which must be bound. When enabled,
+   * the global instance buffers are also bound as storage
+   * buffers for shaders to index into.
+   */
+  void OpenGLMesh::bindInstanceIndices(bool useVisibilityIndices) {
+    if (useVisibilityIndices) {
+      glEnableVertexAttribArray(GLAttribute::INSTANCE_INDEX);
+
+      Gm_BindInstanceStorageBuffers();
+    } else {
+      glDisableVertexAttribArray(GLAttribute::INSTANCE_INDEX);
+    }
+  }
+
+  /**
+   * Binds the mesh VAO, first redefining its attributes if
+   * the global geometry or instance buffers, or the vertex
+   * stream, have been reallocated.
+   */
+  void OpenGLMesh::bindVertexArray() {
+    glBindVertexArray(vao);
+
+    bool shouldDefineGeometryAttributes = (
+      geometryVersion != Gm_GetGeometryBufferVersion() ||
+      (useVertexStream && vertexStreamVersion != vertexStream.getVersion())
+    );
+
+    if (shouldDefineGeometryAttributes) {
+      Gm_DefineGeometryAttributes(useVertexStream ? vertexStream.getBuffer() : 0);
+
+      geometryVersion = Gm_GetGeometryBufferVersion();
+      vertexStreamVersion = vertexStream.getVersion();
+    }
+
+    if (instanceVersion != Gm_GetInstanceBufferVersion()) {
+      Gm_DefineInstanceAttributes();
+
+      instanceVersion = Gm_GetInstanceBufferVersion();
+    }
+  }
+
+  /**
+   * Streams transformed vertices once per change, into each
+   * frame region they are drawn from. Meshes are drawn from
+   * several passes per frame, so this is a no-op for all but
+   * the first draw after a change.
+   */
+  void OpenGLMesh::bufferGeometry() {
+    auto& mesh = *sourceMesh;
+
+    if (mesh.transformedVertices.size() == 0) {
+      return;
+    }
+
+    if (!useVertexStream) {
+      vertexStream.init(geometry.totalVertices * sizeof(Vertex), MemoryCategory::GPU_MESHES);
+
+      useVertexStream = true;
+    }
+
+    if (vertexDataVersion == 0 || mesh.geometryVersion != sourceGeometryVersion) {
+      vertexDataVersion++;
+      sourceGeometryVersion = mesh.geometryVersion;
+    }
+
+    u32 region = vertexStream.getRegionIndex();
+
+    if (bufferedVertexVersions[region] != vertexDataVersion) {
+      vertexStream.write(0, mesh.transformedVertices.data(), geometry.totalVertices * sizeof(Vertex));
+
+      bufferedVertexVersions[region] = vertexDataVersion;
+    }
+  }
+
+  void OpenGLMesh::bufferInstances() {
+    auto& mesh = *sourceMesh;
+
+    bool hasChangedInstances = (
+      // Buffer instances if we haven't buffered them at all yet
+      instanceDataVersion == 0 ||
+      // Buffer instances for non-GPU particle meshes when any objects are changed
+      ((mesh.type != MeshType::PARTICLES || !mesh.particles.useGpuParticles) && mesh.objects.changed)
+    );
+
+    if (hasChangedInstances) {
+      instanceDataVersion++;
+
+      mesh.objects.changed = false;
+    }
+
+    u32 region = Gm_GetInstanceRegion();
+
+    if (bufferedInstanceVersions[region] != instanceDataVersion) {
+      // Meshes drawn from visible index lists keep all of their
+      // active objects buffered, in their original order
+      u16 totalInstances = mesh.useVisibilityIndices ? mesh.objects.totalActive() : mesh.objects.totalVisible();
+
+      Gm_BufferInstances(instances, mesh.objects.getColors(), mesh.objects.getMatrices(), totalInstances);
+
+      bufferedInstanceVersions[region] = instanceDataVersion;
+    }
+
+    if (mesh.useVisibilityIndices && mesh.visibleIndicesFrame != bufferedVisibleIndicesFrame) {
+      // Buffer visible object indices once per rebuild. Shaders
+      // index into the global instance buffers, so offset each
+      // index by the start of the mesh's instance range.
+      auto& visibleIndices = mesh.visibleIndices;
+
+      instanceIndices.resize(visibleIndices.size());
+
+      for (u32 i = 0; i < visibleIndices.size(); i++) {
+        instanceIndices[i] = instances.offset + visibleIndices[i];
+      }
+
+      glBindBuffer(GL_ARRAY_BUFFER, indexBuffer);
+      glBufferData(GL_ARRAY_BUFFER, instanceIndices.size() * sizeof(u32), instanceIndices.data(), GL_DYNAMIC_DRAW);
+
+      Gm_TrackMemory(MemoryCategory::GPU_MESHES, (s64)(instanceIndices.size() * sizeof(u32)) - indexBufferSize);
+
+      indexBufferSize = instanceIndices.size() * sizeof(u32);
+
+      bufferedVisibleIndicesFrame = mesh.visibleIndicesFrame;
+    }
+  }
+
   void OpenGLMesh::checkAndLoadTexture(const std::string& path, OpenGLTexture*& texture, GLenum unit) {
     #if GAMMA_DEVELOPER_MODE
       if (texture != nullptr && texture->getPath() != path) {
@@ -111,6 +216,24 @@ namespace Gamma {
     }
   }
 
+  /**
+   * Returns the base vertex for the mesh's vertices, which
+   * are either streamed or in the global geometry buffer.
+   */
+  u32 OpenGLMesh::getBaseVertex() {
+    return useVertexStream
+      ? vertexStream.getRegionOffset() / sizeof(Vertex)
+      : geometry.baseVertex;
+  }
+
+  const GeometryRange& OpenGLMesh::getGeometryRange() const {
+    return geometry;
+  }
+
+  const InstanceRange& OpenGLMesh::getInstanceRange() const {
+    return instances;
+  }
+
   u16 OpenGLMesh::getId() const {
     return sourceMesh->id;
   }
@@ -139,7 +262,11 @@ namespace Gamma {
   void OpenGLMesh::render(GLenum primitiveMode, bool useLowestLevelOfDetail) {
     auto& mesh = *sourceMesh;
 
-    if (mesh.objects.totalVisible() == 0 || mesh.disabled) {
+    u32 totalInstances = mesh.useVisibilityIndices
+      ? (u32)mesh.visibleIndices.size()
+      : mesh.objects.totalVisible();
+
+    if (totalInstances == 0 || mesh.disabled) {
       return;
     }
 
@@ -155,45 +282,25 @@ namespace Gamma {
 
     checkAndLoadTexture(mesh.normals, glNormalMap, GL_TEXTURE1);
 
-    if (sourceMesh->transformedVertices.size() > 0) {
-      // Re-buffer geometry
-      auto& transformedVertices = sourceMesh->transformedVertices;
-
-      glBindBuffer(GL_ARRAY_BUFFER, buffers[GLBuffer::VERTEX]);
-      // @todo glMapBuffer (?)
-      glBufferData(GL_ARRAY_BUFFER, transformedVertices.size() * sizeof(Vertex), transformedVertices.data(), GL_DYNAMIC_DRAW);
-    }
-
-    bool shouldBufferInstances = (
-      // Buffer instances if we haven't created the buffers at all yet
-      !hasCreatedInstanceBuffers ||
-      // Buffer instances for non-GPU particle meshes when any objects are changed
-      ((mesh.type != MeshType::PARTICLES || !mesh.particles.useGpuParticles) && mesh.objects.changed)
-    );
-
-    if (shouldBufferInstances) {
-      // Buffer colors
-      glBindBuffer(GL_ARRAY_BUFFER, buffers[GLBuffer::COLOR]);
-      glBufferData(GL_ARRAY_BUFFER, mesh.objects.totalVisible() * sizeof(pVec4), mesh.objects.getColors(), GL_DYNAMIC_DRAW);
+    bufferGeometry();
+    bufferInstances();
 
-      // Buffer matrices
-      glBindBuffer(GL_ARRAY_BUFFER, buffers[GLBuffer::MATRIX]);
-      glBufferData(GL_ARRAY_BUFFER, mesh.objects.totalVisible() * sizeof(Matrix4f), mesh.objects.getMatrices(), GL_DYNAMIC_DRAW);
+    // Bind VAO and draw instances
+    bindVertexArray();
+    bindInstanceIndices(mesh.useVisibilityIndices);
 
-      hasCreatedInstanceBuffers = true;
-      mesh.objects.changed = false;
-    }
-
-    // Bind VAO/EBO and draw instances
-    glBindVertexArray(vao);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    // Instances drawn from visible index lists are selected by
+    // their indices, so base instances refer to positions within
+    // the index list rather than to the global instance buffers
+    u32 baseInstance = mesh.useVisibilityIndices ? 0 : Gm_GetBaseInstance(instances);
+    u32 baseVertex = getBaseVertex();
 
     if (mesh.lods.size() > 0) {
       if (useLowestLevelOfDetail) {
         // Render all instances using the last LOD
         auto& lod = mesh.lods.back();
 
-        glDrawElementsInstanced(primitiveMode, lod.elementCount, GL_UNSIGNED_INT, (void*)(lod.elementOffset * sizeof(u32)), mesh.objects.totalVisible());
+        glDrawElementsInstancedBaseVertexBaseInstance(primitiveMode, lod.elementCount, GL_UNSIGNED_INT, (void*)((geometry.firstIndex + lod.elementOffset) * sizeof(u32)), totalInstances, baseVertex, baseInstance);
       } else {
         // Generate draw commands for mesh instances at each
         // level of detail, and dispatch them all together
@@ -206,30 +313,86 @@ namespace Gamma {
           auto& lod = mesh.lods[i];
 
           command.count = lod.elementCount;
-          command.firstIndex = lod.elementOffset;
+          command.firstIndex = geometry.firstIndex + lod.elementOffset;
           command.instanceCount = lod.instanceCount;
-          command.baseInstance = lod.instanceOffset;
-          // @todo base vertexes are already added to elements;
-          // this may need to change if we revise the way mesh
-          // data is stored/use glMultiDraw more broadly
-          command.baseVertex = 0;
+          command.baseInstance = baseInstance + lod.instanceOffset;
+          // LOD elements are already offset to their own
+          // vertices within the mesh, so only the mesh's
+          // base vertex is needed
+          command.baseVertex = baseVertex;
         }
 
-        Gm_BufferDrawElementsIndirectCommands(commands, 2);
+        auto* indirect = Gm_BufferDrawElementsIndirectCommands(commands, mesh.lods.size());
 
-        glMultiDrawElementsIndirect(primitiveMode, GL_UNSIGNED_INT, 0, 2, 0);
+        glMultiDrawElementsIndirect(primitiveMode, GL_UNSIGNED_INT, indirect, mesh.lods.size(), 0);
 
         delete[] commands;
       }
     } else if (mesh.type == MeshType::PARTICLES) {
       // @todo description
-      glBindBuffer(GL_ARRAY_BUFFER, buffers[GLBuffer::VERTEX]);
-
-      glDrawArraysInstanced(GL_POINTS, 0, 1, mesh.objects.totalVisible());
+      glDrawArraysInstancedBaseInstance(GL_POINTS, baseVertex, 1, totalInstances, baseInstance);
     } else {
       // No distinct level of detail meshes defined;
       // draw all mesh instances together
-      glDrawElementsInstanced(primitiveMode, mesh.faceElements.size(), GL_UNSIGNED_INT, (void*)0, mesh.objects.totalVisible());
+      glDrawElementsInstancedBaseVertexBaseInstance(primitiveMode, geometry.totalIndices, GL_UNSIGNED_INT, (void*)(geometry.firstIndex * sizeof(u32)), totalInstances, baseVertex, baseInstance);
+    }
+  }
+
+  /**
+   * Renders a subset of the mesh instances, defined as runs of
+   * contiguous instances, with a single multi-draw call. Instance
+   * data remains in place; each run is drawn using its offset as
+   * the base instance.
+   */
+  void OpenGLMesh::renderInstanceRuns(GLenum primitiveMode, const InstanceRun* runs, u32 totalRuns, bool useLowestLevelOfDetail) {
+    auto& mesh = *sourceMesh;
+
+    if (totalRuns == 0 || mesh.objects.totalVisible() == 0 || mesh.disabled) {
+      return;
+    }
+
+    if (mesh.type != MeshType::REFRACTIVE) {
+      checkAndLoadTexture(mesh.texture, glTexture, GL_TEXTURE0);
+    }
+
+    checkAndLoadTexture(mesh.normals, glNormalMap, GL_TEXTURE1);
+
+    bufferGeometry();
+    bufferInstances();
+
+    u32 elementOffset = 0;
+    u32 elementCount = geometry.totalIndices;
+
+    if (mesh.lods.size() > 0) {
+      auto& lod = useLowestLevelOfDetail ? mesh.lods.back() : mesh.lods[0];
+
+      elementOffset = lod.elementOffset;
+      elementCount = lod.elementCount;
+    }
+
+    u32 baseInstance = Gm_GetBaseInstance(instances);
+    u32 baseVertex = getBaseVertex();
+
+    runCommands.resize(totalRuns);
+
+    for (u32 i = 0; i < totalRuns; i++) {
+      auto& command = runCommands[i];
+
+      command.count = elementCount;
+      command.firstIndex = geometry.firstIndex + elementOffset;
+      command.instanceCount = runs[i].count;
+      command.baseInstance = baseInstance + runs[i].offset;
+      command.baseVertex = baseVertex;
     }
+
+    bindVertexArray();
+
+    // Instance runs refer to objects in their original order,
+    // rather than to positions in a visible index list
+    bindInstanceIndices(false);
+
+    auto* indirect = Gm_BufferDrawElementsIndirectCommands(runCommands.data(), totalRuns);
+
+    glMultiDrawElementsIndirect(primitiveMode, GL_UNSIGNED_INT, indirect, totalRuns, 0);
   }
 }
\ No newline at end of file
@@ -1,8 +1,14 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
+#include "opengl/geometry_buffer.h"
+#include "opengl/indirect_buffer.h"
+#include "opengl/instance_buffer.h"
+#include "opengl/OpenGLStreamBuffer.h"
 #include "opengl/OpenGLTexture.h"
+#include "system/culling.h"
 #include "system/entities.h"
 #include "system/type_aliases.h"
 
@@ -12,30 +18,68 @@ namespace Gamma {
     OpenGLMesh(Mesh* mesh);
     ~OpenGLMesh();
 
+    void bufferGeometry();
+    void bufferInstances();
+    const GeometryRange& getGeometryRange() const;
     u16 getId() const;
+    const InstanceRange& getInstanceRange() const;
     u16 getObjectCount() const;
     const Mesh* getSourceMesh() const;
     bool hasNormalMap() const;
     bool hasTexture() const;
     bool isMeshType(MeshType type) const;
     void render(GLenum primitiveMode, bool useLowestLevelOfDetail = false);
+    void renderInstanceRuns(GLenum primitiveMode, const InstanceRun* runs, u32 totalRuns, bool useLowestLevelOfDetail = false);
 
   private:
     Mesh* sourceMesh = nullptr;
     GLuint vao;
     /**
-     * Buffers for instanced object attributes.
-     *
-     * [0] Vertex
-     * [1] Color
-     * [2] Matrix
+     * Buffer for visible object indices. Vertex/face element
+     * and instance color/matrix data are stored in the global
+     * geometry and instance buffers, within the mesh's
+     * geometry and instance ranges.
      */
-    GLuint buffers[3];
-    GLuint ebo;
+    GLuint indexBuffer = 0;
+    u32 indexBufferSize = 0;
+    GeometryRange geometry;
+    InstanceRange instances;
+    u32 geometryVersion = 0;
+    u32 instanceVersion = 0;
+    std::vector<u32> instanceIndices;
+    /**
+     * Draw commands for renderInstanceRuns(), kept between
+     * calls since runs are drawn for every shadowcasting
+     * light each frame.
+     */
+    std::vector<GlDrawElementsIndirectCommand> runCommands;
+    /**
+     * Transformed vertices may change every frame, so they
+     * are streamed from a buffer of their own rather than
+     * overwriting the mesh's range in the geometry buffer.
+     * As with instance data, each frame region is only
+     * rewritten when it holds an older version.
+     */
+    OpenGLStreamBuffer vertexStream;
+    bool useVertexStream = false;
+    u32 vertexStreamVersion = 0;
+    u32 sourceGeometryVersion = 0;
+    u32 vertexDataVersion = 0;
+    u32 bufferedVertexVersions[STREAM_BUFFER_REGIONS] = { 0, 0, 0 };
+    /**
+     * Instance data must be written into each frame region
+     * of the instance buffer separately. Regions holding an
+     * older instance data version are rewritten when used.
+     */
+    u32 instanceDataVersion = 0;
+    u32 bufferedInstanceVersions[STREAM_BUFFER_REGIONS] = { 0, 0, 0 };
     OpenGLTexture* glTexture = nullptr;
     OpenGLTexture* glNormalMap = nullptr;
-    bool hasCreatedInstanceBuffers = false;
+    u32 bufferedVisibleIndicesFrame = 0;
 
+    void bindVertexArray();
+    void bindInstanceIndices(bool useVisibilityIndices);
     void checkAndLoadTexture(const std::string& path, OpenGLTexture*& texture, GLenum unit);
+    u32 getBaseVertex();
   };
 }
\ No newline at end of file
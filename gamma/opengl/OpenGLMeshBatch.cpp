@@ -0,0 +1,202 @@
+#include "opengl/geometry_buffer.h"
+#include "opengl/instance_buffer.h"
+#include "opengl/OpenGLMeshBatch.h"
+
+#include "glew.h"
+
+namespace Gamma {
+  enum MaterialFlags {
+    XZ_PLANE_TEXTURING = 1,
+    CLOSE_TRANSLUCENCY = 2
+  };
+
+  enum GLStorageBinding {
+    DRAW_MATERIALS = 5
+  };
+
+  constexpr static u32 INITIAL_MATERIAL_CAPACITY = 1024;
+
+  void OpenGLMeshBatch::init() {
+    GLint alignment;
+
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+    materialAlignment = (u32)alignment;
+
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+
+    Gm_DefineGeometryAttributes();
+    Gm_DefineInstanceAttributes();
+
+    geometryVersion = Gm_GetGeometryBufferVersion();
+    instanceVersion = Gm_GetInstanceBufferVersion();
+
+    // Keep material region offsets aligned for binding
+    u32 regionSize = INITIAL_MATERIAL_CAPACITY * sizeof(DrawMaterial);
+
+    materialStream.init((regionSize + materialAlignment - 1) / materialAlignment * materialAlignment);
+  }
+
+  void OpenGLMeshBatch::destroy() {
+    glDeleteVertexArrays(1, &vao);
+
+    materialStream.destroy();
+  }
+
+  void OpenGLMeshBatch::addCommand(const Mesh& mesh, const GlDrawElementsIndirectCommand& command) {
+    DrawMaterial material;
+
+    material.roughness = mesh.roughness;
+    material.emissivity = mesh.emissivity;
+    material.flags = 0;
+    material.padding = 0;
+
+    if (mesh.useXzPlaneTexturing) {
+      material.flags |= MaterialFlags::XZ_PLANE_TEXTURING;
+    }
+
+    if (mesh.useCloseTranslucency) {
+      material.flags |= MaterialFlags::CLOSE_TRANSLUCENCY;
+    }
+
+    commands.push_back(command);
+    materials.push_back(material);
+  }
+
+  /**
+   * Adds a draw command for each run of contiguous mesh
+   * instances. Runs refer to the mesh's visible instances.
+   */
+  void OpenGLMeshBatch::addInstanceRuns(OpenGLMesh* glMesh, const InstanceRun* runs, u32 totalRuns, bool useLowestLevelOfDetail) {
+    auto& mesh = *glMesh->getSourceMesh();
+    auto& geometry = glMesh->getGeometryRange();
+    auto& instances = glMesh->getInstanceRange();
+
+    if (totalRuns == 0 || mesh.objects.totalVisible() == 0 || mesh.disabled) {
+      return;
+    }
+
+    glMesh->bufferGeometry();
+    glMesh->bufferInstances();
+
+    u32 elementOffset = 0;
+    u32 elementCount = geometry.totalIndices;
+
+    if (mesh.lods.size() > 0) {
+      auto& lod = useLowestLevelOfDetail ? mesh.lods.back() : mesh.lods[0];
+
+      elementOffset = lod.elementOffset;
+      elementCount = lod.elementCount;
+    }
+
+    for (u32 i = 0; i < totalRuns; i++) {
+      GlDrawElementsIndirectCommand command;
+
+      command.count = elementCount;
+      command.firstIndex = geometry.firstIndex + elementOffset;
+      command.instanceCount = runs[i].count;
+      command.baseInstance = Gm_GetBaseInstance(instances) + runs[i].offset;
+      command.baseVertex = geometry.baseVertex;
+
+      addCommand(mesh, command);
+    }
+  }
+
+  /**
+   * Adds draw commands for all visible mesh instances,
+   * one per level of detail where the mesh defines them.
+   */
+  void OpenGLMeshBatch::addMesh(OpenGLMesh* glMesh, bool useLowestLevelOfDetail) {
+    auto& mesh = *glMesh->getSourceMesh();
+    auto& geometry = glMesh->getGeometryRange();
+    auto& instances = glMesh->getInstanceRange();
+    u32 totalInstances = mesh.objects.totalVisible();
+
+    if (totalInstances == 0 || mesh.disabled) {
+      return;
+    }
+
+    if (mesh.lods.size() > 0 && !useLowestLevelOfDetail) {
+      glMesh->bufferGeometry();
+      glMesh->bufferInstances();
+
+      for (auto& lod : mesh.lods) {
+        GlDrawElementsIndirectCommand command;
+
+        command.count = lod.elementCount;
+        command.firstIndex = geometry.firstIndex + lod.elementOffset;
+        command.instanceCount = lod.instanceCount;
+        command.baseInstance = Gm_GetBaseInstance(instances) + lod.instanceOffset;
+        command.baseVertex = geometry.baseVertex;
+
+        addCommand(mesh, command);
+      }
+    } else {
+      InstanceRun run = { 0, totalInstances };
+
+      addInstanceRuns(glMesh, &run, 1, useLowestLevelOfDetail);
+    }
+  }
+
+  u32 OpenGLMeshBatch::getTotalCommands() const {
+    return commands.size();
+  }
+
+  /**
+   * Dispatches all added draw commands with a single multi-draw
+   * call. When useDrawMaterials is set, each command's material
+   * parameters are made available to shaders at storage buffer
+   * binding 5, indexed by gl_DrawID.
+   */
+  void OpenGLMeshBatch::render(GLenum primitiveMode, bool useDrawMaterials) {
+    if (commands.size() == 0) {
+      return;
+    }
+
+    if (useDrawMaterials) {
+      u32 size = materials.size() * sizeof(DrawMaterial);
+      u32 offset = materialStream.append(materials.data(), size, materialAlignment);
+
+      glBindBufferRange(GL_SHADER_STORAGE_BUFFER, GLStorageBinding::DRAW_MATERIALS, materialStream.getBuffer(), offset, size);
+    }
+
+    glBindVertexArray(vao);
+
+    if (geometryVersion != Gm_GetGeometryBufferVersion()) {
+      Gm_DefineGeometryAttributes();
+
+      geometryVersion = Gm_GetGeometryBufferVersion();
+    }
+
+    if (instanceVersion != Gm_GetInstanceBufferVersion()) {
+      Gm_DefineInstanceAttributes();
+
+      instanceVersion = Gm_GetInstanceBufferVersion();
+    }
+
+    auto* indirect = Gm_BufferDrawElementsIndirectCommands(commands.data(), commands.size());
+
+    glMultiDrawElementsIndirect(primitiveMode, GL_UNSIGNED_INT, indirect, commands.size(), 0);
+
+    commands.clear();
+    materials.clear();
+  }
+
+  /**
+   * Determines whether a mesh can be drawn as part of a batch.
+   * Particles and meshes drawn from visible index lists use
+   * their own instance layouts, and meshes with transformed
+   * geometry stream their own vertices, so these are always
+   * drawn separately.
+   */
+  bool OpenGLMeshBatch::canBatch(const Mesh& mesh) {
+    return (
+      mesh.type != MeshType::PARTICLES &&
+      !mesh.useVisibilityIndices &&
+      mesh.transformedVertices.size() == 0 &&
+      !mesh.disabled &&
+      mesh.totalFaceElements > 0
+    );
+  }
+}
\ No newline at end of file
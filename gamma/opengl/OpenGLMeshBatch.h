@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+
+#include "opengl/indirect_buffer.h"
+#include "opengl/OpenGLMesh.h"
+#include "opengl/OpenGLStreamBuffer.h"
+#include "system/culling.h"
+#include "system/entities.h"
+#include "system/traits.h"
+#include "system/type_aliases.h"
+
+namespace Gamma {
+  /**
+   * DrawMaterial
+   * ------------
+   *
+   * Per-draw material parameters, laid out to match the
+   * std430 material struct in the geometry shaders.
+   */
+  struct DrawMaterial {
+    float roughness;
+    float emissivity;
+    u32 flags;
+    u32 padding;
+  };
+
+  /**
+   * OpenGLMeshBatch
+   * ---------------
+   *
+   * Draws instances of many meshes with a single multi-draw
+   * call. Since all mesh geometry and instance data lives in
+   * the global geometry/instance buffers, meshes differ only
+   * by their baseVertex/firstIndex/baseInstance, which are
+   * provided with each draw command.
+   *
+   * Batched meshes must share a shader. Material parameters
+   * may differ between meshes if the shader reads them from
+   * the per-draw material buffer; otherwise, they must share
+   * its uniforms for the duration of each render() call.
+   */
+  class OpenGLMeshBatch : public Initable, public Destroyable {
+  public:
+    virtual void init() override;
+    virtual void destroy() override;
+    void addInstanceRuns(OpenGLMesh* glMesh, const InstanceRun* runs, u32 totalRuns, bool useLowestLevelOfDetail = false);
+    void addMesh(OpenGLMesh* glMesh, bool useLowestLevelOfDetail = false);
+    u32 getTotalCommands() const;
+    void render(GLenum primitiveMode, bool useDrawMaterials = false);
+
+    static bool canBatch(const Mesh& mesh);
+
+  private:
+    GLuint vao = 0;
+    OpenGLStreamBuffer materialStream;
+    u32 materialAlignment = 1;
+    u32 geometryVersion = 0;
+    u32 instanceVersion = 0;
+    std::vector<GlDrawElementsIndirectCommand> commands;
+    std::vector<DrawMaterial> materials;
+
+    void addCommand(const Mesh& mesh, const GlDrawElementsIndirectCommand& command);
+  };
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <cstdio>
+#include <cstring>
 #include <map>
 
 #include "SDL.h"
@@ -9,13 +10,20 @@
 #include "SDL_opengl.h"
 
 #include "opengl/errors.h"
+#include "opengl/geometry_buffer.h"
 #include "opengl/indirect_buffer.h"
+#include "opengl/instance_buffer.h"
 #include "opengl/OpenGLRenderer.h"
 #include "opengl/OpenGLScreenQuad.h"
+#include "opengl/OpenGLStreamBuffer.h"
 #include "opengl/renderer_setup.h"
 #include "math/utilities.h"
+#include "performance/memory.h"
+#include "performance/profiler.h"
+#include "system/assert.h"
 #include "system/camera.h"
 #include "system/console.h"
+#include "system/culling.h"
 #include "system/context.h"
 #include "system/entities.h"
 #include "system/flags.h"
@@ -23,26 +31,10 @@
 #include "system/vector_helpers.h"
 
 namespace Gamma {
-  const static u32 MAX_LIGHTS = 1000;
   const static Vec4f FULL_SCREEN_TRANSFORM = { 0.0f, 0.0f, 1.0f, 1.0f };
-
-  const static Vec3f CUBE_MAP_DIRECTIONS[6] = {
-    Vec3f(-1.0f, 0.0f, 0.0f),
-    Vec3f(1.0f, 0.0f, 0.0f),
-    Vec3f(0.0f, -1.0f, 0.0f),
-    Vec3f(0.0f, 1.0f, 0.0f),
-    Vec3f(0.0f, 0.0f, -1.0f),
-    Vec3f(0.0f, 0.0f, 1.0f)
-  };
-
-  const static Vec3f CUBE_MAP_UP_DIRECTIONS[6] = {
-    Vec3f(0.0f, -1.0f, 0.0f),
-    Vec3f(0.0f, -1.0f, 0.0f),
-    Vec3f(0.0f, 0.0f, 1.0f),
-    Vec3f(0.0f, 0.0f, -1.0f),
-    Vec3f(0.0f, -1.0f, 0.0f),
-    Vec3f(0.0f, -1.0f, 0.0f)
-  };
+  // Matches the size of the point shadowcaster
+  // view shader's face mask uniform array
+  constexpr static u32 MAX_RUNS_PER_DRAW = 32;
 
   /**
    * OpenGLRenderer
@@ -59,7 +51,14 @@ namespace Gamma {
     SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
     SDL_GL_SetAttribute(SDL_GL_STENCIL_SIZE, 8);
 
-    glContext = SDL_GL_CreateContext(gmContext->window.sdl_window);
+    if (gmContext->window.offscreen) {
+      bool isContextCreated = Gm_CreateOffscreenContext(offscreenContext, gmContext->window.size);
+
+      assert(isContextCreated, "[Gamma] Failed to create an offscreen OpenGL context");
+    } else {
+      glContext = SDL_GL_CreateContext(gmContext->window.sdl_window);
+    }
+
     glewExperimental = true;
 
     glewInit();
@@ -68,6 +67,8 @@ namespace Gamma {
 
     // Initialize global buffers
     Gm_InitDrawIndirectBuffer();
+    Gm_InitGeometryBuffer();
+    Gm_InitInstanceBuffer();
 
     // Initialize screen texture
     glGenTextures(1, &screenTexture);
@@ -79,6 +80,9 @@ namespace Gamma {
     Gm_InitRendererResources(buffers, shaders, internalResolution);
 
     lightDisc.init();
+    lightClusters.init();
+    meshBatch.init();
+    gpuTimers.init();
 
     // Initialize remaining shaders
     screen.init();
@@ -125,15 +129,31 @@ namespace Gamma {
     Gm_DestroyDrawIndirectBuffer();
 
     lightDisc.destroy();
+    lightClusters.destroy();
+    meshBatch.destroy();
+    gpuTimers.destroy();
+
+    Gm_DestroyGeometryBuffer();
+    Gm_DestroyInstanceBuffer();
 
     glDeleteTextures(1, &screenTexture);
 
-    SDL_GL_DeleteContext(glContext);
+    if (gmContext->window.offscreen) {
+      Gm_DestroyOffscreenContext(offscreenContext);
+    } else {
+      SDL_GL_DeleteContext(glContext);
+    }
   }
 
   void OpenGLRenderer::render() {
+    GM_PROFILE_SCOPE("render");
+
     auto& scene = gmContext->scene;
 
+    // Move stream buffers and GPU timers on to their next frame
+    OpenGLStreamBuffer::advanceFrame();
+    gpuTimers.advanceFrame();
+
     // @todo allow the clouds texture to be changed
     if (gmContext->scene.clouds.size() > 0 && ctx.cloudsTexture == nullptr) {
       ctx.cloudsTexture = new OpenGLTexture(gmContext->scene.clouds, GL_TEXTURE3, false);
@@ -184,6 +204,9 @@ namespace Gamma {
       return;
     }
 
+    stats.shadowCastersSubmitted = 0;
+    stats.shadowCastersCulled = 0;
+
     handleSettingsChanges();
     initializeRendererContext();
     initializeLightArrays();
@@ -351,7 +374,31 @@ namespace Gamma {
     ctx.spotLights.clear();
     ctx.spotShadowcasters.clear();
 
-    for (auto* light : gmContext->scene.lights) {
+    auto& lights = gmContext->scene.lights;
+
+    // Lights may have been moved within the light pool since
+    // the last frame, so re-resolve shadow map lights
+    for (auto* glShadowMap : glDirectionalShadowMaps) {
+      glShadowMap->light = lights.getByHandle(glShadowMap->lightHandle);
+    }
+
+    for (auto* glShadowMap : glPointShadowMaps) {
+      glShadowMap->light = lights.getByHandle(glShadowMap->lightHandle);
+    }
+
+    for (auto* glShadowMap : glSpotShadowMaps) {
+      glShadowMap->light = lights.getByHandle(glShadowMap->lightHandle);
+    }
+
+    for (auto& entry : lights) {
+      auto* light = &entry;
+
+      if (light->power == 0.f && (light->type == LightType::POINT || light->type == LightType::SPOT)) {
+        // Skip inactive lights (shadowcasters are kept to
+        // preserve their correspondence with shadow maps)
+        continue;
+      }
+
       switch (light->type) {
         case LightType::POINT:
           ctx.pointLights.push_back(light);
@@ -394,6 +441,8 @@ namespace Gamma {
    * @todo description
    */
   void OpenGLRenderer::renderToAccumulationBuffer() {
+    GM_PROFILE_SCOPE("renderToAccumulationBuffer");
+
     renderSceneToGBuffer();
 
     if (Gm_IsFlagEnabled(GammaFlags::RENDER_SHADOWS)) {
@@ -421,18 +470,31 @@ namespace Gamma {
       renderDirectionalShadowcasters();
     }
 
-    if (ctx.spotLights.size() > 0) {
-      renderSpotLights();
+    // Light discs are drawn per-light, so skip clustered
+    // lighting when visualizing them
+    bool useClusteredLighting = (
+      Gm_IsFlagEnabled(GammaFlags::RENDER_CLUSTERED_LIGHTING) &&
+      !Gm_IsFlagEnabled(GammaFlags::ENABLE_DEV_LIGHT_DISCS)
+    );
+
+    if (useClusteredLighting) {
+      if (ctx.pointLights.size() > 0 || ctx.spotLights.size() > 0) {
+        renderClusteredLights();
+      }
+    } else {
+      if (ctx.spotLights.size() > 0) {
+        renderSpotLights();
+      }
+
+      if (ctx.pointLights.size() > 0) {
+        renderPointLights();
+      }
     }
 
     if (ctx.spotShadowcasters.size() > 0) {
       renderSpotShadowcasters();
     }
 
-    if (ctx.pointLights.size() > 0) {
-      renderPointLights();
-    }
-
     if (ctx.pointShadowcasters.size() > 0) {
       renderPointShadowcasters();
     }
@@ -482,6 +544,9 @@ namespace Gamma {
    * @todo description
    */
   void OpenGLRenderer::renderSceneToGBuffer() {
+    GM_PROFILE_SCOPE("renderSceneToGBuffer");
+    OpenGLTimerQueries::Scope gpuTimer(gpuTimers, "renderSceneToGBuffer");
+
     buffers.gBuffer.write();
 
     glViewport(0, 0, ctx.internalWidth, ctx.internalHeight);
@@ -534,6 +599,13 @@ namespace Gamma {
       if (glMesh->isMeshType(MeshType::DEFAULT)) {
         auto& mesh = *glMesh->getSourceMesh();
 
+        if (OpenGLMeshBatch::canBatch(mesh) && mesh.texture.empty() && mesh.normals.empty()) {
+          // Draw untextured meshes in a batch below
+          meshBatch.addMesh(glMesh);
+
+          continue;
+        }
+
         shaders.geometry.setBool("hasTexture", glMesh->hasTexture());
         shaders.geometry.setBool("hasNormalMap", glMesh->hasNormalMap());
         shaders.geometry.setBool("useCloseTranslucency", mesh.useCloseTranslucency);
@@ -545,6 +617,16 @@ namespace Gamma {
       }
     }
 
+    // Draw all untextured meshes together, reading
+    // their material parameters per draw
+    shaders.geometry.setBool("hasTexture", false);
+    shaders.geometry.setBool("hasNormalMap", false);
+    shaders.geometry.setBool("useDrawMaterials", true);
+
+    meshBatch.render(ctx.primitiveMode, true);
+
+    shaders.geometry.setBool("useDrawMaterials", false);
+
     // Render preset animated meshes
     shaders.presetAnimation.use();
     shaders.presetAnimation.setMatrix4f("matProjection", ctx.matProjection);
@@ -608,6 +690,9 @@ namespace Gamma {
    * @todo description
    */
   void OpenGLRenderer::renderDirectionalShadowMaps() {
+    GM_PROFILE_SCOPE("renderDirectionalShadowMaps");
+    OpenGLTimerQueries::Scope gpuTimer(gpuTimers, "renderDirectionalShadowMaps");
+
     auto& camera = *ctx.activeCamera;
     auto& shader = shaders.shadowLightView;
 
@@ -617,7 +702,7 @@ namespace Gamma {
 
     for (u32 mapIndex = 0; mapIndex < glDirectionalShadowMaps.size(); mapIndex++) {
       auto& glShadowMap = *glDirectionalShadowMaps[mapIndex];
-      auto& light = *ctx.directionalShadowcasters[mapIndex];
+      auto& light = *glShadowMap.light;
 
       glShadowMap.buffer.write();
 
@@ -629,26 +714,34 @@ namespace Gamma {
 
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // @todo glMultiDrawElementsIndirect for static world geometry
-        // (will require a handful of other changes to mesh organization/data buffering)
         for (auto* glMesh : glMeshes) {
           auto& mesh = *glMesh->getSourceMesh();
 
-          if (mesh.type == MeshType::PARTICLES) {
+          if (mesh.type == MeshType::PARTICLES || !mesh.canCastShadows || mesh.maxCascade < (cascade + 1)) {
             continue;
           }
 
           auto& animation = mesh.animation;
 
+          if (OpenGLMeshBatch::canBatch(mesh) && animation.type == PresetAnimationType::NONE && mesh.texture.empty()) {
+            // Draw static, untextured shadowcasters in a batch below
+            meshBatch.addMesh(glMesh, true);
+
+            continue;
+          }
+
           shader.setInt("animation.type", animation.type);
           shader.setFloat("animation.speed", animation.speed);
           shader.setFloat("animation.factor", animation.factor);
           shader.setBool("hasTexture", glMesh->hasTexture());
 
-          if (mesh.canCastShadows && mesh.maxCascade >= (cascade + 1)) {
-            glMesh->render(ctx.primitiveMode, true);
-          }
+          glMesh->render(ctx.primitiveMode, true);
         }
+
+        shader.setInt("animation.type", PresetAnimationType::NONE);
+        shader.setBool("hasTexture", false);
+
+        meshBatch.render(ctx.primitiveMode);
       }
     }
   }
@@ -657,6 +750,9 @@ namespace Gamma {
    * @todo description
    */
   void OpenGLRenderer::renderSpotShadowMaps() {
+    GM_PROFILE_SCOPE("renderSpotShadowMaps");
+    OpenGLTimerQueries::Scope gpuTimer(gpuTimers, "renderSpotShadowMaps");
+
     auto& shader = shaders.shadowLightView;
 
     shader.use();
@@ -670,33 +766,80 @@ namespace Gamma {
         continue;
       }
 
-      Matrix4f matLightProjection = Matrix4f::glPerspective({ 1024, 1024 }, 120.0f, 1.0f, light.radius);
-      Matrix4f matLightView = Matrix4f::lookAt(light.position.gl(), light.direction.invert().gl(), Vec3f(0.0f, 1.0f, 0.0f));
-      Matrix4f matLightViewProjection = (matLightProjection * matLightView).transpose();
+      Gm_UpdateSpotShadowMapMatrix(glShadowMap);
 
       glShadowMap.buffer.write();
 
       glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-      shader.setMatrix4f("matLightViewProjection", matLightViewProjection);
+      shader.setMatrix4f("matLightViewProjection", glShadowMap.lightMatrix);
+
+      glShadowMap.casterStats = ShadowCasterStats();
 
-      // @todo glMultiDrawElementsIndirect for static world geometry
-      // (will require a handful of other changes to mesh organization/data buffering)
       // @todo allow specific meshes to be associated with spot lights + rendered to shadow maps
       for (auto* glMesh : glMeshes) {
         auto* sourceMesh = glMesh->getSourceMesh();
         auto& animation = sourceMesh->animation;
 
+        if (!sourceMesh->canCastShadows || sourceMesh->disabled) {
+          continue;
+        }
+
+        // Only draw instances which overlap the light cone
+        auto& runs = glShadowMap.casterRuns;
+
+        runs.clear();
+
+        if (sourceMesh->type == MeshType::PARTICLES) {
+          runs.push_back({ 0, sourceMesh->objects.totalVisible() });
+        } else {
+          auto* objects = sourceMesh->objects.begin();
+
+          for (u32 i = 0; i < sourceMesh->objects.totalVisible(); i++) {
+            auto& object = objects[i];
+            float radius = Gm_GetObjectBoundingRadius(*sourceMesh, object);
+
+            if (radius == 0.f || !Gm_IsSphereWithinLightCone(light, object.position, radius)) {
+              glShadowMap.casterStats.culled++;
+
+              continue;
+            }
+
+            if (runs.size() > 0 && runs.back().offset + runs.back().count == i) {
+              runs.back().count++;
+            } else {
+              runs.push_back({ i, 1 });
+            }
+          }
+        }
+
+        for (auto& run : runs) {
+          glShadowMap.casterStats.submitted += run.count;
+        }
+
+        if (OpenGLMeshBatch::canBatch(*sourceMesh) && animation.type == PresetAnimationType::NONE && sourceMesh->texture.empty()) {
+          // Draw static, untextured shadowcasters in a batch below
+          meshBatch.addInstanceRuns(glMesh, runs.data(), runs.size(), true);
+
+          continue;
+        }
+
         shader.setInt("animation.type", animation.type);
         shader.setFloat("animation.speed", animation.speed);
         shader.setFloat("animation.factor", animation.factor);
         shader.setBool("hasTexture", glMesh->hasTexture());
 
-        if (sourceMesh->canCastShadows) {
-          glMesh->render(ctx.primitiveMode, true);
-        }
+        glMesh->renderInstanceRuns(ctx.primitiveMode, runs.data(), runs.size(), true);
       }
 
+      shader.setInt("animation.type", PresetAnimationType::NONE);
+      shader.setBool("hasTexture", false);
+
+      meshBatch.render(ctx.primitiveMode);
+
+      stats.shadowCastersSubmitted += glShadowMap.casterStats.submitted;
+      stats.shadowCastersCulled += glShadowMap.casterStats.culled;
+
       glShadowMap.isRendered = true;
     }
   }
@@ -705,54 +848,148 @@ namespace Gamma {
    * @todo description
    */
   void OpenGLRenderer::renderPointShadowMaps() {
+    GM_PROFILE_SCOPE("renderPointShadowMaps");
+    OpenGLTimerQueries::Scope gpuTimer(gpuTimers, "renderPointShadowMaps");
+
     auto& shader = shaders.pointShadowcasterView;
+    GLint batchFaceMasks[MAX_RUNS_PER_DRAW];
+    GLint faceMasks[MAX_RUNS_PER_DRAW];
 
     shader.use();
 
+    // Face masks are uploaded as a whole array once per draw
+    GLint faceMasksLocation = shader.getUniformLocation("faceMasks");
+
     for (u32 mapIndex = 0; mapIndex < glPointShadowMaps.size(); mapIndex++) {
       auto& glShadowMap = *glPointShadowMaps[mapIndex];
-      auto& light = *ctx.pointShadowcasters[mapIndex];
+      auto& light = *glShadowMap.light;
 
       if (light.isStatic && glShadowMap.isRendered) {
         continue;
       }
 
+      Gm_UpdatePointShadowMapMatrices(glShadowMap);
+
       glShadowMap.buffer.write();
 
       glClear(GL_DEPTH_BUFFER_BIT);
 
       for (u32 i = 0; i < 6; i++) {
-        auto& direction = CUBE_MAP_DIRECTIONS[i];
-        auto& upDirection = CUBE_MAP_UP_DIRECTIONS[i];
-
-        // @optimize matLightProjection can be precomputed
-        Matrix4f matLightProjection = Matrix4f::glPerspective({ 1024, 1024 }, 90.f, 1.f, light.radius);
-        Matrix4f matLightView = Matrix4f::lookAt(light.position.gl(), direction, upDirection);
-        Matrix4f lightMatrix = (matLightProjection * matLightView).transpose();
-
-        shader.setMatrix4f("lightMatrices[" + std::to_string(i) + "]", lightMatrix);
+        shader.setMatrix4f("lightMatrices[" + std::to_string(i) + "]", glShadowMap.lightMatrices[i]);
       }
 
       shader.setVec3f("lightPosition", light.position.gl());
       shader.setFloat("farPlane", light.radius);
 
-      // @todo glMultiDrawElementsIndirect for static world geometry
-      // (will require a handful of other changes to mesh organization/data buffering)
+      glShadowMap.casterStats = ShadowCasterStats();
+
       // @todo allow specific meshes to be associated with point lights + rendered to shadow maps
       for (auto* glMesh : glMeshes) {
         auto* sourceMesh = glMesh->getSourceMesh();
 
         // @todo handle foliage (requires point shadowcaster view shader updates)
 
-        if (sourceMesh->canCastShadows) {
-          glMesh->render(ctx.primitiveMode, true);
+        if (!sourceMesh->canCastShadows || sourceMesh->disabled) {
+          continue;
+        }
+
+        // Only draw instances within the light radius, and only
+        // to the cube map faces they overlap. Contiguous instances
+        // sharing the same faces are drawn together.
+        auto& runs = glShadowMap.casterRuns;
+
+        runs.clear();
+
+        if (sourceMesh->type == MeshType::PARTICLES) {
+          runs.push_back({ 0, sourceMesh->objects.totalVisible() });
+        } else {
+          auto* objects = sourceMesh->objects.begin();
+
+          for (u32 i = 0; i < sourceMesh->objects.totalVisible(); i++) {
+            auto& object = objects[i];
+            float radius = Gm_GetObjectBoundingRadius(*sourceMesh, object);
+            u8 mask = 0;
+
+            if (radius > 0.f && Gm_IsSphereWithinLightRadius(light, object.position, radius)) {
+              mask = Gm_GetCubeFaceMask(light.position, object.position, radius);
+            }
+
+            if (mask == 0) {
+              glShadowMap.casterStats.culled++;
+
+              continue;
+            }
+
+            auto* lastRun = runs.size() > 0 ? &runs.back() : nullptr;
+
+            if (lastRun != nullptr && lastRun->offset + lastRun->count == i && lastRun->mask == mask) {
+              lastRun->count++;
+            } else {
+              runs.push_back({ i, 1, mask });
+            }
+          }
+        }
+
+        for (auto& run : runs) {
+          glShadowMap.casterStats.submitted += run.count;
+        }
+
+        if (OpenGLMeshBatch::canBatch(*sourceMesh)) {
+          // Add runs to the shared mesh batch, drawing it
+          // whenever it fills the face mask uniform array
+          for (auto& run : runs) {
+            if (meshBatch.getTotalCommands() == MAX_RUNS_PER_DRAW) {
+              renderPointShadowBatch(faceMasksLocation, batchFaceMasks);
+            }
+
+            batchFaceMasks[meshBatch.getTotalCommands()] = run.mask;
+
+            meshBatch.addInstanceRuns(glMesh, &run, 1, true);
+          }
+
+          continue;
+        }
+
+        // Draw runs in batches matching the size
+        // of the shader's face mask uniform array
+        for (u32 start = 0; start < runs.size(); start += MAX_RUNS_PER_DRAW) {
+          u32 total = std::min(MAX_RUNS_PER_DRAW, (u32)runs.size() - start);
+
+          for (u32 i = 0; i < total; i++) {
+            faceMasks[i] = runs[start + i].mask;
+          }
+
+          shader.setIntArray(faceMasksLocation, faceMasks, total);
+
+          glMesh->renderInstanceRuns(ctx.primitiveMode, runs.data() + start, total, true);
         }
       }
 
+      renderPointShadowBatch(faceMasksLocation, batchFaceMasks);
+
+      stats.shadowCastersSubmitted += glShadowMap.casterStats.submitted;
+      stats.shadowCastersCulled += glShadowMap.casterStats.culled;
+
       glShadowMap.isRendered = true;
     }
   }
 
+  /**
+   * Draws all point shadowcaster runs added to the mesh batch,
+   * setting the cube map face mask for each run beforehand.
+   */
+  void OpenGLRenderer::renderPointShadowBatch(GLint faceMasksLocation, const GLint* faceMasks) {
+    GM_PROFILE_SCOPE("renderPointShadowBatch");
+
+    if (meshBatch.getTotalCommands() == 0) {
+      return;
+    }
+
+    shaders.pointShadowcasterView.setIntArray(faceMasksLocation, faceMasks, meshBatch.getTotalCommands());
+
+    meshBatch.render(ctx.primitiveMode);
+  }
+
   /**
    * @todo description
    */
@@ -776,6 +1013,9 @@ namespace Gamma {
    * information from the G-Buffer to the accumulation buffer.
    */
   void OpenGLRenderer::renderLightingPrepass() {
+    GM_PROFILE_SCOPE("renderLightingPrepass");
+    OpenGLTimerQueries::Scope gpuTimer(gpuTimers, "renderLightingPrepass");
+
     auto& shader = shaders.lightingPrepass;
     auto& scene = gmContext->scene;
 
@@ -799,6 +1039,9 @@ namespace Gamma {
    * @todo description
    */
   void OpenGLRenderer::renderDirectionalLights() {
+    GM_PROFILE_SCOPE("renderDirectionalLights");
+    OpenGLTimerQueries::Scope gpuTimer(gpuTimers, "renderDirectionalLights");
+
     auto& camera = *ctx.activeCamera;
     auto& shader = shaders.directionalLight;
 
@@ -827,6 +1070,9 @@ namespace Gamma {
    * @todo description
    */
   void OpenGLRenderer::renderDirectionalShadowcasters() {
+    GM_PROFILE_SCOPE("renderDirectionalShadowcasters");
+    OpenGLTimerQueries::Scope gpuTimer(gpuTimers, "renderDirectionalShadowcasters");
+
     auto& camera = *ctx.activeCamera;
     auto& shader = shaders.directionalShadowcaster;
 
@@ -834,7 +1080,7 @@ namespace Gamma {
     shader.setFloat("zNear", gmContext->scene.zNear);
     shader.setFloat("zFar", gmContext->scene.zFar);
 
-    for (u32 i = 0; i < ctx.directionalShadowcasters.size(); i++) {
+    for (u32 i = 0; i < glDirectionalShadowMaps.size(); i++) {
       auto& glShadowMap = *glDirectionalShadowMaps[i];
       auto& light = *glShadowMap.light;
 
@@ -865,6 +1111,9 @@ namespace Gamma {
    * @todo description
    */
   void OpenGLRenderer::renderSpotLights() {
+    GM_PROFILE_SCOPE("renderSpotLights");
+    OpenGLTimerQueries::Scope gpuTimer(gpuTimers, "renderSpotLights");
+
     auto& camera = *ctx.activeCamera;
     auto& shader = shaders.spotLight;
 
@@ -882,6 +1131,9 @@ namespace Gamma {
    * @todo description
    */
   void OpenGLRenderer::renderSpotShadowcasters() {
+    GM_PROFILE_SCOPE("renderSpotShadowcasters");
+    OpenGLTimerQueries::Scope gpuTimer(gpuTimers, "renderSpotShadowcasters");
+
     auto& camera = *ctx.activeCamera;
     auto& shader = shaders.spotShadowcaster;
 
@@ -898,11 +1150,9 @@ namespace Gamma {
       auto& glShadowMap = *glSpotShadowMaps[i];
       auto& light = *glShadowMap.light;
 
-      Matrix4f lightProjection = Matrix4f::glPerspective({ 1024, 1024 }, 120.0f, 1.0f, light.radius);
-      Matrix4f lightView = Matrix4f::lookAt(light.position.gl(), light.direction.invert().gl(), Vec3f(0.0f, 1.0f, 0.0f));
-      Matrix4f lightMatrix = (lightProjection * lightView).transpose();
+      Gm_UpdateSpotShadowMapMatrix(glShadowMap);
 
-      shader.setMatrix4f("lightMatrix", lightMatrix);
+      shader.setMatrix4f("lightMatrix", glShadowMap.lightMatrix);
 
       glShadowMap.buffer.read();
       lightDisc.draw(light, internalResolution, *ctx.activeCamera);
@@ -913,6 +1163,9 @@ namespace Gamma {
    * @todo description
    */
   void OpenGLRenderer::renderPointLights() {
+    GM_PROFILE_SCOPE("renderPointLights");
+    OpenGLTimerQueries::Scope gpuTimer(gpuTimers, "renderPointLights");
+
     auto& camera = *ctx.activeCamera;
     auto& shader = shaders.pointLight;
 
@@ -930,6 +1183,9 @@ namespace Gamma {
    * @todo description
    */
   void OpenGLRenderer::renderPointShadowcasters() {
+    GM_PROFILE_SCOPE("renderPointShadowcasters");
+    OpenGLTimerQueries::Scope gpuTimer(gpuTimers, "renderPointShadowcasters");
+
     auto& camera = *ctx.activeCamera;
     auto& shader = shaders.pointShadowcaster;
 
@@ -950,6 +1206,45 @@ namespace Gamma {
     }
   }
 
+  /**
+   * Renders all non-shadowcasting point and spot lights in a
+   * single full-screen pass. Lights are binned into clusters
+   * over the view frustum on the CPU, and each fragment is
+   * only shaded by the lights in its cluster.
+   */
+  void OpenGLRenderer::renderClusteredLights() {
+    GM_PROFILE_SCOPE("renderClusteredLights");
+    OpenGLTimerQueries::Scope gpuTimer(gpuTimers, "renderClusteredLights");
+
+    auto& camera = *ctx.activeCamera;
+    auto& shader = shaders.clusteredLights;
+
+    ctx.clusteredLights.clear();
+    ctx.clusteredLights.insert(ctx.clusteredLights.end(), ctx.pointLights.begin(), ctx.pointLights.end());
+    ctx.clusteredLights.insert(ctx.clusteredLights.end(), ctx.spotLights.begin(), ctx.spotLights.end());
+
+    lightClusters.update(ctx.clusteredLights, internalResolution, camera);
+
+    auto& clusters = lightClusters.getClusters();
+    Matrix4f matView = Gm_GetCameraViewMatrix(camera);
+
+    shader.use();
+    shader.setVec4f("transform", FULL_SCREEN_TRANSFORM);
+    shader.setInt("texColorAndDepth", 0);
+    shader.setInt("texNormalAndMaterial", 1);
+    shader.setVec3f("cameraPosition", camera.position);
+    shader.setMatrix4f("matInverseProjection", ctx.matInverseProjection);
+    shader.setMatrix4f("matInverseView", ctx.matInverseView);
+    shader.setVec3f("clusterGrid", Vec3f((float)clusters.width, (float)clusters.height, (float)clusters.depth));
+    shader.setVec4f("clusterDepthRow", Vec4f(matView.m[8], matView.m[9], matView.m[10], matView.m[11]));
+    shader.setFloat("clusterNear", clusters.near);
+    shader.setFloat("clusterSliceScale", (float)clusters.depth / logf(clusters.far / clusters.near));
+
+    lightClusters.bind();
+
+    OpenGLScreenQuad::render();
+  }
+
   /**
    * @todo description
    */
@@ -975,6 +1270,9 @@ namespace Gamma {
    * @todo description
    */
   void OpenGLRenderer::renderIndirectLight() {
+    GM_PROFILE_SCOPE("renderIndirectLight");
+    OpenGLTimerQueries::Scope gpuTimer(gpuTimers, "renderIndirectLight");
+
     auto& currentIndirectLightBuffer = buffers.indirectLight[frame % 2];
     auto& previousIndirectLightBuffer = buffers.indirectLight[(frame + 1) % 2];
 
@@ -1056,6 +1354,9 @@ namespace Gamma {
    * @todo description
    */
   void OpenGLRenderer::renderSkybox() {
+    GM_PROFILE_SCOPE("renderSkybox");
+    OpenGLTimerQueries::Scope gpuTimer(gpuTimers, "renderSkybox");
+
     glStencilFunc(GL_EQUAL, MeshType::SKYBOX, 0xFF);
 
     auto& scene = gmContext->scene;
@@ -1083,6 +1384,9 @@ namespace Gamma {
    * @todo description
    */
   void OpenGLRenderer::renderParticles() {
+    GM_PROFILE_SCOPE("renderParticles");
+    OpenGLTimerQueries::Scope gpuTimer(gpuTimers, "renderParticles");
+
     glEnable(GL_BLEND);
     glEnable(GL_DEPTH_TEST);
     glDepthMask(GL_FALSE);
@@ -1160,6 +1464,9 @@ namespace Gamma {
    * @todo description
    */
   void OpenGLRenderer::renderReflections() {
+    GM_PROFILE_SCOPE("renderReflections");
+    OpenGLTimerQueries::Scope gpuTimer(gpuTimers, "renderReflections");
+
     if (
       ctx.hasRefractiveObjects &&
       Gm_IsFlagEnabled(GammaFlags::RENDER_REFRACTIVE_GEOMETRY) &&
@@ -1242,6 +1549,9 @@ namespace Gamma {
    * @todo description
    */
   void OpenGLRenderer::renderRefractiveGeometry() {
+    GM_PROFILE_SCOPE("renderRefractiveGeometry");
+    OpenGLTimerQueries::Scope gpuTimer(gpuTimers, "renderRefractiveGeometry");
+
     auto& camera = *ctx.activeCamera;
     auto& scene = gmContext->scene;
 
@@ -1318,6 +1628,9 @@ namespace Gamma {
    * @todo description
    */
   void OpenGLRenderer::renderWater() {
+    GM_PROFILE_SCOPE("renderWater");
+    OpenGLTimerQueries::Scope gpuTimer(gpuTimers, "renderWater");
+
     auto& camera = *ctx.activeCamera;
     auto& scene = gmContext->scene;
 
@@ -1396,6 +1709,9 @@ namespace Gamma {
   }
 
   void OpenGLRenderer::renderSilhouettes() {
+    GM_PROFILE_SCOPE("renderSilhouettes");
+    OpenGLTimerQueries::Scope gpuTimer(gpuTimers, "renderSilhouettes");
+
     glEnable(GL_CULL_FACE);
     glEnable(GL_DEPTH_TEST);
     glDisable(GL_STENCIL_TEST);
@@ -1423,6 +1739,9 @@ namespace Gamma {
    * @todo description
    */
   void OpenGLRenderer::renderPostEffects() {
+    GM_PROFILE_SCOPE("renderPostEffects");
+    OpenGLTimerQueries::Scope gpuTimer(gpuTimers, "renderPostEffects");
+
     buffers.gBuffer.read();
     ctx.accumulationSource->read();
 
@@ -1469,6 +1788,8 @@ namespace Gamma {
    * @todo description
    */
   void OpenGLRenderer::renderDevBuffers() {
+    GM_PROFILE_SCOPE("renderDevBuffers");
+
     buffers.gBuffer.read();
 
     shaders.gBufferDev.use();
@@ -1545,7 +1866,7 @@ namespace Gamma {
   void OpenGLRenderer::destroyShadowMap(Light* light) {
     #define clear_light_from(shadowMaps, light) \
       for (auto& shadowMap : shadowMaps) {\
-        if (shadowMap->light == light) {\
+        if (shadowMap->lightHandle.id == light->_handle.id) {\
           shadowMap->buffer.destroy();\
           Gm_VectorRemove(shadowMaps, shadowMap);\
           break;\
@@ -1584,21 +1905,43 @@ namespace Gamma {
   const RenderStats& OpenGLRenderer::getRenderStats() {
     GLint total = 0;
     GLint available = 0;
-    const char* vendor = (const char*)glGetString(GL_VENDOR);
 
-    if (strcmp(vendor, "NVIDIA Corporation") == 0) {
+    if (GLEW_NVX_gpu_memory_info) {
       glGetIntegerv(GL_GPU_MEMORY_INFO_TOTAL_AVAILABLE_MEMORY_NVX, &total);
       glGetIntegerv(GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, &available);
     }
 
-    stats.gpuMemoryTotal = total / 1000;
-    stats.gpuMemoryUsed = (total - available) / 1000;
+    if (total > 0) {
+      stats.gpuMemoryTotal = total / 1000;
+      stats.gpuMemoryUsed = (total - available) / 1000;
+    } else {
+      // Without driver-reported memory, fall back to
+      // the engine's own estimate
+      u64 trackedBytes = 0;
+
+      for (u32 i = 0; i < TOTAL_MEMORY_CATEGORIES; i++) {
+        if (Gm_IsGpuMemoryCategory((MemoryCategory)i)) {
+          trackedBytes += Gm_GetTrackedMemory((MemoryCategory)i);
+        }
+      }
+
+      stats.gpuMemoryTotal = 0;
+      stats.gpuMemoryUsed = u32(trackedBytes / (1024 * 1024));
+    }
     stats.isVSynced = SDL_GL_GetSwapInterval() == 1;
+    stats.passTimes = gpuTimers.getPassTimes();
 
     return stats;
   }
 
   void OpenGLRenderer::present() {
+    GM_PROFILE_SCOPE("present");
+
+    // Offscreen frames stay in the offscreen surface
+    if (gmContext->window.offscreen) {
+      return;
+    }
+
     SDL_GL_SwapWindow(gmContext->window.sdl_window);
   }
 
@@ -1661,6 +2004,8 @@ namespace Gamma {
   }
 
   void OpenGLRenderer::renderSurface(SDL_Surface* surface, u32 x, u32 y, u32 w, u32 h, const Vec3f& color, const Vec4f& background) {
+    GM_PROFILE_SCOPE("renderSurface");
+
     auto& window = gmContext->window;
     float offsetX = -1.0f + (2 * x + w) / (float)window.size.width;
     float offsetY = 1.0f - (2 * y + h) / (float)window.size.height;
@@ -1686,6 +2031,8 @@ namespace Gamma {
   }
 
   void OpenGLRenderer::renderText(TTF_Font* font, const char* message, u32 x, u32 y, const Vec3f& color, const Vec4f& background) {
+    GM_PROFILE_SCOPE("renderText");
+
     SDL_Surface* text = TTF_RenderText_Blended_Wrapped(font, message, { 255, 255, 255 }, gmContext->window.size.width);
 
     // @todo support scaling
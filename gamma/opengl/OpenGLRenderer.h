@@ -7,9 +7,13 @@
 
 #include "math/vector.h"
 #include "opengl/framebuffer.h"
+#include "opengl/offscreen_context.h"
+#include "opengl/OpenGLLightClusters.h"
 #include "opengl/OpenGLLightDisc.h"
 #include "opengl/OpenGLMesh.h"
+#include "opengl/OpenGLMeshBatch.h"
 #include "opengl/OpenGLTexture.h"
+#include "opengl/OpenGLTimerQueries.h"
 #include "opengl/shader.h"
 #include "opengl/shadowmaps.h"
 #include "system/AbstractRenderer.h"
@@ -36,6 +40,7 @@ namespace Gamma {
     OpenGLShader directionalLight;
     OpenGLShader spotLight;
     OpenGLShader pointLight;
+    OpenGLShader clusteredLights;
     OpenGLShader indirectLight;
     OpenGLShader indirectLightComposite;
     OpenGLShader skybox;
@@ -75,6 +80,7 @@ namespace Gamma {
     std::vector<Light*> directionalShadowcasters;
     std::vector<Light*> spotLights;
     std::vector<Light*> spotShadowcasters;
+    std::vector<Light*> clusteredLights;
     OpenGLTexture* cloudsTexture = nullptr;
     Camera* activeCamera = nullptr;
     Matrix4f matProjection;
@@ -108,10 +114,14 @@ namespace Gamma {
 
   private:
     SDL_GLContext glContext;
+    OffscreenContext offscreenContext;
     RendererBuffers buffers;
     RendererShaders shaders;
     RendererContext ctx;
     OpenGLLightDisc lightDisc;
+    OpenGLLightClusters lightClusters;
+    OpenGLMeshBatch meshBatch;
+    OpenGLTimerQueries gpuTimers;
     OpenGLShader screen;
     GLuint screenTexture = 0;
     u32 frame = 0;
@@ -127,6 +137,7 @@ namespace Gamma {
     void renderDirectionalShadowMaps();
     void renderPointShadowMaps();
     void renderSpotShadowMaps();
+    void renderPointShadowBatch(GLint faceMasksLocation, const GLint* faceMasks);
     void prepareLightingPass();
     void renderLightingPrepass();
     void renderDirectionalLights();
@@ -135,6 +146,7 @@ namespace Gamma {
     void renderSpotShadowcasters();
     void renderPointLights();
     void renderPointShadowcasters();
+    void renderClusteredLights();
     void copyEmissiveObjects();
     void renderIndirectLight();
     void renderSkybox();
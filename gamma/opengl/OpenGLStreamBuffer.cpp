@@ -0,0 +1,252 @@
+#include <algorithm>
+#include <cstring>
+
+#include "opengl/OpenGLStreamBuffer.h"
+#include "system/assert.h"
+
+#include "glew.h"
+
+namespace Gamma {
+  constexpr static GLbitfield PERSISTENT_MAP_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+  static u32 streamFrame = 0;
+
+  /**
+   * Gm_WaitForFence
+   * ---------------
+   */
+  static void Gm_WaitForFence(GLsync& fence) {
+    if (fence == nullptr) {
+      return;
+    }
+
+    while (true) {
+      GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+
+      if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED) {
+        break;
+      }
+    }
+
+    glDeleteSync(fence);
+
+    fence = nullptr;
+  }
+
+  /**
+   * Signals the start of a new frame. Each stream buffer
+   * moves on to its next region when it is next used.
+   */
+  void OpenGLStreamBuffer::advanceFrame() {
+    streamFrame++;
+  }
+
+  bool OpenGLStreamBuffer::isPersistentMappingSupported() {
+    return GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+  }
+
+  void OpenGLStreamBuffer::init(u32 regionSize, MemoryCategory category) {
+    frame = streamFrame;
+    memoryCategory = category;
+
+    createBuffer(regionSize);
+  }
+
+  void OpenGLStreamBuffer::destroy() {
+    for (auto& fence : fences) {
+      if (fence != nullptr) {
+        glDeleteSync(fence);
+
+        fence = nullptr;
+      }
+    }
+
+    if (mappedBuffer != nullptr) {
+      glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+      glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+
+      mappedBuffer = nullptr;
+    }
+
+    if (buffer != 0) {
+      Gm_TrackMemory(memoryCategory, -(s64)regionSize * STREAM_BUFFER_REGIONS);
+    }
+
+    glDeleteBuffers(1, &buffer);
+
+    buffer = 0;
+  }
+
+  /**
+   * Appends data to the current region, growing the buffer if
+   * the region is full. Returns the offset of the data from
+   * the start of the buffer, for use as an attribute, indirect
+   * command or storage buffer offset.
+   */
+  u32 OpenGLStreamBuffer::append(const void* data, u32 size, u32 alignment) {
+    sync();
+
+    u32 offset = (cursor + alignment - 1) / alignment * alignment;
+
+    if (offset + size > regionSize) {
+      // Keep region offsets aligned as well
+      u32 grownSize = std::max(regionSize * 2, offset + size);
+
+      resize((grownSize + alignment - 1) / alignment * alignment);
+    }
+
+    write(offset, data, size);
+
+    cursor = offset + size;
+
+    return getRegionOffset() + offset;
+  }
+
+  /**
+   * Creates the buffer store for all regions. Any previous
+   * buffer is left for the caller to copy from and delete.
+   */
+  void OpenGLStreamBuffer::createBuffer(u32 size) {
+    u32 totalSize = size * STREAM_BUFFER_REGIONS;
+
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+
+    if (isPersistentMappingSupported()) {
+      glBufferStorage(GL_COPY_WRITE_BUFFER, totalSize, nullptr, PERSISTENT_MAP_FLAGS);
+
+      mappedBuffer = (u8*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, totalSize, PERSISTENT_MAP_FLAGS);
+    } else {
+      glBufferData(GL_COPY_WRITE_BUFFER, totalSize, nullptr, GL_STREAM_DRAW);
+
+      mappedBuffer = nullptr;
+    }
+
+    regionSize = size;
+    version++;
+
+    Gm_TrackMemory(memoryCategory, (s64)totalSize);
+  }
+
+  GLuint OpenGLStreamBuffer::getBuffer() {
+    sync();
+
+    return buffer;
+  }
+
+  u32 OpenGLStreamBuffer::getRegionIndex() {
+    sync();
+
+    return region;
+  }
+
+  u32 OpenGLStreamBuffer::getRegionOffset() {
+    sync();
+
+    return region * regionSize;
+  }
+
+  u32 OpenGLStreamBuffer::getRegionSize() const {
+    return regionSize;
+  }
+
+  /**
+   * Returns a counter incremented whenever the buffer is
+   * reallocated, e.g. so VAOs can redefine attributes
+   * sourced from the buffer.
+   */
+  u32 OpenGLStreamBuffer::getVersion() const {
+    return version;
+  }
+
+  /**
+   * Reallocates the buffer with a new region size, copying
+   * over the existing contents of each region.
+   */
+  void OpenGLStreamBuffer::resize(u32 size) {
+    sync();
+
+    GLuint previousBuffer = buffer;
+    u8* previousMappedBuffer = mappedBuffer;
+    u32 previousRegionSize = regionSize;
+    u32 copySize = std::min(previousRegionSize, size);
+
+    createBuffer(size);
+
+    glBindBuffer(GL_COPY_READ_BUFFER, previousBuffer);
+
+    for (u32 i = 0; i < STREAM_BUFFER_REGIONS; i++) {
+      glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, i * previousRegionSize, i * size, copySize);
+    }
+
+    if (previousMappedBuffer != nullptr) {
+      glUnmapBuffer(GL_COPY_READ_BUFFER);
+    }
+
+    glDeleteBuffers(1, &previousBuffer);
+
+    Gm_TrackMemory(memoryCategory, -(s64)previousRegionSize * STREAM_BUFFER_REGIONS);
+
+    // Outstanding fences refer to the previous buffer
+    for (auto& fence : fences) {
+      if (fence != nullptr) {
+        glDeleteSync(fence);
+
+        fence = nullptr;
+      }
+    }
+
+    if (mappedBuffer != nullptr) {
+      // Make sure the copies have finished before writing
+      // to the new buffer from the CPU, so they don't
+      // overwrite newer data
+      GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+      Gm_WaitForFence(fence);
+    }
+  }
+
+  /**
+   * Advances to the next region if a new frame has started,
+   * fencing the previous region and waiting for the GPU to
+   * finish reading the next one.
+   */
+  void OpenGLStreamBuffer::sync() {
+    if (frame == streamFrame) {
+      return;
+    }
+
+    frame = streamFrame;
+    cursor = 0;
+
+    if (mappedBuffer != nullptr) {
+      fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    region = (region + 1) % STREAM_BUFFER_REGIONS;
+
+    Gm_WaitForFence(fences[region]);
+  }
+
+  /**
+   * Writes data at an offset within the current region.
+   */
+  void OpenGLStreamBuffer::write(u32 offset, const void* data, u32 size) {
+    sync();
+
+    if (size == 0) {
+      return;
+    }
+
+    assert(offset + size <= regionSize, "Stream buffer write out of range");
+
+    u32 bufferOffset = region * regionSize + offset;
+
+    if (mappedBuffer != nullptr) {
+      memcpy(mappedBuffer + bufferOffset, data, size);
+    } else {
+      glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+      glBufferSubData(GL_COPY_WRITE_BUFFER, bufferOffset, size, data);
+    }
+  }
+}
\ No newline at end of file
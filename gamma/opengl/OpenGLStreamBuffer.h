@@ -0,0 +1,58 @@
+#pragma once
+
+#include "performance/memory.h"
+#include "system/type_aliases.h"
+
+namespace Gamma {
+  constexpr static u32 STREAM_BUFFER_REGIONS = 3;
+
+  /**
+   * OpenGLStreamBuffer
+   * ------------------
+   *
+   * A buffer for data rewritten every frame, split into
+   * STREAM_BUFFER_REGIONS frame regions. Each frame writes
+   * into its own region while the GPU may still be reading
+   * the regions of the previous frames, so writes never
+   * stall on or orphan storage in use.
+   *
+   * Where buffer storage is supported, the buffer is mapped
+   * persistently and written to directly, with a fence per
+   * region to make sure the GPU is finished with a region
+   * before it is reused. Otherwise, regions are written with
+   * glBufferSubData.
+   *
+   * Regions advance lazily, on the first use of a buffer
+   * after each call to OpenGLStreamBuffer::advanceFrame().
+   */
+  class OpenGLStreamBuffer {
+  public:
+    static void advanceFrame();
+    static bool isPersistentMappingSupported();
+
+    void init(u32 regionSize, MemoryCategory category = MemoryCategory::GPU_STREAM_BUFFERS);
+    void destroy();
+    u32 append(const void* data, u32 size, u32 alignment = 1);
+    GLuint getBuffer();
+    u32 getRegionIndex();
+    u32 getRegionOffset();
+    u32 getRegionSize() const;
+    u32 getVersion() const;
+    void resize(u32 regionSize);
+    void write(u32 offset, const void* data, u32 size);
+
+  private:
+    GLuint buffer = 0;
+    u8* mappedBuffer = nullptr;
+    GLsync fences[STREAM_BUFFER_REGIONS] = { nullptr, nullptr, nullptr };
+    u32 regionSize = 0;
+    u32 region = 0;
+    u32 cursor = 0;
+    u32 frame = 0;
+    u32 version = 0;
+    MemoryCategory memoryCategory = MemoryCategory::GPU_STREAM_BUFFERS;
+
+    void createBuffer(u32 regionSize);
+    void sync();
+  };
+}
\ No newline at end of file
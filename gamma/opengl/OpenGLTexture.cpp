@@ -4,6 +4,7 @@
 #include "SDL_image.h"
 
 #include "opengl/OpenGLTexture.h"
+#include "performance/memory.h"
 #include "system/assert.h"
 #include "system/flags.h"
 
@@ -23,6 +24,7 @@ namespace Gamma {
     #if GAMMA_DEVELOPER_MODE == 1
       Gm_WatchFile(path.c_str(), [=]() {
         glDeleteTextures(1, &id);
+        untrackMemory();
         initialize(enableMipmaps);
 
         Console::log("[Gamma] Hot-reloaded texture:", path);
@@ -32,6 +34,7 @@ namespace Gamma {
 
   OpenGLTexture::~OpenGLTexture() {
     glDeleteTextures(1, &id);
+    untrackMemory();
   }
 
   void OpenGLTexture::bind() {
@@ -60,6 +63,16 @@ namespace Gamma {
 
     glTexImage2D(GL_TEXTURE_2D, 0, format, surface->w, surface->h, 0, format, GL_UNSIGNED_BYTE, surface->pixels);
 
+    // Drivers typically pad RGB textures to 4 bytes per texel,
+    // and a full mipmap chain adds another third
+    memory = surface->w * surface->h * 4;
+
+    if (enableMipmaps) {
+      memory += memory / 3;
+    }
+
+    Gm_TrackMemory(MemoryCategory::GPU_TEXTURES, memory);
+
     if (enableMipmaps) {
       glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
       glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -75,4 +88,10 @@ namespace Gamma {
   const std::string& OpenGLTexture::getPath() const {
     return path;
   }
+
+  void OpenGLTexture::untrackMemory() {
+    Gm_TrackMemory(MemoryCategory::GPU_TEXTURES, -(s64)memory);
+
+    memory = 0;
+  }
 }
\ No newline at end of file
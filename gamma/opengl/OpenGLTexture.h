@@ -17,7 +17,9 @@ namespace Gamma {
     GLuint id;
     GLenum unit;
     std::string path;
+    u32 memory = 0;
 
     void initialize(bool enableMipmaps);
+    void untrackMemory();
   };
 }
\ No newline at end of file
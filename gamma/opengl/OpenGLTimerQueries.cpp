@@ -0,0 +1,125 @@
+#include <cstring>
+
+#include "opengl/OpenGLTimerQueries.h"
+
+#include "glew.h"
+
+namespace Gamma {
+  void OpenGLTimerQueries::init() {
+    frameIndex = 0;
+    depth = 0;
+    isRecording = true;
+  }
+
+  void OpenGLTimerQueries::destroy() {
+    for (auto& frame : frames) {
+      for (auto& timer : frame.queries) {
+        glDeleteQueries(1, &timer.query);
+      }
+
+      frame.queries.clear();
+      frame.total = 0;
+    }
+
+    passTimes.clear();
+  }
+
+  /**
+   * Moves on to the next frame's set of queries, first
+   * reading back its results from TIMER_QUERY_FRAMES - 1
+   * frames ago if they are available.
+   */
+  void OpenGLTimerQueries::advanceFrame() {
+    frameIndex = (frameIndex + 1) % TIMER_QUERY_FRAMES;
+    depth = 0;
+
+    auto& frame = frames[frameIndex];
+
+    if (frame.total > 0) {
+      // Queries complete in order, so the last query
+      // being available means all of them are
+      GLint isAvailable = 0;
+
+      glGetQueryObjectiv(frame.queries[frame.total - 1].query, GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+
+      if (!isAvailable) {
+        isRecording = false;
+
+        return;
+      }
+
+      readFrame(frame);
+    }
+
+    isRecording = true;
+  }
+
+  void OpenGLTimerQueries::begin(const char* name) {
+    if (depth++ > 0 || !isRecording) {
+      return;
+    }
+
+    auto& frame = frames[frameIndex];
+
+    if (frame.total == frame.queries.size()) {
+      auto& timer = frame.queries.emplace_back();
+
+      glGenQueries(1, &timer.query);
+    }
+
+    auto& timer = frame.queries[frame.total];
+
+    timer.name = name;
+
+    glBeginQuery(GL_TIME_ELAPSED, timer.query);
+  }
+
+  void OpenGLTimerQueries::end() {
+    if (depth == 0 || --depth > 0 || !isRecording) {
+      return;
+    }
+
+    glEndQuery(GL_TIME_ELAPSED);
+
+    frames[frameIndex].total++;
+  }
+
+  /**
+   * Returns the GPU time of each pass in the most recently
+   * read back frame, in the order the passes first ran.
+   * Passes run several times in a frame are summed.
+   */
+  const std::vector<RenderPassTime>& OpenGLTimerQueries::getPassTimes() const {
+    return passTimes;
+  }
+
+  void OpenGLTimerQueries::readFrame(FrameQueries& frame) {
+    passTimes.clear();
+
+    for (u32 i = 0; i < frame.total; i++) {
+      auto& timer = frame.queries[i];
+      GLuint64 nanoseconds = 0;
+      RenderPassTime* passTime = nullptr;
+
+      glGetQueryObjectui64v(timer.query, GL_QUERY_RESULT, &nanoseconds);
+
+      for (auto& existing : passTimes) {
+        if (strcmp(existing.name, timer.name) == 0) {
+          passTime = &existing;
+
+          break;
+        }
+      }
+
+      if (passTime == nullptr) {
+        passTime = &passTimes.emplace_back();
+
+        passTime->name = timer.name;
+      }
+
+      passTime->gpuNanoseconds += nanoseconds;
+    }
+
+    frame.total = 0;
+  }
+}
\ No newline at end of file
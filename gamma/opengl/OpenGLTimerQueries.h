@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vector>
+
+#include "system/AbstractRenderer.h"
+#include "system/traits.h"
+#include "system/type_aliases.h"
+
+namespace Gamma {
+  constexpr static u32 TIMER_QUERY_FRAMES = 3;
+
+  /**
+   * OpenGLTimerQueries
+   * ------------------
+   *
+   * Measures the GPU time of render passes with a pool of
+   * GL_TIME_ELAPSED queries per frame. Frames cycle through
+   * TIMER_QUERY_FRAMES sets of queries, and each set is only
+   * read back when it comes around again, once its results
+   * are available, so reading results never stalls. If a
+   * set's results are still pending, timing is skipped for
+   * that frame.
+   *
+   * Elapsed time queries cannot overlap, so passes begun
+   * within another pass are counted as part of it.
+   */
+  class OpenGLTimerQueries : public Initable, public Destroyable {
+  public:
+    /**
+     * Times a render pass for the duration of its scope.
+     */
+    class Scope {
+    public:
+      Scope(OpenGLTimerQueries& queries, const char* name): queries(queries) {
+        queries.begin(name);
+      }
+
+      ~Scope() {
+        queries.end();
+      }
+
+    private:
+      OpenGLTimerQueries& queries;
+    };
+
+    virtual void init() override;
+    virtual void destroy() override;
+    void advanceFrame();
+    void begin(const char* name);
+    void end();
+    const std::vector<RenderPassTime>& getPassTimes() const;
+
+  private:
+    struct TimerQuery {
+      const char* name = nullptr;
+      GLuint query = 0;
+    };
+
+    struct FrameQueries {
+      std::vector<TimerQuery> queries;
+      u32 total = 0;
+    };
+
+    FrameQueries frames[TIMER_QUERY_FRAMES];
+    std::vector<RenderPassTime> passTimes;
+    u32 frameIndex = 0;
+    u32 depth = 0;
+    bool isRecording = false;
+
+    void readFrame(FrameQueries& frame);
+  };
+}
\ No newline at end of file
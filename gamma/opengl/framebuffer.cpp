@@ -20,6 +20,22 @@ namespace Gamma {
     { ColorFormat::RGBA8, GL_RGBA8 }
   };
 
+  // Estimated, assuming 3-channel formats are padded to 4
+  const static std::map<ColorFormat, u32> bytesPerTexelMap = {
+    { ColorFormat::R, 4 },
+    { ColorFormat::R16, 2 },
+    { ColorFormat::RG, 8 },
+    { ColorFormat::RG16, 4 },
+    { ColorFormat::RGB, 16 },
+    { ColorFormat::RGB16, 8 },
+    { ColorFormat::RGBA, 16 },
+    { ColorFormat::RGBA16, 8 },
+    { ColorFormat::RGBA8, 4 }
+  };
+
+  // Depth and depth/stencil textures are padded to 4 bytes
+  constexpr static u32 DEPTH_BYTES_PER_TEXEL = 4;
+
   const static std::map<ColorFormat, GLenum> glFormatMap = {
     { ColorFormat::R, GL_RED },
     { ColorFormat::R16, GL_RED },
@@ -52,6 +68,10 @@ namespace Gamma {
 
     glDeleteTextures(1, &depthTextureId);
     glDeleteTextures(1, &depthStencilTextureId);
+
+    Gm_TrackMemory(memoryCategory, -(s64)memory);
+
+    memory = 0;
   }
 
   void OpenGLFrameBuffer::addColorAttachment(ColorFormat format) {
@@ -71,6 +91,9 @@ namespace Gamma {
     glGenTextures(1, &textureId);
     glBindTexture(GL_TEXTURE_2D, textureId);
     glTexImage2D(GL_TEXTURE_2D, 0, glInternalFormat, size.width, size.height, 0, glFormat, GL_FLOAT, 0);
+
+    trackMemory(bytesPerTexelMap.at(format));
+
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, clamp);
@@ -87,6 +110,9 @@ namespace Gamma {
     glGenTextures(1, &depthTextureId);
     glBindTexture(GL_TEXTURE_2D, depthTextureId);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, size.width, size.height, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, 0);
+
+    trackMemory(DEPTH_BYTES_PER_TEXEL);
+
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTextureId, 0);
   }
 
@@ -94,6 +120,9 @@ namespace Gamma {
     glGenTextures(1, &depthStencilTextureId);
     glBindTexture(GL_TEXTURE_2D, depthStencilTextureId);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, size.width, size.height, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, 0);
+
+    trackMemory(DEPTH_BYTES_PER_TEXEL);
+
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, depthStencilTextureId, 0);
   }
 
@@ -118,6 +147,14 @@ namespace Gamma {
     glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
   }
 
+  /**
+   * Sets the category which the framebuffer's attachments
+   * count toward, e.g. for shadow maps.
+   */
+  void OpenGLFrameBuffer::setMemoryCategory(MemoryCategory category) {
+    memoryCategory = category;
+  }
+
   void OpenGLFrameBuffer::setSize(const Area<u32>& size) {
     this->size = size;
   }
@@ -127,6 +164,14 @@ namespace Gamma {
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, depthStencilTextureId, 0);
   }
 
+  void OpenGLFrameBuffer::trackMemory(u32 bytesPerTexel) {
+    u64 bytes = (u64)size.width * size.height * bytesPerTexel;
+
+    Gm_TrackMemory(memoryCategory, (s64)bytes);
+
+    memory += bytes;
+  }
+
   void OpenGLFrameBuffer::write() {
     glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
     glViewport(0, 0, size.width, size.height);
@@ -155,6 +200,10 @@ namespace Gamma {
     }
 
     glDeleteTextures(1, &depthTextureId);
+
+    Gm_TrackMemory(memoryCategory, -(s64)memory);
+
+    memory = 0;
   }
 
   void OpenGLCubeMap::addColorAttachment(ColorFormat format, u32 unit) {
@@ -170,6 +219,8 @@ namespace Gamma {
       glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, glInternalFormat, size.width, size.height, 0, glFormat, GL_FLOAT, NULL);
     }
 
+    trackMemory(bytesPerTexelMap.at(format));
+
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -200,6 +251,8 @@ namespace Gamma {
       glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_DEPTH_COMPONENT, size.width, size.height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
     }
 
+    trackMemory(DEPTH_BYTES_PER_TEXEL);
+
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -239,10 +292,22 @@ namespace Gamma {
     glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
   }
 
+  void OpenGLCubeMap::setMemoryCategory(MemoryCategory category) {
+    memoryCategory = category;
+  }
+
   void OpenGLCubeMap::setSize(const Area<u32>& size) {
     this->size = size;
   }
 
+  void OpenGLCubeMap::trackMemory(u32 bytesPerTexel) {
+    u64 bytes = (u64)size.width * size.height * bytesPerTexel * 6;
+
+    Gm_TrackMemory(memoryCategory, (s64)bytes);
+
+    memory += bytes;
+  }
+
   void OpenGLCubeMap::write() {
     glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
     glViewport(0, 0, size.width, size.height);
@@ -3,6 +3,7 @@
 #include <vector>
 
 #include "math/plane.h"
+#include "performance/memory.h"
 #include "system/traits.h"
 #include "system/type_aliases.h"
 
@@ -36,6 +37,7 @@ namespace Gamma {
     void addDepthStencilAttachment();
     void bindColorAttachments();
     void read(u32 offset = 0);
+    void setMemoryCategory(MemoryCategory category);
     void setSize(const Area<u32>& size);
     void shareDepthStencilAttachment(const OpenGLFrameBuffer& target);
     void write();
@@ -47,6 +49,10 @@ namespace Gamma {
     GLuint depthStencilTextureId = 0;
     std::vector<ColorAttachment> colorAttachments;
     Area<u32> size;
+    MemoryCategory memoryCategory = MemoryCategory::GPU_FRAMEBUFFERS;
+    u64 memory = 0;
+
+    void trackMemory(u32 bytesPerTexel);
   };
 
   class OpenGLCubeMap : public Initable, public Destroyable {
@@ -57,6 +63,7 @@ namespace Gamma {
     void addColorAttachment(ColorFormat format, u32 unit);
     void addDepthAttachment(u32 unit);
     void bindColorAttachments();
+    void setMemoryCategory(MemoryCategory category);
     void setSize(const Area<u32>& size);
     void write();
     void writeToFace(u8 face);
@@ -67,5 +74,9 @@ namespace Gamma {
     GLuint depthTextureId = 0;
     std::vector<ColorAttachment> colorAttachments;
     Area<u32> size;
+    MemoryCategory memoryCategory = MemoryCategory::GPU_FRAMEBUFFERS;
+    u64 memory = 0;
+
+    void trackMemory(u32 bytesPerTexel);
   };
 }
\ No newline at end of file
@@ -0,0 +1,233 @@
+#include <algorithm>
+#include <map>
+
+#include "opengl/geometry_buffer.h"
+#include "performance/memory.h"
+#include "system/assert.h"
+#include "system/RangeAllocator.h"
+
+#include "glew.h"
+
+namespace Gamma {
+  constexpr static u32 INITIAL_VERTEX_CAPACITY = 0x10000;
+  constexpr static u32 INITIAL_ELEMENT_CAPACITY = 0x40000;
+
+  /**
+   * GeometryArena
+   * -------------
+   *
+   * A single GPU buffer of fixed-size elements (vertices
+   * or face element indices), suballocated in ranges.
+   */
+  struct GeometryArena {
+    GLuint buffer = 0;
+    u32 stride = 0;
+    RangeAllocator allocator;
+  };
+
+  /**
+   * SharedGeometry
+   * --------------
+   *
+   * A geometry range referenced by every mesh created
+   * with the same geometry key.
+   */
+  struct SharedGeometry {
+    GeometryRange range;
+    u32 references = 0;
+  };
+
+  static GeometryArena vertexArena;
+  static GeometryArena elementArena;
+  static u32 geometryBufferVersion = 0;
+  static std::map<std::string, SharedGeometry> sharedGeometries;
+
+  /**
+   * Gm_GrowArena
+   * ------------
+   *
+   * Replaces an arena's buffer with a larger one, copying
+   * over its existing contents. Since the buffer name
+   * changes, VAOs referencing the old buffer must redefine
+   * their attributes; this is signaled by incrementing
+   * the geometry buffer version.
+   */
+  static void Gm_GrowArena(GeometryArena& arena, u32 minimumSize) {
+    u32 previousCapacity = arena.allocator.capacity();
+    u32 capacity = std::max(previousCapacity * 2, previousCapacity + minimumSize);
+    GLuint buffer;
+
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, (u64)capacity * arena.stride, nullptr, GL_STATIC_DRAW);
+
+    if (arena.buffer != 0) {
+      glBindBuffer(GL_COPY_READ_BUFFER, arena.buffer);
+      glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, (u64)previousCapacity * arena.stride);
+      glDeleteBuffers(1, &arena.buffer);
+    }
+
+    arena.buffer = buffer;
+    arena.allocator.grow(capacity);
+
+    Gm_TrackMemory(MemoryCategory::GPU_GEOMETRY, (s64)(capacity - previousCapacity) * arena.stride);
+
+    geometryBufferVersion++;
+  }
+
+  /**
+   * Gm_AllocateArenaRange
+   * ---------------------
+   */
+  static u32 Gm_AllocateArenaRange(GeometryArena& arena, u32 size) {
+    u32 offset;
+
+    while (!arena.allocator.allocate(size, offset)) {
+      Gm_GrowArena(arena, size);
+    }
+
+    return offset;
+  }
+
+  /**
+   * Gm_UploadArenaRange
+   * -------------------
+   */
+  static void Gm_UploadArenaRange(GeometryArena& arena, u32 offset, u32 size, const void* data) {
+    if (size == 0) {
+      return;
+    }
+
+    // Upload through the copy target to avoid disturbing
+    // any element buffer binding on the current VAO
+    glBindBuffer(GL_COPY_WRITE_BUFFER, arena.buffer);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, (u64)offset * arena.stride, (u64)size * arena.stride, data);
+  }
+
+  /**
+   * Gm_AllocateGeometry
+   * -------------------
+   *
+   * Allocates and uploads a range of the global vertex and
+   * element buffers for a set of vertices and face elements.
+   *
+   * Geometry allocated with a key is shared: allocating the
+   * same key again returns the existing range without any
+   * upload, and the range is only freed once every mesh
+   * using it has freed it.
+   */
+  GeometryRange Gm_AllocateGeometry(const std::vector<Vertex>& vertices, const std::vector<u32>& faceElements, const std::string& key) {
+    GeometryRange range;
+
+    if (key.size() > 0 && vertices.size() > 0) {
+      auto& shared = sharedGeometries[key];
+
+      if (shared.references > 0) {
+        // Keys describe the generated/loaded geometry, so a size
+        // mismatch means the vertices were modified afterward;
+        // such geometry can't be shared, and gets its own range
+        if (shared.range.totalVertices == vertices.size() && shared.range.totalIndices == faceElements.size()) {
+          shared.references++;
+
+          return shared.range;
+        }
+
+        return Gm_AllocateGeometry(vertices, faceElements);
+      }
+
+      shared.range = Gm_AllocateGeometry(vertices, faceElements);
+      shared.references = 1;
+
+      return shared.range;
+    }
+
+    range.totalVertices = (u32)vertices.size();
+    range.totalIndices = (u32)faceElements.size();
+    range.baseVertex = Gm_AllocateArenaRange(vertexArena, range.totalVertices);
+    range.firstIndex = Gm_AllocateArenaRange(elementArena, range.totalIndices);
+
+    Gm_UploadArenaRange(vertexArena, range.baseVertex, range.totalVertices, vertices.data());
+    Gm_UploadArenaRange(elementArena, range.firstIndex, range.totalIndices, faceElements.data());
+
+    return range;
+  }
+
+  /**
+   * Gm_DefineGeometryAttributes
+   * ---------------------------
+   *
+   * Points the vertex attributes and element buffer of the
+   * currently bound VAO at the global geometry buffers.
+   * Vertex attributes can optionally be sourced from a
+   * separate buffer, e.g. for streamed transformed vertices.
+   */
+  void Gm_DefineGeometryAttributes(GLuint vertexBuffer) {
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer != 0 ? vertexBuffer : vertexArena.buffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementArena.buffer);
+
+    glEnableVertexAttribArray(GLAttribute::VERTEX_POSITION);
+    glVertexAttribPointer(GLAttribute::VERTEX_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+
+    glEnableVertexAttribArray(GLAttribute::VERTEX_NORMAL);
+    glVertexAttribPointer(GLAttribute::VERTEX_NORMAL, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+
+    glEnableVertexAttribArray(GLAttribute::VERTEX_TANGENT);
+    glVertexAttribPointer(GLAttribute::VERTEX_TANGENT, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tangent));
+
+    glEnableVertexAttribArray(GLAttribute::VERTEX_UV);
+    glVertexAttribPointer(GLAttribute::VERTEX_UV, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, uv));
+  }
+
+  void Gm_DestroyGeometryBuffer() {
+    Gm_TrackMemory(MemoryCategory::GPU_GEOMETRY, -(s64)vertexArena.allocator.capacity() * vertexArena.stride);
+    Gm_TrackMemory(MemoryCategory::GPU_GEOMETRY, -(s64)elementArena.allocator.capacity() * elementArena.stride);
+
+    glDeleteBuffers(1, &vertexArena.buffer);
+    glDeleteBuffers(1, &elementArena.buffer);
+
+    vertexArena = GeometryArena();
+    elementArena = GeometryArena();
+
+    sharedGeometries.clear();
+  }
+
+  void Gm_FreeGeometry(const GeometryRange& range) {
+    // Shared ranges are unique in the vertex buffer, and never
+    // empty, so they can be identified by their base vertex
+    for (auto it = sharedGeometries.begin(); it != sharedGeometries.end(); it++) {
+      auto& shared = it->second;
+
+      if (range.totalVertices > 0 && shared.range.baseVertex == range.baseVertex) {
+        if (--shared.references > 0) {
+          return;
+        }
+
+        sharedGeometries.erase(it);
+
+        break;
+      }
+    }
+
+    vertexArena.allocator.free(range.baseVertex, range.totalVertices);
+    elementArena.allocator.free(range.firstIndex, range.totalIndices);
+  }
+
+  /**
+   * Gm_GetGeometryBufferVersion
+   * ---------------------------
+   *
+   * Returns a counter incremented whenever the global
+   * geometry buffers are reallocated.
+   */
+  u32 Gm_GetGeometryBufferVersion() {
+    return geometryBufferVersion;
+  }
+
+  void Gm_InitGeometryBuffer() {
+    vertexArena.stride = sizeof(Vertex);
+    elementArena.stride = sizeof(u32);
+
+    Gm_GrowArena(vertexArena, INITIAL_VERTEX_CAPACITY);
+    Gm_GrowArena(elementArena, INITIAL_ELEMENT_CAPACITY);
+  }
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "system/entities.h"
+#include "system/type_aliases.h"
+
+namespace Gamma {
+  enum GLAttribute {
+    VERTEX_POSITION,
+    VERTEX_NORMAL,
+    VERTEX_TANGENT,
+    VERTEX_UV,
+    MODEL_COLOR,
+    MODEL_MATRIX,
+    // Model matrices occupy 4 attribute locations
+    INSTANCE_INDEX = MODEL_MATRIX + 4
+  };
+
+  /**
+   * GeometryRange
+   * -------------
+   *
+   * A mesh's suballocated range within the global vertex
+   * and element buffers. Face elements within the range
+   * are relative to baseVertex, so meshes can be drawn
+   * together by passing baseVertex/firstIndex along with
+   * each draw command.
+   */
+  struct GeometryRange {
+    u32 baseVertex = 0;
+    u32 totalVertices = 0;
+    u32 firstIndex = 0;
+    u32 totalIndices = 0;
+  };
+
+  GeometryRange Gm_AllocateGeometry(const std::vector<Vertex>& vertices, const std::vector<u32>& faceElements, const std::string& key = "");
+  void Gm_DefineGeometryAttributes(GLuint vertexBuffer = 0);
+  void Gm_DestroyGeometryBuffer();
+  void Gm_FreeGeometry(const GeometryRange& range);
+  u32 Gm_GetGeometryBufferVersion();
+  void Gm_InitGeometryBuffer();
+}
\ No newline at end of file
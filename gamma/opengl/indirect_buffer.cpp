@@ -1,22 +1,32 @@
 #include "opengl/indirect_buffer.h"
+#include "opengl/OpenGLStreamBuffer.h"
 
 #include "glew.h"
 
 namespace Gamma {
-  GLuint glDrawIndirectBuffer = 0;
+  constexpr static u32 INITIAL_COMMANDS_PER_FRAME = 4096;
+
+  static OpenGLStreamBuffer drawIndirectBuffer;
 
   void Gm_InitDrawIndirectBuffer() {
-    glGenBuffers(1, &glDrawIndirectBuffer);
+    drawIndirectBuffer.init(INITIAL_COMMANDS_PER_FRAME * sizeof(GlDrawElementsIndirectCommand));
   }
 
-  void Gm_BufferDrawElementsIndirectCommands(const GlDrawElementsIndirectCommand* commands, u32 total) {
-    // @todo eventually treat this as a command queue,
-    // rather than recreating the buffer store each time
-    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, glDrawIndirectBuffer);
-    glBufferData(GL_DRAW_INDIRECT_BUFFER, total * sizeof(GlDrawElementsIndirectCommand), commands, GL_DYNAMIC_DRAW);
+  /**
+   * Streams draw commands into the current frame region of the
+   * draw indirect buffer, and binds it. Returns the offset of
+   * the commands, to be passed as the indirect parameter of
+   * glMultiDrawElementsIndirect().
+   */
+  const void* Gm_BufferDrawElementsIndirectCommands(const GlDrawElementsIndirectCommand* commands, u32 total) {
+    u32 offset = drawIndirectBuffer.append(commands, total * sizeof(GlDrawElementsIndirectCommand), sizeof(GlDrawElementsIndirectCommand));
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, drawIndirectBuffer.getBuffer());
+
+    return (const void*)(u64)offset;
   }
 
   void Gm_DestroyDrawIndirectBuffer() {
-    glDeleteBuffers(1, &glDrawIndirectBuffer);
+    drawIndirectBuffer.destroy();
   }
 }
\ No newline at end of file
@@ -12,6 +12,6 @@ namespace Gamma {
   };
 
   void Gm_InitDrawIndirectBuffer();
-  void Gm_BufferDrawElementsIndirectCommands(const GlDrawElementsIndirectCommand* commands, u32 total);
+  const void* Gm_BufferDrawElementsIndirectCommands(const GlDrawElementsIndirectCommand* commands, u32 total);
   void Gm_DestroyDrawIndirectBuffer();
 }
\ No newline at end of file
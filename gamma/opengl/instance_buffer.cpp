@@ -0,0 +1,179 @@
+#include <algorithm>
+
+#include "opengl/geometry_buffer.h"
+#include "opengl/instance_buffer.h"
+#include "opengl/OpenGLStreamBuffer.h"
+#include "system/assert.h"
+#include "system/RangeAllocator.h"
+
+#include "glew.h"
+
+namespace Gamma {
+  constexpr static u32 INITIAL_INSTANCE_CAPACITY = 0x10000;
+  // Keeps region offsets aligned for storage buffer binding
+  constexpr static u32 INSTANCE_CAPACITY_ALIGNMENT = 64;
+
+  enum GLStorageBinding {
+    INSTANCE_MATRICES = 3,
+    INSTANCE_COLORS = 4
+  };
+
+  static OpenGLStreamBuffer colorBuffer;
+  static OpenGLStreamBuffer matrixBuffer;
+  static RangeAllocator allocator;
+  static u32 instanceBufferVersion = 0;
+
+  /**
+   * Gm_GrowInstanceBuffer
+   * ---------------------
+   *
+   * Enlarges each frame region of the instance buffers,
+   * and increments the instance buffer version so VAOs
+   * can redefine their instance attributes.
+   */
+  static void Gm_GrowInstanceBuffer(u32 minimumSize) {
+    u32 previousCapacity = allocator.capacity();
+    u32 capacity = std::max(previousCapacity * 2, previousCapacity + minimumSize);
+
+    capacity = (capacity + INSTANCE_CAPACITY_ALIGNMENT - 1) / INSTANCE_CAPACITY_ALIGNMENT * INSTANCE_CAPACITY_ALIGNMENT;
+
+    if (previousCapacity == 0) {
+      colorBuffer.init(capacity * sizeof(pVec4));
+      matrixBuffer.init(capacity * sizeof(Matrix4f));
+    } else {
+      colorBuffer.resize(capacity * sizeof(pVec4));
+      matrixBuffer.resize(capacity * sizeof(Matrix4f));
+    }
+
+    allocator.grow(capacity);
+
+    instanceBufferVersion++;
+  }
+
+  /**
+   * Gm_AllocateInstances
+   * --------------------
+   */
+  InstanceRange Gm_AllocateInstances(u32 count) {
+    InstanceRange range;
+
+    range.count = count;
+
+    while (!allocator.allocate(count, range.offset)) {
+      Gm_GrowInstanceBuffer(count);
+    }
+
+    return range;
+  }
+
+  /**
+   * Gm_BindInstanceStorageBuffers
+   * -----------------------------
+   *
+   * Binds the current frame region of the instance buffers
+   * to shader storage binding points 3 (matrices) and 4
+   * (colors), for shaders which fetch instances by index.
+   */
+  void Gm_BindInstanceStorageBuffers() {
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, GLStorageBinding::INSTANCE_MATRICES, matrixBuffer.getBuffer(), matrixBuffer.getRegionOffset(), matrixBuffer.getRegionSize());
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, GLStorageBinding::INSTANCE_COLORS, colorBuffer.getBuffer(), colorBuffer.getRegionOffset(), colorBuffer.getRegionSize());
+  }
+
+  /**
+   * Gm_BufferInstances
+   * ------------------
+   *
+   * Writes instances into a range of the current frame region.
+   */
+  void Gm_BufferInstances(const InstanceRange& range, const pVec4* colors, const Matrix4f* matrices, u32 total) {
+    assert(total <= range.count, "Too many instances for the allocated instance range");
+
+    // Make sure both buffers advance to the current frame
+    // region, even if no instances are written
+    Gm_GetInstanceRegion();
+
+    if (total == 0) {
+      return;
+    }
+
+    colorBuffer.write(range.offset * sizeof(pVec4), colors, total * sizeof(pVec4));
+    matrixBuffer.write(range.offset * sizeof(Matrix4f), matrices, total * sizeof(Matrix4f));
+  }
+
+  /**
+   * Gm_DefineInstanceAttributes
+   * ---------------------------
+   *
+   * Points the per-instance color/matrix attributes of the
+   * currently bound VAO at the global instance buffers.
+   */
+  void Gm_DefineInstanceAttributes() {
+    // Define color attributes
+    glBindBuffer(GL_ARRAY_BUFFER, colorBuffer.getBuffer());
+    glEnableVertexAttribArray(GLAttribute::MODEL_COLOR);
+    glVertexAttribIPointer(GLAttribute::MODEL_COLOR, 1, GL_UNSIGNED_INT, sizeof(pVec4), (void*)0);
+    glVertexAttribDivisor(GLAttribute::MODEL_COLOR, 1);
+
+    // Define matrix attributes
+    glBindBuffer(GL_ARRAY_BUFFER, matrixBuffer.getBuffer());
+
+    for (u32 i = 0; i < 4; i++) {
+      glEnableVertexAttribArray(GLAttribute::MODEL_MATRIX + i);
+      glVertexAttribPointer(GLAttribute::MODEL_MATRIX + i, 4, GL_FLOAT, GL_FALSE, sizeof(Matrix4f), (void*)(i * 4 * sizeof(float)));
+      glVertexAttribDivisor(GLAttribute::MODEL_MATRIX + i, 1);
+    }
+  }
+
+  void Gm_DestroyInstanceBuffer() {
+    colorBuffer.destroy();
+    matrixBuffer.destroy();
+
+    allocator.reset();
+  }
+
+  void Gm_FreeInstances(const InstanceRange& range) {
+    allocator.free(range.offset, range.count);
+  }
+
+  /**
+   * Gm_GetBaseInstance
+   * ------------------
+   *
+   * Returns the base instance for drawing the instances in
+   * a range from the current frame region.
+   */
+  u32 Gm_GetBaseInstance(const InstanceRange& range) {
+    return Gm_GetInstanceRegion() * allocator.capacity() + range.offset;
+  }
+
+  /**
+   * Gm_GetInstanceBufferVersion
+   * ---------------------------
+   *
+   * Returns a counter incremented whenever the global
+   * instance buffers are reallocated.
+   */
+  u32 Gm_GetInstanceBufferVersion() {
+    return instanceBufferVersion;
+  }
+
+  /**
+   * Gm_GetInstanceRegion
+   * --------------------
+   *
+   * Returns the index of the current frame region. Ranges
+   * must be written into each region separately; callers
+   * can track which regions contain their latest data.
+   */
+  u32 Gm_GetInstanceRegion() {
+    u32 region = colorBuffer.getRegionIndex();
+
+    assert(matrixBuffer.getRegionIndex() == region, "Instance buffer regions out of sync");
+
+    return region;
+  }
+
+  void Gm_InitInstanceBuffer() {
+    Gm_GrowInstanceBuffer(INITIAL_INSTANCE_CAPACITY);
+  }
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "math/matrix.h"
+#include "system/packed_data.h"
+#include "system/type_aliases.h"
+
+namespace Gamma {
+  /**
+   * InstanceRange
+   * -------------
+   *
+   * A mesh's suballocated range within the global instance
+   * color/matrix buffers, sized to its object pool. Draws
+   * select a mesh's instances by passing the range offset
+   * as their base instance.
+   */
+  struct InstanceRange {
+    u32 offset = 0;
+    u32 count = 0;
+  };
+
+  InstanceRange Gm_AllocateInstances(u32 count);
+  void Gm_BindInstanceStorageBuffers();
+  void Gm_BufferInstances(const InstanceRange& range, const pVec4* colors, const Matrix4f* matrices, u32 total);
+  void Gm_DefineInstanceAttributes();
+  void Gm_DestroyInstanceBuffer();
+  void Gm_FreeInstances(const InstanceRange& range);
+  u32 Gm_GetBaseInstance(const InstanceRange& range);
+  u32 Gm_GetInstanceBufferVersion();
+  u32 Gm_GetInstanceRegion();
+  void Gm_InitInstanceBuffer();
+}
\ No newline at end of file
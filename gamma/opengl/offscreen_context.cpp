@@ -0,0 +1,134 @@
+#include <cstdlib>
+
+#include "opengl/offscreen_context.h"
+#include "system/console.h"
+
+#if GAMMA_USE_EGL
+  #include <EGL/egl.h>
+  #include <EGL/eglext.h>
+#endif
+
+namespace Gamma {
+  #if GAMMA_USE_EGL
+    /**
+     * Gm_GetOffscreenDisplay
+     * ----------------------
+     *
+     * Returns a display which needs no window system, preferring
+     * Mesa's surfaceless platform, and falling back to the
+     * default display otherwise.
+     */
+    static EGLDisplay Gm_GetOffscreenDisplay() {
+      auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+
+      if (getPlatformDisplay != nullptr) {
+        EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+
+        if (display != EGL_NO_DISPLAY) {
+          return display;
+        }
+      }
+
+      return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+  #endif
+
+  /**
+   * Gm_CreateOffscreenContext
+   * -------------------------
+   *
+   * Creates an OpenGL 4.6 core context with a pbuffer surface
+   * of the given size, and makes it current. Returns false if
+   * EGL is unavailable or the context can't be created.
+   */
+  bool Gm_CreateOffscreenContext(OffscreenContext& offscreen, const Area<u32>& size) {
+    #if GAMMA_USE_EGL
+      // Mesa's software rasterizer (llvmpipe) implements all of
+      // GL 4.6 but only advertises 4.5; allow the 460 shaders
+      // to compile there, unless the environment says otherwise
+      setenv("MESA_GL_VERSION_OVERRIDE", "4.6", 0);
+      setenv("MESA_GLSL_VERSION_OVERRIDE", "460", 0);
+
+      EGLDisplay display = Gm_GetOffscreenDisplay();
+
+      if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) {
+        Console::warn("[Gamma] Failed to initialize an EGL display");
+
+        return false;
+      }
+
+      const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_DEPTH_SIZE, 24,
+        EGL_STENCIL_SIZE, 8,
+        EGL_NONE
+      };
+
+      const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 4,
+        EGL_CONTEXT_MINOR_VERSION, 6,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+      };
+
+      const EGLint surfaceAttributes[] = {
+        EGL_WIDTH, (EGLint)size.width,
+        EGL_HEIGHT, (EGLint)size.height,
+        EGL_NONE
+      };
+
+      EGLConfig config;
+      EGLint totalConfigs = 0;
+
+      eglBindAPI(EGL_OPENGL_API);
+
+      if (!eglChooseConfig(display, configAttributes, &config, 1, &totalConfigs) || totalConfigs == 0) {
+        Console::warn("[Gamma] No EGL config supports offscreen OpenGL rendering");
+
+        eglTerminate(display);
+
+        return false;
+      }
+
+      EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+      EGLSurface surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+
+      if (context == EGL_NO_CONTEXT || surface == EGL_NO_SURFACE || !eglMakeCurrent(display, surface, surface, context)) {
+        Console::warn("[Gamma] Failed to create an offscreen OpenGL 4.6 context");
+
+        eglTerminate(display);
+
+        return false;
+      }
+
+      offscreen.display = display;
+      offscreen.surface = surface;
+      offscreen.context = context;
+
+      return true;
+    #else
+      Console::warn("[Gamma] Offscreen rendering requires a build with GAMMA_USE_EGL");
+
+      return false;
+    #endif
+  }
+
+  void Gm_DestroyOffscreenContext(OffscreenContext& offscreen) {
+    #if GAMMA_USE_EGL
+      if (offscreen.display == nullptr) {
+        return;
+      }
+
+      eglMakeCurrent(offscreen.display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+      eglDestroySurface(offscreen.display, offscreen.surface);
+      eglDestroyContext(offscreen.display, offscreen.context);
+      eglTerminate(offscreen.display);
+    #endif
+
+    offscreen = OffscreenContext();
+  }
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "math/plane.h"
+#include "system/type_aliases.h"
+
+namespace Gamma {
+  /**
+   * OffscreenContext
+   * ----------------
+   *
+   * An OpenGL context created through EGL without a window.
+   * Rendering targets a pbuffer surface sized to the window,
+   * which stands in for the window's default framebuffer,
+   * so the renderer runs unchanged. Only available in builds
+   * with GAMMA_USE_EGL, e.g. on Linux with Mesa.
+   */
+  struct OffscreenContext {
+    void* display = nullptr;
+    void* surface = nullptr;
+    void* context = nullptr;
+  };
+
+  bool Gm_CreateOffscreenContext(OffscreenContext& offscreen, const Area<u32>& size);
+  void Gm_DestroyOffscreenContext(OffscreenContext& offscreen);
+}
\ No newline at end of file
@@ -101,6 +101,11 @@ namespace Gamma {
     shaders.pointLight.fragment("./gamma/opengl/shaders/point-light-without-shadow.frag.glsl");
     shaders.pointLight.link();
 
+    shaders.clusteredLights.init();
+    shaders.clusteredLights.vertex("./gamma/opengl/shaders/quad.vert.glsl");
+    shaders.clusteredLights.fragment("./gamma/opengl/shaders/clustered-lights.frag.glsl");
+    shaders.clusteredLights.link();
+
     shaders.directionalShadowcaster.init();
     shaders.directionalShadowcaster.vertex("./gamma/opengl/shaders/quad.vert.glsl");
     shaders.directionalShadowcaster.fragment("./gamma/opengl/shaders/directional-light-with-shadow.frag.glsl");
@@ -211,6 +216,7 @@ namespace Gamma {
     shaders.directionalLight.destroy();
     shaders.spotLight.destroy();
     shaders.pointLight.destroy();
+    shaders.clusteredLights.destroy();
     shaders.directionalShadowcaster.destroy();
     shaders.spotShadowcaster.destroy();
     shaders.pointShadowcaster.destroy();
@@ -71,19 +71,19 @@ namespace Gamma {
 
     std::string source = Gm_LoadFileContents(path);
     std::vector<std::string> includes;
-    u32 currentInclude;
+    size_t currentInclude;
 
     Gm_SaveShaderSourceFileRecord(path);
 
     // Handle #include directives
     while ((currentInclude = source.find(INCLUDE_START)) != std::string::npos) {
-      u32 pathStart = currentInclude + INCLUDE_START.size();
-      u32 pathEnd = source.find(INCLUDE_END, pathStart);
+      size_t pathStart = currentInclude + INCLUDE_START.size();
+      size_t pathEnd = source.find(INCLUDE_END, pathStart);
       // @todo store include paths in shader record;
       // check all included files when hot reloading
       std::string includePath = INCLUDE_ROOT_PATH + source.substr(pathStart, pathEnd - pathStart);
-      u32 replaceStart = currentInclude;
-      u32 replaceLength = (pathEnd + INCLUDE_END.size()) - currentInclude;
+      size_t replaceStart = currentInclude;
+      size_t replaceLength = (pathEnd + INCLUDE_END.size()) - currentInclude;
 
       if (Gm_VectorContains(includes, includePath)) {
         // File already included; simply remove the directive
@@ -102,11 +102,11 @@ namespace Gamma {
     // Handle #define variable overrides
     for (auto& [ name, value ] : defineOverrides) {
       std::string defineDirective = "#define " + name + " ";
-      u32 directiveStart = source.find(defineDirective);
+      size_t directiveStart = source.find(defineDirective);
 
       if (directiveStart != std::string::npos) {
-        u32 valueStart = directiveStart + defineDirective.size();
-        u32 valueEnd = source.find("\n", valueStart);
+        size_t valueStart = directiveStart + defineDirective.size();
+        size_t valueEnd = source.find("\n", valueStart);
 
         source.replace(valueStart, valueEnd - valueStart, value);
       }
@@ -283,6 +283,10 @@ namespace Gamma {
     glUniform1i(getUniformLocation(name), value);
   }
 
+  void OpenGLShader::setIntArray(GLint location, const GLint* values, u32 total) const {
+    glUniform1iv(location, total, values);
+  }
+
   void OpenGLShader::setMatrix4f(std::string name, const Matrix4f& value) const {
     glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, value.m);
   }
@@ -30,10 +30,12 @@ namespace Gamma {
     void define(const std::map<std::string, std::string>& variables);
     void fragment(const char* path);
     void geometry(const char* path);
+    GLint getUniformLocation(const char* name) const;
     void link();
     void setBool(std::string name, bool value) const;
     void setFloat(std::string name, float value) const;
     void setInt(std::string name, int value) const;
+    void setIntArray(GLint location, const GLint* values, u32 total) const;
     void setMatrix4f(std::string name, const Matrix4f& value) const;
     void setVec2f(std::string name, const Vec2f& value) const;
     void setVec3f(std::string name, const Vec3f& value) const;
@@ -46,7 +48,6 @@ namespace Gamma {
     std::vector<GLShaderRecord> glShaderRecords;
     std::map<std::string, std::string> defineVariables;
 
-    GLint getUniformLocation(const char* name) const;
     GLint getUniformLocation(std::string name) const;
   };
 }
\ No newline at end of file
@@ -0,0 +1,145 @@
+#version 460 core
+
+struct Light {
+  vec3 position;
+  float radius;
+  vec3 color;
+  float power;
+  vec3 direction;
+  float fov;
+  uint type;
+};
+
+struct Cluster {
+  uint offset;
+  uint count;
+};
+
+layout (std430, binding = 0) readonly buffer Lights {
+  Light lights[];
+};
+
+layout (std430, binding = 1) readonly buffer Clusters {
+  Cluster clusters[];
+};
+
+layout (std430, binding = 2) readonly buffer LightIndices {
+  uint lightIndices[];
+};
+
+uniform sampler2D texColorAndDepth;
+uniform sampler2D texNormalAndMaterial;
+uniform vec3 cameraPosition;
+uniform mat4 matInverseProjection;
+uniform mat4 matInverseView;
+// Cluster grid dimensions (x, y, z)
+uniform vec3 clusterGrid;
+// Engine-space view matrix row yielding view depth
+uniform vec4 clusterDepthRow;
+uniform float clusterNear;
+// Depth slices per unit of log(depth / near)
+uniform float clusterSliceScale;
+
+noperspective in vec2 fragUv;
+
+layout (location = 0) out vec4 out_colorAndDepth;
+
+#include "utils/conversion.glsl";
+
+// @todo share with inline/point-light.glsl and inline/spot-light.glsl
+vec3 getIlluminatedColor(Light light, vec3 position, vec3 normal, vec3 color, float roughness, vec3 normalized_surface_to_camera) {
+  vec3 surface_to_light = light.position - position;
+  float light_distance = length(surface_to_light);
+
+  if (light_distance > light.radius) {
+    return vec3(0.0);
+  }
+
+  vec3 normalized_surface_to_light = surface_to_light / light_distance;
+  float spot_factor = 1.0;
+  bool is_spot_light = light.type == 2 || light.type == 5;
+
+  if (is_spot_light) {
+    float fragment_alignment = dot(normalized_surface_to_light * -1, light.direction);
+    float cone_edge_alignment = 1.0 - (light.fov / 180.0);
+
+    if (fragment_alignment < cone_edge_alignment) {
+      return vec3(0.0);
+    }
+
+    float cone_edge_range = 1.0 - cone_edge_alignment;
+    float cone_edge_proximity = fragment_alignment - cone_edge_alignment;
+
+    spot_factor = pow(cone_edge_proximity / cone_edge_range, 0.7);
+  }
+
+  vec3 half_vector = normalize(normalized_surface_to_light + normalized_surface_to_camera);
+  float incidence = max(dot(normalized_surface_to_light, normal), 0.0);
+  float attenuation = pow(1.0 / light_distance, 2);
+  float specularity = pow(max(dot(half_vector, normal), 0.0), 50) * (1.0 - roughness);
+  float distance_ratio = clamp(light_distance / light.radius, 0.0, 1.0);
+
+  if (incidence == 0.0 && !is_spot_light) specularity = 0.0;
+
+  // Taper light intensity more softly to preserve light with distance
+  float hack_soft_tapering = (20.0 * (light_distance / light.radius));
+  vec3 radiant_flux = light.color * light.power * light.radius;
+
+  if (is_spot_light) {
+    // Have light intensity 'fall off' toward radius boundary
+    float hack_radial_influence = max(1.0 - light_distance / light.radius, 0.0);
+
+    vec3 diffuse_term = color * radiant_flux * incidence * attenuation * hack_radial_influence * hack_soft_tapering * (1.0 - specularity) * sqrt(roughness);
+    vec3 specular_term = 5.0 * radiant_flux * specularity * attenuation;
+
+    return (diffuse_term + specular_term) * spot_factor;
+  } else {
+    // Define a non-linear light intensity fall-off toward the radius boundary
+    float hack_diffuse_radial_influence = (1.0 - pow(distance_ratio, 2));
+    float hack_specular_radial_influence = (1.0 - pow(distance_ratio, 10));
+
+    vec3 diffuse_term = color * radiant_flux * incidence * attenuation * hack_diffuse_radial_influence * hack_soft_tapering * (1.0 - specularity) * sqrt(roughness);
+    vec3 specular_term = 5.0 * radiant_flux * specularity * attenuation * hack_specular_radial_influence;
+
+    return diffuse_term + specular_term;
+  }
+}
+
+void main() {
+  vec4 frag_color_and_depth = texture(texColorAndDepth, fragUv);
+  vec3 position = getWorldPosition(frag_color_and_depth.w, fragUv, matInverseProjection, matInverseView);
+  float view_depth = dot(clusterDepthRow.xyz, position) + clusterDepthRow.w;
+
+  // Determine the fragment's cluster
+  ivec3 grid = ivec3(clusterGrid);
+  ivec2 tile = clamp(ivec2(fragUv * clusterGrid.xy), ivec2(0), grid.xy - 1);
+  int slice = view_depth <= clusterNear ? 0 : int(log(view_depth / clusterNear) * clusterSliceScale);
+
+  slice = clamp(slice, 0, grid.z - 1);
+
+  Cluster cluster = clusters[(slice * grid.y + tile.y) * grid.x + tile.x];
+
+  if (cluster.count == 0) {
+    discard;
+  }
+
+  vec4 frag_normal_and_material = texture(texNormalAndMaterial, fragUv);
+  vec3 frag_normal = frag_normal_and_material.xyz;
+  vec3 frag_color = frag_color_and_depth.rgb;
+
+  // @todo refactor
+  float material = frag_normal_and_material.w;
+  float emissivity = floor(material) / 10.0;
+  float roughness = fract(material);
+
+  vec3 normalized_surface_to_camera = normalize(cameraPosition - position);
+  vec3 illuminated_color = vec3(0.0);
+
+  for (uint i = 0; i < cluster.count; i++) {
+    Light light = lights[lightIndices[cluster.offset + i]];
+
+    illuminated_color += getIlluminatedColor(light, position, frag_normal, frag_color, roughness, normalized_surface_to_camera);
+  }
+
+  out_colorAndDepth = vec4(illuminated_color * (1.0 - min(1.0, emissivity)), frag_color_and_depth.w);
+}
\ No newline at end of file
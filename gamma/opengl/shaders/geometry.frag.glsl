@@ -7,16 +7,20 @@ uniform sampler2D meshTexture;
 uniform sampler2D meshNormalMap;
 uniform float emissivity = 0.0;
 uniform float roughness = 0.6;
+uniform bool useDrawMaterials = false;
 
 flat in vec3 fragColor;
 in vec3 fragNormal;
 in vec3 fragTangent;
 in vec3 fragBitangent;
 in vec2 fragUv;
+flat in uint fragDrawId;
 
 layout (location = 0) out vec4 out_color_and_depth;
 layout (location = 1) out vec4 out_normal_and_material;
 
+#include "utils/materials.glsl";
+
 vec3 getNormal() {
   vec3 normalized_frag_normal = normalize(fragNormal);
 
@@ -42,7 +46,19 @@ void main() {
     discard;
   }
 
-  if (useCloseTranslucency) {
+  float mesh_roughness = roughness;
+  float mesh_emissivity = emissivity;
+  bool use_close_translucency = useCloseTranslucency;
+
+  if (useDrawMaterials) {
+    DrawMaterial draw_material = drawMaterials[fragDrawId];
+
+    mesh_roughness = draw_material.roughness;
+    mesh_emissivity = draw_material.emissivity;
+    use_close_translucency = (draw_material.flags & MATERIAL_CLOSE_TRANSLUCENCY) != 0;
+  }
+
+  if (use_close_translucency) {
     if (gl_FragCoord.z < 0.95 && int(gl_FragCoord.x) % 3 < 2) {
       discard;
     }
@@ -50,8 +66,8 @@ void main() {
 
   float material = 0.0;
 
-  material += floor(10 * emissivity);
-  material += roughness * 0.99;
+  material += floor(10 * mesh_emissivity);
+  material += mesh_roughness * 0.99;
 
   out_color_and_depth = vec4(color.rgb, gl_FragCoord.z);
   out_normal_and_material = vec4(getNormal(), material);
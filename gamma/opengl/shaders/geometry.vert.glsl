@@ -3,6 +3,7 @@
 uniform mat4 matProjection;
 uniform mat4 matView;
 uniform bool useXzPlaneTexturing = false;
+uniform bool useDrawMaterials = false;
 
 layout (location = 0) in vec3 vertexPosition;
 layout (location = 1) in vec3 vertexNormal;
@@ -10,6 +11,7 @@ layout (location = 2) in vec3 vertexTangent;
 layout (location = 3) in vec2 vertexUv;
 layout (location = 4) in uint modelColor;
 layout (location = 5) in mat4 modelMatrix;
+layout (location = 9) in uint instanceIndex;
 
 flat out vec3 fragColor;
 out vec3 fragPosition;
@@ -17,8 +19,11 @@ out vec3 fragNormal;
 out vec3 fragTangent;
 out vec3 fragBitangent;
 out vec2 fragUv;
+flat out uint fragDrawId;
 
 #include "utils/gl.glsl";
+#include "utils/instances.glsl";
+#include "utils/materials.glsl";
 
 /**
  * Returns a bitangent from potentially non-orthonormal
@@ -43,18 +48,26 @@ vec3 unpack(uint color) {
 }
 
 void main() {
+  mat4 model_matrix = getModelMatrix();
+
   // @hack invert Z
-  vec4 world_position = glVec4(modelMatrix * vec4(vertexPosition, 1.0));
-  mat3 normal_matrix = transpose(inverse(mat3(modelMatrix)));
+  vec4 world_position = glVec4(model_matrix * vec4(vertexPosition, 1.0));
+  mat3 normal_matrix = transpose(inverse(mat3(model_matrix)));
 
   gl_Position = matProjection * matView * world_position;
 
-  fragColor = unpack(modelColor);
+  fragColor = unpack(getModelColor());
   // @hack invert Z
   fragPosition = glVec3(world_position.xyz);
   fragNormal = normal_matrix * vertexNormal;
   fragTangent = normal_matrix * vertexTangent;
   fragBitangent = getFragBitangent(fragNormal, fragTangent);
+  fragDrawId = gl_DrawID;
+
+  bool use_xz_plane_texturing = useDrawMaterials
+    ? (drawMaterials[gl_DrawID].flags & MATERIAL_XZ_PLANE_TEXTURING) != 0
+    : useXzPlaneTexturing;
+
   // @todo allow scaling factor to be configured
-  fragUv = useXzPlaneTexturing ? world_position.xz / 400.0 : vertexUv;
+  fragUv = use_xz_plane_texturing ? world_position.xz / 400.0 : vertexUv;
 }
\ No newline at end of file
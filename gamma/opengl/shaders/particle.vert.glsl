@@ -9,11 +9,13 @@ layout (location = 2) in vec3 vertexTangent;
 layout (location = 3) in vec2 vertexUv;
 layout (location = 4) in uint modelColor;
 layout (location = 5) in mat4 modelMatrix;
+layout (location = 9) in uint instanceIndex;
 
 out vec2 fragUv;
 flat out vec3 color;
 
 #include "utils/gl.glsl";
+#include "utils/instances.glsl";
 
 // @todo move to utils
 vec3 unpack(uint color) {
@@ -25,14 +27,16 @@ vec3 unpack(uint color) {
 }
 
 void main() {
-  float scale = modelMatrix[0][0];
+  mat4 model_matrix = getModelMatrix();
+
+  float scale = model_matrix[0][0];
 
   // @hack invert Z
-  vec4 world_position = glVec4(modelMatrix * vec4(vertexPosition, 1.0));
+  vec4 world_position = glVec4(model_matrix * vec4(vertexPosition, 1.0));
 
   gl_Position = matProjection * matView * world_position;
   gl_PointSize = 5000.0 * scale / gl_Position.z;
 
   fragUv = vertexUv;
-  color = unpack(modelColor);
+  color = unpack(getModelColor());
 }
\ No newline at end of file
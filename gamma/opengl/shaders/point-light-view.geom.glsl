@@ -5,10 +5,16 @@ uniform mat4 lightMatrices[6];
 layout (triangles) in;
 layout (triangle_strip, max_vertices = 18) out;
 
+flat in int vertFaceMask[];
+
 out vec4 world_position;
 
 void main() {
   for (int f = 0; f < 6; f++) {
+    if ((vertFaceMask[0] & (1 << f)) == 0) {
+      continue;
+    }
+
     gl_Layer = f;
 
     for (int v = 0; v < 3; v++) {
@@ -6,10 +6,21 @@ layout (location = 2) in vec3 vertexTangent;
 layout (location = 3) in vec2 vertexUv;
 layout (location = 4) in uint modelColor;
 layout (location = 5) in mat4 modelMatrix;
+layout (location = 9) in uint instanceIndex;
+
+// Cube map faces to render each instance run to,
+// indexed by the draw within a multi-draw call
+uniform int faceMasks[32];
+
+flat out int vertFaceMask;
 
 #include "utils/gl.glsl";
+#include "utils/instances.glsl";
 
 void main() {
+  mat4 model_matrix = getModelMatrix();
+
   // @hack invert Z
-  gl_Position = glVec4(modelMatrix * vec4(vertexPosition, 1.0));
+  vertFaceMask = faceMasks[gl_DrawID];
+  gl_Position = glVec4(model_matrix * vec4(vertexPosition, 1.0));
 }
\ No newline at end of file
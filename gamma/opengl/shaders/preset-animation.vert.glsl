@@ -9,6 +9,7 @@ layout (location = 2) in vec3 vertexTangent;
 layout (location = 3) in vec2 vertexUv;
 layout (location = 4) in uint modelColor;
 layout (location = 5) in mat4 modelMatrix;
+layout (location = 9) in uint instanceIndex;
 
 flat out vec3 fragColor;
 out vec3 fragPosition;
@@ -16,8 +17,10 @@ out vec3 fragNormal;
 out vec3 fragTangent;
 out vec3 fragBitangent;
 out vec2 fragUv;
+flat out uint fragDrawId;
 
 #include "utils/gl.glsl";
+#include "utils/instances.glsl";
 #include "utils/preset-animation.glsl";
 
 /**
@@ -46,9 +49,11 @@ vec3 unpack(uint color) {
 }
 
 void main() {
+  mat4 model_matrix = getModelMatrix();
+
   // @hack invert Z
-  vec4 world_position = glVec4(modelMatrix * vec4(vertexPosition, 1.0));
-  mat3 normal_matrix = transpose(inverse(mat3(modelMatrix)));
+  vec4 world_position = glVec4(model_matrix * vec4(vertexPosition, 1.0));
+  mat3 normal_matrix = transpose(inverse(mat3(model_matrix)));
 
   // @todo make a utility for this
   switch (animation.type) {
@@ -68,11 +73,12 @@ void main() {
 
   gl_Position = matProjection * matView * world_position;
 
-  fragColor = unpack(modelColor);
+  fragColor = unpack(getModelColor());
   // @hack invert Z
   fragPosition = glVec3(world_position.xyz);
   fragNormal = normal_matrix * vertexNormal;
   fragTangent = normal_matrix * vertexTangent;
   fragBitangent = getFragBitangent(fragNormal, fragTangent);
   fragUv = vertexUv;
+  fragDrawId = gl_DrawID;
 }
\ No newline at end of file
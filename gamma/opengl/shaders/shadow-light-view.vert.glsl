@@ -8,15 +8,19 @@ layout (location = 2) in vec3 vertexTangent;
 layout (location = 3) in vec2 vertexUv;
 layout (location = 4) in uint modelColor;
 layout (location = 5) in mat4 modelMatrix;
+layout (location = 9) in uint instanceIndex;
 
 out vec2 fragUv;
 
 #include "utils/gl.glsl";
+#include "utils/instances.glsl";
 #include "utils/preset-animation.glsl";
 
 void main() {
+  mat4 model_matrix = getModelMatrix();
+
   // @hack invert Z
-  vec4 world_position = glVec4(modelMatrix * vec4(vertexPosition, 1.0));
+  vec4 world_position = glVec4(model_matrix * vec4(vertexPosition, 1.0));
 
   // @todo make a utility for this
   switch (animation.type) {
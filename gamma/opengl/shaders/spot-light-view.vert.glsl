@@ -8,13 +8,17 @@ layout (location = 2) in vec3 vertexTangent;
 layout (location = 3) in vec2 vertexUv;
 layout (location = 4) in uint modelColor;
 layout (location = 5) in mat4 modelMatrix;
+layout (location = 9) in uint instanceIndex;
 
 // @todo when adding support for transparent textures
 // out vec2 fragUv;
 
 #include "utils/gl.glsl";
+#include "utils/instances.glsl";
 
 void main() {
+  mat4 model_matrix = getModelMatrix();
+
   // @hack invert Z
-  gl_Position = lightMatrix * glVec4(modelMatrix * vec4(vertexPosition, 1.0));
+  gl_Position = lightMatrix * glVec4(model_matrix * vec4(vertexPosition, 1.0));
 }
\ No newline at end of file
@@ -0,0 +1,26 @@
+/**
+ * Instance data for meshes drawn from visible index lists.
+ * When an instance index is provided, model matrices and
+ * colors are fetched from these buffers rather than from
+ * the per-instance attributes.
+ *
+ * Requires modelColor, modelMatrix and instanceIndex
+ * vertex attributes to be declared before inclusion.
+ */
+#define NO_INSTANCE_INDEX 0xFFFFFFFFu
+
+layout (std430, binding = 3) readonly buffer InstanceMatrices {
+  mat4 instanceMatrices[];
+};
+
+layout (std430, binding = 4) readonly buffer InstanceColors {
+  uint instanceColors[];
+};
+
+mat4 getModelMatrix() {
+  return instanceIndex == NO_INSTANCE_INDEX ? modelMatrix : instanceMatrices[instanceIndex];
+}
+
+uint getModelColor() {
+  return instanceIndex == NO_INSTANCE_INDEX ? modelColor : instanceColors[instanceIndex];
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+/**
+ * Per-draw material parameters for batched meshes,
+ * indexed by gl_DrawID within a multi-draw call.
+ */
+#define MATERIAL_XZ_PLANE_TEXTURING 1u
+#define MATERIAL_CLOSE_TRANSLUCENCY 2u
+
+struct DrawMaterial {
+  float roughness;
+  float emissivity;
+  uint flags;
+  uint padding;
+};
+
+layout (std430, binding = 5) readonly buffer DrawMaterials {
+  DrawMaterial drawMaterials[];
+};
\ No newline at end of file
@@ -22,8 +22,10 @@ namespace Gamma {
    */
   OpenGLDirectionalShadowMap::OpenGLDirectionalShadowMap(const Light* light) {
     this->light = light;
+    this->lightHandle = light->_handle;
 
     buffer.init();
+    buffer.setMemoryCategory(MemoryCategory::GPU_SHADOW_MAPS);
     buffer.setSize({ 2048, 2048 });
     buffer.addColorAttachment(ColorFormat::R, 3);  // Cascade 0 (GL_TEXTURE3)
     buffer.addColorAttachment(ColorFormat::R, 4);  // Cascade 1 (GL_TEXTURE4)
@@ -42,8 +44,10 @@ namespace Gamma {
    */
   OpenGLPointShadowMap::OpenGLPointShadowMap(const Light* light) {
     this->light = light;
+    this->lightHandle = light->_handle;
 
     buffer.init();
+    buffer.setMemoryCategory(MemoryCategory::GPU_SHADOW_MAPS);
     buffer.setSize({ 1024, 1024 });
     buffer.addDepthAttachment(3);  // Depth (GL_TEXTURE3)
 
@@ -58,8 +62,10 @@ namespace Gamma {
    */
   OpenGLSpotShadowMap::OpenGLSpotShadowMap(const Light* light) {
     this->light = light;
+    this->lightHandle = light->_handle;
 
     buffer.init();
+    buffer.setMemoryCategory(MemoryCategory::GPU_SHADOW_MAPS);
     buffer.setSize({ 1024, 1024 });
     buffer.addColorAttachment(ColorFormat::R, 3);  // Depth (GL_TEXTURE3)
     buffer.addDepthAttachment();
@@ -151,4 +157,59 @@ namespace Gamma {
 
     return (matProjection * matView).transpose();
   }
+
+  /**
+   * Gm_UpdatePointShadowMapMatrices
+   * -------------------------------
+   *
+   * Recomputes the view-projection matrices for each cube
+   * map face of a point light shadow map, but only when the
+   * light has moved or changed radius since the last update.
+   */
+  void Gm_UpdatePointShadowMapMatrices(OpenGLPointShadowMap& shadowMap) {
+    auto& light = *shadowMap.light;
+
+    if (light.position == shadowMap.cachedPosition && light.radius == shadowMap.cachedRadius) {
+      return;
+    }
+
+    Matrix4f matLightProjection = Matrix4f::glPerspective({ 1024, 1024 }, 90.f, 1.f, light.radius);
+
+    for (u32 i = 0; i < 6; i++) {
+      Matrix4f matLightView = Matrix4f::lookAt(light.position.gl(), CUBE_MAP_DIRECTIONS[i], CUBE_MAP_UP_DIRECTIONS[i]);
+
+      shadowMap.lightMatrices[i] = (matLightProjection * matLightView).transpose();
+    }
+
+    shadowMap.cachedPosition = light.position;
+    shadowMap.cachedRadius = light.radius;
+  }
+
+  /**
+   * Gm_UpdateSpotShadowMapMatrix
+   * ----------------------------
+   *
+   * Recomputes the view-projection matrix of a spot light
+   * shadow map, but only when the light has moved, rotated
+   * or changed radius since the last update.
+   */
+  void Gm_UpdateSpotShadowMapMatrix(OpenGLSpotShadowMap& shadowMap) {
+    auto& light = *shadowMap.light;
+
+    if (
+      light.position == shadowMap.cachedPosition &&
+      light.direction == shadowMap.cachedDirection &&
+      light.radius == shadowMap.cachedRadius
+    ) {
+      return;
+    }
+
+    Matrix4f matLightProjection = Matrix4f::glPerspective({ 1024, 1024 }, 120.0f, 1.0f, light.radius);
+    Matrix4f matLightView = Matrix4f::lookAt(light.position.gl(), light.direction.invert().gl(), Vec3f(0.0f, 1.0f, 0.0f));
+
+    shadowMap.lightMatrix = (matLightProjection * matLightView).transpose();
+    shadowMap.cachedPosition = light.position;
+    shadowMap.cachedDirection = light.direction;
+    shadowMap.cachedRadius = light.radius;
+  }
 }
\ No newline at end of file
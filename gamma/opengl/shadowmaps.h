@@ -1,16 +1,64 @@
 #pragma once
 
+#include <vector>
+
 #include "math/matrix.h"
 #include "math/vector.h"
 #include "opengl/framebuffer.h"
 #include "opengl/shader.h"
 #include "system/camera.h"
+#include "system/culling.h"
 #include "system/entities.h"
 
 namespace Gamma {
+  /**
+   * Cube map face directions in GL space, in { -X, +X, -Y, +Y, -Z, +Z } order.
+   */
+  const static Vec3f CUBE_MAP_DIRECTIONS[6] = {
+    Vec3f(-1.0f, 0.0f, 0.0f),
+    Vec3f(1.0f, 0.0f, 0.0f),
+    Vec3f(0.0f, -1.0f, 0.0f),
+    Vec3f(0.0f, 1.0f, 0.0f),
+    Vec3f(0.0f, 0.0f, -1.0f),
+    Vec3f(0.0f, 0.0f, 1.0f)
+  };
+
+  const static Vec3f CUBE_MAP_UP_DIRECTIONS[6] = {
+    Vec3f(0.0f, -1.0f, 0.0f),
+    Vec3f(0.0f, -1.0f, 0.0f),
+    Vec3f(0.0f, 0.0f, 1.0f),
+    Vec3f(0.0f, 0.0f, -1.0f),
+    Vec3f(0.0f, -1.0f, 0.0f),
+    Vec3f(0.0f, -1.0f, 0.0f)
+  };
+
+  /**
+   * ShadowCasterStats
+   * -----------------
+   *
+   * Tracks the number of shadow caster instances submitted
+   * to, or culled from, a shadow map in the latest frame.
+   */
+  struct ShadowCasterStats {
+    u32 submitted = 0;
+    u32 culled = 0;
+  };
+
   struct OpenGLBaseShadowMap {
+    /**
+     * The shadowcasting light. Lights may be moved within
+     * their pool, so this is re-resolved from lightHandle
+     * at the start of each frame.
+     */
     const Light* light = nullptr;
+    LightHandle lightHandle;
     bool isRendered = false;
+    ShadowCasterStats casterStats;
+    /**
+     * Reusable storage for the culled instance runs
+     * of each mesh drawn to the shadow map.
+     */
+    std::vector<InstanceRun> casterRuns;
   };
 
   struct OpenGLDirectionalShadowMap : public OpenGLBaseShadowMap {
@@ -21,15 +69,32 @@ namespace Gamma {
 
   struct OpenGLPointShadowMap : public OpenGLBaseShadowMap {
     OpenGLCubeMap buffer;
+    /**
+     * Cached view-projection matrices for each cube map face,
+     * recomputed only when the light position/radius change.
+     */
+    Matrix4f lightMatrices[6];
+    Vec3f cachedPosition;
+    float cachedRadius = -1.f;
 
     OpenGLPointShadowMap(const Light* light);
   };
 
   struct OpenGLSpotShadowMap : public OpenGLBaseShadowMap {
     OpenGLFrameBuffer buffer;
+    /**
+     * Cached view-projection matrix, recomputed only when
+     * the light position/direction/radius change.
+     */
+    Matrix4f lightMatrix;
+    Vec3f cachedPosition;
+    Vec3f cachedDirection;
+    float cachedRadius = -1.f;
 
     OpenGLSpotShadowMap(const Light* light);
   };
 
   Matrix4f Gm_CreateCascadedLightViewProjectionMatrixGL(u8 cascade, const Vec3f& lightDirection, const Camera& camera);
+  void Gm_UpdatePointShadowMapMatrices(OpenGLPointShadowMap& shadowMap);
+  void Gm_UpdateSpotShadowMapMatrix(OpenGLSpotShadowMap& shadowMap);
 }
\ No newline at end of file
@@ -1,4 +1,7 @@
+#include <algorithm>
 #include <chrono>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <thread>
 
@@ -11,6 +14,44 @@ u64 Gm_GetMicroseconds() {
 }
 
 namespace Gamma {
+  /**
+   * Gm_ReadJsonNumber
+   * -----------------
+   *
+   * Reads a numeric field from a single flat JSON object,
+   * as written by Gm_WriteBenchmarkResults.
+   */
+  static double Gm_ReadJsonNumber(const std::string& json, const std::string& key) {
+    auto index = json.find("\"" + key + "\":");
+
+    if (index == std::string::npos) {
+      return 0.0;
+    }
+
+    return std::strtod(json.c_str() + index + key.size() + 3, nullptr);
+  }
+
+  /**
+   * Gm_ReadJsonString
+   * -----------------
+   */
+  static std::string Gm_ReadJsonString(const std::string& json, const std::string& key) {
+    auto index = json.find("\"" + key + "\":");
+
+    if (index == std::string::npos) {
+      return "";
+    }
+
+    auto start = json.find('"', index + key.size() + 3);
+    auto end = json.find('"', start + 1);
+
+    if (start == std::string::npos || end == std::string::npos) {
+      return "";
+    }
+
+    return json.substr(start + 1, end - start - 1);
+  }
+
   void Gm_CompareBenchmarks(u64 a, u64 b) {
     if (a > b) {
       u32 improvement = (u32)(100.0f * (1.0f - (float)b / (float)a));
@@ -23,6 +64,152 @@ namespace Gamma {
     }
   }
 
+  /**
+   * Gm_CompareBenchmarkResults
+   * --------------------------
+   *
+   * Compares per-operation times against a baseline, printing
+   * the change for each benchmark. Returns the number of
+   * benchmarks which regressed by more than threshold, e.g.
+   * 0.1 for a 10% slowdown.
+   */
+  u32 Gm_CompareBenchmarkResults(const std::vector<BenchmarkResult>& baseline, const std::vector<BenchmarkResult>& results, float threshold) {
+    u32 totalRegressions = 0;
+
+    for (auto& result : results) {
+      auto previous = std::find_if(baseline.begin(), baseline.end(), [&](const BenchmarkResult& entry) {
+        return entry.name == result.name;
+      });
+
+      if (previous == baseline.end() || previous->nanosecondsPerOperation <= 0.0) {
+        printf("  %-40s %12.2f ns/op (no baseline)\n", result.name.c_str(), result.nanosecondsPerOperation);
+
+        continue;
+      }
+
+      double change = result.nanosecondsPerOperation / previous->nanosecondsPerOperation - 1.0;
+      bool isRegression = change > threshold;
+
+      printf(
+        "  %-40s %12.2f -> %12.2f ns/op (%+.1f%%)%s\n",
+        result.name.c_str(),
+        previous->nanosecondsPerOperation,
+        result.nanosecondsPerOperation,
+        change * 100.0,
+        isRegression ? " REGRESSION" : ""
+      );
+
+      if (isRegression) {
+        totalRegressions++;
+      }
+    }
+
+    return totalRegressions;
+  }
+
+  /**
+   * Gm_MeasureBenchmark
+   * -------------------
+   *
+   * Runs a benchmark's warmup repetitions, followed by its
+   * measured repetitions, and reports the median and 95th
+   * percentile repetition times.
+   */
+  BenchmarkResult Gm_MeasureBenchmark(const BenchmarkCase& benchmark, u32 warmup, u32 repetitions) {
+    BenchmarkResult result;
+    std::vector<double> samples;
+
+    result.name = benchmark.name;
+    result.warmup = warmup;
+    result.repetitions = std::max(repetitions, 1u);
+    result.operations = std::max(benchmark.operations, (u64)1);
+
+    for (u32 i = 0; i < warmup + result.repetitions; i++) {
+      if (benchmark.setup) {
+        benchmark.setup();
+      }
+
+      auto start = std::chrono::steady_clock::now();
+
+      benchmark.test();
+
+      auto end = std::chrono::steady_clock::now();
+
+      if (i >= warmup) {
+        samples.push_back((double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+      }
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    u32 total = (u32)samples.size();
+    u32 p95Index = std::min(total - 1, (u32)(0.95 * total + 0.5));
+
+    result.medianNanoseconds = total % 2 == 0
+      ? (samples[total / 2 - 1] + samples[total / 2]) / 2.0
+      : samples[total / 2];
+
+    result.p95Nanoseconds = samples[p95Index];
+    result.nanosecondsPerOperation = result.medianNanoseconds / (double)result.operations;
+
+    return result;
+  }
+
+  /**
+   * Gm_ReadBenchmarkResults
+   * -----------------------
+   *
+   * Reads results written by Gm_WriteBenchmarkResults.
+   * Returns an empty list if the file can't be read.
+   */
+  std::vector<BenchmarkResult> Gm_ReadBenchmarkResults(const char* path) {
+    std::vector<BenchmarkResult> results;
+    FILE* file = fopen(path, "r");
+
+    if (file == nullptr) {
+      return results;
+    }
+
+    std::string json;
+    char buffer[4096];
+    size_t size;
+
+    while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+      json.append(buffer, size);
+    }
+
+    fclose(file);
+
+    // Each result is written as a flat object, so the
+    // results can be read back object by object
+    auto start = json.find('{', json.find("\"benchmarks\""));
+
+    while (start != std::string::npos) {
+      auto end = json.find('}', start);
+
+      if (end == std::string::npos) {
+        break;
+      }
+
+      std::string object = json.substr(start, end - start + 1);
+      BenchmarkResult result;
+
+      result.name = Gm_ReadJsonString(object, "name");
+      result.warmup = (u32)Gm_ReadJsonNumber(object, "warmup");
+      result.repetitions = (u32)Gm_ReadJsonNumber(object, "repetitions");
+      result.operations = (u64)Gm_ReadJsonNumber(object, "operations");
+      result.medianNanoseconds = Gm_ReadJsonNumber(object, "median_ns");
+      result.p95Nanoseconds = Gm_ReadJsonNumber(object, "p95_ns");
+      result.nanosecondsPerOperation = Gm_ReadJsonNumber(object, "ns_per_op");
+
+      results.push_back(result);
+
+      start = json.find('{', end);
+    }
+
+    return results;
+  }
+
   u64 Gm_RepeatBenchmarkTest(const std::function<void()>& test, u32 times) {
     // Warmup run - without this, the first timed test
     // invocation may take longer than usual. (Might be
@@ -67,4 +254,40 @@ namespace Gamma {
   void Gm_Sleep(u32 milliseconds) {
     std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
   }
+
+  /**
+   * Gm_WriteBenchmarkResults
+   * ------------------------
+   */
+  bool Gm_WriteBenchmarkResults(const char* path, const std::vector<BenchmarkResult>& results) {
+    FILE* file = fopen(path, "w");
+
+    if (file == nullptr) {
+      return false;
+    }
+
+    fprintf(file, "{\n  \"benchmarks\": [\n");
+
+    for (u32 i = 0; i < results.size(); i++) {
+      auto& result = results[i];
+
+      fprintf(
+        file,
+        "    { \"name\": \"%s\", \"warmup\": %u, \"repetitions\": %u, \"operations\": %llu, \"median_ns\": %.1f, \"p95_ns\": %.1f, \"ns_per_op\": %.3f }%s\n",
+        result.name.c_str(),
+        result.warmup,
+        result.repetitions,
+        (unsigned long long)result.operations,
+        result.medianNanoseconds,
+        result.p95Nanoseconds,
+        result.nanosecondsPerOperation,
+        i < results.size() - 1 ? "," : ""
+      );
+    }
+
+    fprintf(file, "  ]\n}\n");
+    fclose(file);
+
+    return true;
+  }
 }
\ No newline at end of file
@@ -2,18 +2,53 @@
 
 #include <chrono>
 #include <functional>
+#include <string>
+#include <vector>
 
 #include "system/type_aliases.h"
 
 u64 Gm_GetMicroseconds();
 
 namespace Gamma {
+  /**
+   * BenchmarkCase
+   * -------------
+   *
+   * A named test to be measured over several repetitions.
+   * setup() runs before every repetition and is excluded
+   * from the measured time. operations is the number of
+   * operations each test() call performs, used to report
+   * per-operation times.
+   */
+  struct BenchmarkCase {
+    std::string name;
+    u64 operations = 1;
+    std::function<void()> setup;
+    std::function<void()> test;
+  };
+
+  /**
+   * BenchmarkResult
+   * ---------------
+   */
+  struct BenchmarkResult {
+    std::string name;
+    u32 warmup = 0;
+    u32 repetitions = 0;
+    u64 operations = 1;
+    double medianNanoseconds = 0.0;
+    double p95Nanoseconds = 0.0;
+    double nanosecondsPerOperation = 0.0;
+  };
+
   void Gm_CompareBenchmarks(u64 a, u64 b);
+  u32 Gm_CompareBenchmarkResults(const std::vector<BenchmarkResult>& baseline, const std::vector<BenchmarkResult>& results, float threshold);
 
-  auto Gm_CreateTimer() {
+  inline auto Gm_CreateTimer() {
     auto start = std::chrono::system_clock::now();
 
-    return [&]() {
+    // Capture start by value, since the timer outlives this scope
+    return [start]() {
       auto end = std::chrono::system_clock::now();
 
       std::chrono::system_clock::duration duration = end - start;
@@ -22,8 +57,11 @@ namespace Gamma {
     };
   };
 
+  BenchmarkResult Gm_MeasureBenchmark(const BenchmarkCase& benchmark, u32 warmup, u32 repetitions);
+  std::vector<BenchmarkResult> Gm_ReadBenchmarkResults(const char* path);
   u64 Gm_RepeatBenchmarkTest(const std::function<void()>& test, u32 times = 1);
   u64 Gm_RunBenchmarkTest(const std::function<void()>& test);
   void Gm_RunLoopedBenchmarkTest(const std::function<void()>& test, u32 pause = 1000);
   void Gm_Sleep(u32 milliseconds);
+  bool Gm_WriteBenchmarkResults(const char* path, const std::vector<BenchmarkResult>& results);
 }
\ No newline at end of file
@@ -0,0 +1,288 @@
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <cstring>
+
+#include "performance/frame_stats.h"
+#include "system/console.h"
+#include "system/file.h"
+
+namespace Gamma {
+  /**
+   * Gm_GetFrameTimeBucket
+   * ---------------------
+   *
+   * Times below the sub-bucket count get exact buckets;
+   * above that, the bucket is determined by the time's
+   * highest set bit and the bits just below it.
+   */
+  static u32 Gm_GetFrameTimeBucket(u64 microseconds) {
+    if (microseconds < FRAME_TIME_SUB_BUCKETS) {
+      return (u32)microseconds;
+    }
+
+    u32 exponent = std::min((u32)std::bit_width(microseconds) - 1, FRAME_TIME_MAX_EXPONENT);
+    u32 shift = exponent - FRAME_TIME_SUB_BUCKET_BITS;
+    u32 subBucket = std::min((u32)(microseconds >> shift), 2 * FRAME_TIME_SUB_BUCKETS - 1) - FRAME_TIME_SUB_BUCKETS;
+
+    return FRAME_TIME_SUB_BUCKETS * (shift + 1) + subBucket;
+  }
+
+  static u64 Gm_GetFrameTimeBucketUpperBound(u32 bucket) {
+    if (bucket < FRAME_TIME_SUB_BUCKETS) {
+      return bucket;
+    }
+
+    u32 shift = bucket / FRAME_TIME_SUB_BUCKETS - 1;
+    u64 lowerBound = (u64)(FRAME_TIME_SUB_BUCKETS + bucket % FRAME_TIME_SUB_BUCKETS) << shift;
+
+    return lowerBound + (1ULL << shift) - 1;
+  }
+
+  void FrameTimeHistogram::add(u64 microseconds) {
+    counts[Gm_GetFrameTimeBucket(microseconds)]++;
+    totalSamples++;
+  }
+
+  void FrameTimeHistogram::clear() {
+    memset(counts, 0, sizeof(counts));
+
+    totalSamples = 0;
+  }
+
+  /**
+   * Returns the frame time which [fraction] of all frames
+   * are at or below, e.g. 0.99 for the 99th percentile.
+   */
+  u64 FrameTimeHistogram::percentile(float fraction) const {
+    if (totalSamples == 0) {
+      return 0;
+    }
+
+    u32 target = std::max(1U, (u32)((double)fraction * totalSamples + 0.5));
+    u32 cumulative = 0;
+
+    for (u32 i = 0; i < FRAME_TIME_BUCKETS; i++) {
+      cumulative += counts[i];
+
+      if (cumulative >= target) {
+        return Gm_GetFrameTimeBucketUpperBound(i);
+      }
+    }
+
+    return Gm_GetFrameTimeBucketUpperBound(FRAME_TIME_BUCKETS - 1);
+  }
+
+  void FrameTimeHistogram::remove(u64 microseconds) {
+    u32 bucket = Gm_GetFrameTimeBucket(microseconds);
+
+    if (counts[bucket] > 0) {
+      counts[bucket]--;
+      totalSamples--;
+    }
+  }
+
+  u32 FrameTimeHistogram::total() const {
+    return totalSamples;
+  }
+
+  FrameStats::FrameStats() {
+    setWindows({ 600, 0 });
+    setRecentFrames(120);
+    setHitchBudget(50000);
+  }
+
+  void FrameStats::addPhase(const char* name, u64 microseconds) {
+    if (currentFrame.totalPhases < MAX_FRAME_PHASES) {
+      currentFrame.phases[currentFrame.totalPhases++] = { name, microseconds };
+    }
+  }
+
+  /**
+   * Writes the recent frame records to a CSV file, oldest
+   * first, with a column for each phase.
+   */
+  void FrameStats::dumpRecentFrames(const std::string& path) const {
+    std::vector<const char*> phaseNames;
+    u32 totalFrameRecords = (u32)std::min(totalRecordedFrames, (u64)recentFrames.size());
+    u64 firstFrameRecord = totalRecordedFrames - totalFrameRecords;
+    char value[32];
+
+    for (u64 i = firstFrameRecord; i < totalRecordedFrames; i++) {
+      auto& record = recentFrames[i % recentFrames.size()];
+
+      for (u32 j = 0; j < record.totalPhases; j++) {
+        auto* name = record.phases[j].name;
+
+        auto isNewPhase = std::none_of(phaseNames.begin(), phaseNames.end(), [name](const char* phaseName) {
+          return strcmp(phaseName, name) == 0;
+        });
+
+        if (isNewPhase) {
+          phaseNames.push_back(name);
+        }
+      }
+    }
+
+    std::string csv = "frame,total_ms";
+
+    for (auto* name : phaseNames) {
+      csv += ",";
+      csv += name;
+      csv += "_ms";
+    }
+
+    csv += "\n";
+
+    for (u64 i = firstFrameRecord; i < totalRecordedFrames; i++) {
+      auto& record = recentFrames[i % recentFrames.size()];
+
+      snprintf(value, sizeof(value), "%u,%.3f", record.frame, record.microseconds / 1000.0);
+
+      csv += value;
+
+      for (auto* name : phaseNames) {
+        u64 microseconds = 0;
+
+        for (u32 j = 0; j < record.totalPhases; j++) {
+          if (strcmp(record.phases[j].name, name) == 0) {
+            microseconds += record.phases[j].microseconds;
+          }
+        }
+
+        snprintf(value, sizeof(value), ",%.3f", microseconds / 1000.0);
+
+        csv += value;
+      }
+
+      csv += "\n";
+    }
+
+    Gm_WriteFileContents(path, csv);
+  }
+
+  /**
+   * Records a frame's total time, along with any phases added
+   * since the previous frame. Frames over the hitch budget
+   * dump the recent frame records, unless the frames from
+   * the previous dump haven't yet been cycled out.
+   */
+  void FrameStats::endFrame(u32 frame, u64 microseconds) {
+    currentFrame.frame = frame;
+    currentFrame.microseconds = microseconds;
+
+    if (recentFrames.size() > 0) {
+      recentFrames[totalRecordedFrames++ % recentFrames.size()] = currentFrame;
+    }
+
+    currentFrame = FrameRecord();
+
+    // Update windowed histograms, removing each window's
+    // oldest frame time once it's full
+    for (auto& window : windows) {
+      if (window.size > 0 && totalFrames >= window.size) {
+        u64 oldest = frameTimes[(totalFrames - window.size) % frameTimes.size()];
+
+        window.histogram.remove(oldest);
+
+        if (oldest == window.max) {
+          window.max = 0;
+
+          for (u64 i = totalFrames - window.size + 1; i < totalFrames; i++) {
+            window.max = std::max(window.max, frameTimes[i % frameTimes.size()]);
+          }
+        }
+      }
+
+      window.histogram.add(microseconds);
+      window.max = std::max(window.max, microseconds);
+    }
+
+    frameTimes[totalFrames++ % frameTimes.size()] = microseconds;
+
+    bool isHitch = (
+      hitchBudget > 0 &&
+      microseconds > hitchBudget &&
+      totalFrames > warmupFrames &&
+      (lastHitchDumpFrame == 0 || totalFrames - lastHitchDumpFrame >= recentFrames.size())
+    );
+
+    if (isHitch) {
+      auto path = hitchDirectory + "/frame_" + std::to_string(frame) + ".csv";
+
+      dumpRecentFrames(path);
+
+      lastHitchDumpFrame = totalFrames;
+
+      Console::warn("[Gamma] Frame", frame, "took", std::to_string(microseconds / 1000) + "ms; recent frame timings written to", path);
+    }
+  }
+
+  FrameTimeSummary FrameStats::getSummary(u32 windowIndex) const {
+    FrameTimeSummary summary;
+
+    if (windowIndex >= windows.size()) {
+      return summary;
+    }
+
+    auto& window = windows[windowIndex];
+    auto& histogram = window.histogram;
+
+    summary.frames = histogram.total();
+    summary.p50 = histogram.percentile(0.5f);
+    summary.p90 = histogram.percentile(0.9f);
+    summary.p99 = histogram.percentile(0.99f);
+    summary.p999 = histogram.percentile(0.999f);
+    summary.max = window.max;
+
+    // Bucket bounds may overshoot the actual slowest frame
+    summary.p50 = std::min(summary.p50, summary.max);
+    summary.p90 = std::min(summary.p90, summary.max);
+    summary.p99 = std::min(summary.p99, summary.max);
+    summary.p999 = std::min(summary.p999, summary.max);
+
+    return summary;
+  }
+
+  u32 FrameStats::getWindowSize(u32 windowIndex) const {
+    return windowIndex < windows.size() ? windows[windowIndex].size : 0;
+  }
+
+  /**
+   * Sets the frame time above which recent frames are
+   * dumped to [directory]. A budget of 0 disables dumps.
+   */
+  void FrameStats::setHitchBudget(u64 microseconds, const std::string& directory) {
+    hitchBudget = microseconds;
+    hitchDirectory = directory;
+  }
+
+  void FrameStats::setRecentFrames(u32 size) {
+    recentFrames.assign(size, FrameRecord());
+
+    totalRecordedFrames = 0;
+  }
+
+  /**
+   * Sets the number of frames covered by each window, with
+   * 0 covering all frames. Resets all windows.
+   */
+  void FrameStats::setWindows(const std::vector<u32>& windowSizes) {
+    u32 largestWindowSize = 1;
+
+    windows.clear();
+
+    for (u32 size : windowSizes) {
+      Window window;
+
+      window.size = size;
+
+      windows.push_back(window);
+
+      largestWindowSize = std::max(largestWindowSize, size);
+    }
+
+    frameTimes.assign(largestWindowSize, 0);
+    totalFrames = 0;
+  }
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "system/type_aliases.h"
+
+namespace Gamma {
+  // Frame times are bucketed by power of 2, with each power
+  // of 2 split into linear sub-buckets, for ~3% precision
+  // from 1us up to 2^30us
+  constexpr static u32 FRAME_TIME_SUB_BUCKET_BITS = 5;
+  constexpr static u32 FRAME_TIME_SUB_BUCKETS = 1 << FRAME_TIME_SUB_BUCKET_BITS;
+  constexpr static u32 FRAME_TIME_MAX_EXPONENT = 30;
+  constexpr static u32 FRAME_TIME_BUCKETS = FRAME_TIME_SUB_BUCKETS * (FRAME_TIME_MAX_EXPONENT - FRAME_TIME_SUB_BUCKET_BITS + 2);
+  constexpr static u32 MAX_FRAME_PHASES = 8;
+
+  /**
+   * FrameTimeHistogram
+   * ------------------
+   *
+   * Counts of frame times in log-scaled buckets. Percentiles
+   * are reported as the upper bound of the bucket they fall
+   * in, so they never understate a frame time.
+   */
+  class FrameTimeHistogram {
+  public:
+    void add(u64 microseconds);
+    void clear();
+    u64 percentile(float fraction) const;
+    void remove(u64 microseconds);
+    u32 total() const;
+
+  private:
+    u32 counts[FRAME_TIME_BUCKETS] = {};
+    u32 totalSamples = 0;
+  };
+
+  /**
+   * FrameTimeSummary
+   * ----------------
+   *
+   * Frame time percentiles over a window, in microseconds.
+   */
+  struct FrameTimeSummary {
+    u32 frames = 0;
+    u64 p50 = 0;
+    u64 p90 = 0;
+    u64 p99 = 0;
+    u64 p999 = 0;
+    u64 max = 0;
+  };
+
+  struct FramePhaseTime {
+    const char* name = nullptr;
+    u64 microseconds = 0;
+  };
+
+  /**
+   * FrameRecord
+   * -----------
+   *
+   * A frame's total time and the time spent in each of its
+   * phases, kept for hitch diagnosis.
+   */
+  struct FrameRecord {
+    u32 frame = 0;
+    u64 microseconds = 0;
+    u32 totalPhases = 0;
+    FramePhaseTime phases[MAX_FRAME_PHASES];
+  };
+
+  /**
+   * FrameStats
+   * ----------
+   *
+   * Tracks frame time percentiles over one or more windows
+   * of recent frames, and keeps the phase timings of the
+   * last few frames. When a frame exceeds the hitch budget,
+   * those frames are written to a file so the hitch can be
+   * diagnosed afterward.
+   */
+  class FrameStats {
+  public:
+    FrameStats();
+
+    void addPhase(const char* name, u64 microseconds);
+    void dumpRecentFrames(const std::string& path) const;
+    void endFrame(u32 frame, u64 microseconds);
+    FrameTimeSummary getSummary(u32 windowIndex = 0) const;
+    u32 getWindowSize(u32 windowIndex = 0) const;
+    void setHitchBudget(u64 microseconds, const std::string& directory = "./hitches");
+    void setRecentFrames(u32 size);
+    void setWindows(const std::vector<u32>& windowSizes);
+
+  private:
+    /**
+     * A histogram over the last [size] frames, or over all
+     * frames if [size] is 0.
+     */
+    struct Window {
+      u32 size = 0;
+      u64 max = 0;
+      FrameTimeHistogram histogram;
+    };
+
+    std::vector<Window> windows;
+    std::vector<u64> frameTimes;
+    u64 totalFrames = 0;
+    std::vector<FrameRecord> recentFrames;
+    u64 totalRecordedFrames = 0;
+    FrameRecord currentFrame;
+    u64 hitchBudget = 0;
+    std::string hitchDirectory;
+    u64 lastHitchDumpFrame = 0;
+    u32 warmupFrames = 60;
+  };
+}
\ No newline at end of file
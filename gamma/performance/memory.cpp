@@ -0,0 +1,69 @@
+#include <atomic>
+
+#include "performance/memory.h"
+#include "system/file.h"
+
+namespace Gamma {
+  static std::atomic<s64> trackedMemory[TOTAL_MEMORY_CATEGORIES];
+
+  const static char* memoryCategoryNames[TOTAL_MEMORY_CATEGORIES] = {
+    "object_pools",
+    "mesh_geometry",
+    "yaml",
+    "console",
+    "gpu_geometry",
+    "gpu_stream_buffers",
+    "gpu_meshes",
+    "gpu_textures",
+    "gpu_framebuffers",
+    "gpu_shadow_maps"
+  };
+
+  const char* Gm_GetMemoryCategoryName(MemoryCategory category) {
+    return memoryCategoryNames[(u32)category];
+  }
+
+  u64 Gm_GetTrackedMemory(MemoryCategory category) {
+    s64 bytes = trackedMemory[(u32)category].load(std::memory_order_relaxed);
+
+    return bytes > 0 ? (u64)bytes : 0;
+  }
+
+  bool Gm_IsGpuMemoryCategory(MemoryCategory category) {
+    return category >= MemoryCategory::GPU_GEOMETRY;
+  }
+
+  /**
+   * Gm_TrackMemory
+   * --------------
+   *
+   * Adds to (or, with negative bytes, subtracts from) the
+   * memory tracked for a category. Safe to call from any
+   * thread.
+   */
+  void Gm_TrackMemory(MemoryCategory category, s64 bytes) {
+    trackedMemory[(u32)category].fetch_add(bytes, std::memory_order_relaxed);
+  }
+
+  /**
+   * Gm_WriteMemorySnapshot
+   * ----------------------
+   *
+   * Writes a snapshot to a CSV file, with a total row for
+   * each category followed by a row for each mesh.
+   */
+  void Gm_WriteMemorySnapshot(const std::string& path, const MemorySnapshot& snapshot) {
+    std::string csv = "category,name,bytes\n";
+
+    for (u32 i = 0; i < TOTAL_MEMORY_CATEGORIES; i++) {
+      csv += std::string(memoryCategoryNames[i]) + ",total," + std::to_string(snapshot.bytes[i]) + "\n";
+    }
+
+    for (auto& mesh : snapshot.meshes) {
+      csv += std::string(Gm_GetMemoryCategoryName(MemoryCategory::OBJECT_POOLS)) + "," + mesh.name + "," + std::to_string(mesh.objectPoolBytes) + "\n";
+      csv += std::string(Gm_GetMemoryCategoryName(MemoryCategory::MESH_GEOMETRY)) + "," + mesh.name + "," + std::to_string(mesh.geometryBytes) + "\n";
+    }
+
+    Gm_WriteFileContents(path, csv);
+  }
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "system/type_aliases.h"
+
+namespace Gamma {
+  /**
+   * MemoryCategory
+   * --------------
+   *
+   * Categories of CPU memory and estimated GPU memory.
+   * Object pools and mesh geometry are measured from the
+   * scene when taking a snapshot; all other categories are
+   * tracked as their allocations are made and freed.
+   */
+  enum class MemoryCategory {
+    OBJECT_POOLS,
+    MESH_GEOMETRY,
+    YAML,
+    CONSOLE,
+    GPU_GEOMETRY,
+    GPU_STREAM_BUFFERS,
+    GPU_MESHES,
+    GPU_TEXTURES,
+    GPU_FRAMEBUFFERS,
+    GPU_SHADOW_MAPS
+  };
+
+  constexpr static u32 TOTAL_MEMORY_CATEGORIES = (u32)MemoryCategory::GPU_SHADOW_MAPS + 1;
+
+  /**
+   * MeshMemoryUsage
+   * ---------------
+   *
+   * The CPU memory used by a single mesh's object pool
+   * and geometry.
+   */
+  struct MeshMemoryUsage {
+    std::string name;
+    u64 objectPoolBytes = 0;
+    u64 geometryBytes = 0;
+  };
+
+  struct MemorySnapshot {
+    u64 bytes[TOTAL_MEMORY_CATEGORIES] = {};
+    std::vector<MeshMemoryUsage> meshes;
+  };
+
+  const char* Gm_GetMemoryCategoryName(MemoryCategory category);
+  u64 Gm_GetTrackedMemory(MemoryCategory category);
+  bool Gm_IsGpuMemoryCategory(MemoryCategory category);
+  void Gm_TrackMemory(MemoryCategory category, s64 bytes);
+  void Gm_WriteMemorySnapshot(const std::string& path, const MemorySnapshot& snapshot);
+}
\ No newline at end of file
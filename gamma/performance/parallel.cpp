@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "performance/parallel.h"
+
+namespace Gamma {
+  struct ParallelJob {
+    const std::function<void(u32, u32)>* handler = nullptr;
+    u32 total = 0;
+    u32 batchSize = 0;
+    u32 totalBatches = 0;
+    std::atomic<u32> nextBatch = 0;
+    std::atomic<u32> completedBatches = 0;
+    std::atomic<u32> activeWorkers = 0;
+  };
+
+  static thread_local bool isRunningParallelJob = false;
+
+  /**
+   * WorkerPool
+   * ----------
+   *
+   * A set of worker threads which sleep until a job is
+   * posted, then pull batches from it until none remain.
+   */
+  class WorkerPool {
+  public:
+    WorkerPool() {
+      u32 totalWorkers = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+
+      for (u32 i = 0; i < totalWorkers; i++) {
+        workers.emplace_back(&WorkerPool::work, this);
+      }
+    }
+
+    ~WorkerPool() {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        isStopping = true;
+      }
+
+      signal.notify_all();
+
+      for (auto& worker : workers) {
+        worker.join();
+      }
+    }
+
+    u32 totalThreads() const {
+      return workers.size() + 1;
+    }
+
+    void run(ParallelJob& job) {
+      // Only one job may be posted at a time
+      std::lock_guard<std::mutex> runLock(runMutex);
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        currentJob = &job;
+        generation++;
+      }
+
+      signal.notify_all();
+
+      processJob(job);
+
+      while (job.completedBatches.load() < job.totalBatches) {
+        std::this_thread::yield();
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        currentJob = nullptr;
+      }
+
+      // Workers may still be holding the job after its final
+      // batch is claimed; wait for them to let go of it before
+      // it leaves the caller's stack
+      while (job.activeWorkers.load() > 0) {
+        std::this_thread::yield();
+      }
+    }
+
+  private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::mutex runMutex;
+    std::condition_variable signal;
+    ParallelJob* currentJob = nullptr;
+    u64 generation = 0;
+    bool isStopping = false;
+
+    static void processJob(ParallelJob& job) {
+      isRunningParallelJob = true;
+
+      while (true) {
+        u32 batch = job.nextBatch.fetch_add(1);
+
+        if (batch >= job.totalBatches) {
+          break;
+        }
+
+        u32 start = batch * job.batchSize;
+        u32 end = std::min(start + job.batchSize, job.total);
+
+        (*job.handler)(start, end);
+
+        job.completedBatches.fetch_add(1);
+      }
+
+      isRunningParallelJob = false;
+    }
+
+    void work() {
+      u64 lastGeneration = 0;
+
+      while (true) {
+        ParallelJob* job = nullptr;
+
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+
+          signal.wait(lock, [&]() {
+            return isStopping || generation != lastGeneration;
+          });
+
+          if (isStopping) {
+            return;
+          }
+
+          lastGeneration = generation;
+          job = currentJob;
+
+          if (job != nullptr) {
+            job->activeWorkers.fetch_add(1);
+          }
+        }
+
+        if (job != nullptr) {
+          processJob(*job);
+
+          job->activeWorkers.fetch_sub(1);
+        }
+      }
+    }
+  };
+
+  static WorkerPool& Gm_GetWorkerPool() {
+    static WorkerPool pool;
+
+    return pool;
+  }
+
+  void Gm_ParallelFor(u32 total, u32 batchSize, const std::function<void(u32 start, u32 end)>& handler) {
+    if (total == 0) {
+      return;
+    }
+
+    batchSize = std::max(batchSize, 1u);
+
+    if (total <= batchSize || isRunningParallelJob) {
+      handler(0, total);
+
+      return;
+    }
+
+    auto& pool = Gm_GetWorkerPool();
+
+    if (pool.totalThreads() == 1) {
+      handler(0, total);
+
+      return;
+    }
+
+    ParallelJob job;
+
+    job.handler = &handler;
+    job.total = total;
+    job.batchSize = batchSize;
+    job.totalBatches = (total + batchSize - 1) / batchSize;
+
+    pool.run(job);
+  }
+
+  u32 Gm_GetTotalParallelThreads() {
+    return Gm_GetWorkerPool().totalThreads();
+  }
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <functional>
+
+#include "system/type_aliases.h"
+
+namespace Gamma {
+  /**
+   * Gm_ParallelFor
+   * --------------
+   *
+   * Splits the range [0, total) into batches of up to
+   * batchSize elements and runs the handler on each batch
+   * across a persistent pool of worker threads, including
+   * the calling thread. Returns once all batches finish.
+   *
+   * Nested calls from within a handler run serially on
+   * the calling thread.
+   */
+  void Gm_ParallelFor(u32 total, u32 batchSize, const std::function<void(u32 start, u32 end)>& handler);
+  u32 Gm_GetTotalParallelThreads();
+}
\ No newline at end of file
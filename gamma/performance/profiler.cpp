@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+
+#include "performance/profiler.h"
+
+namespace Gamma {
+  static std::mutex bufferMutex;
+  static std::vector<ProfileThreadBuffer*> threadBuffers;
+  // The next unaggregated event index for each thread buffer
+  static std::vector<u64> aggregatedHeads;
+  static std::vector<ProfileAggregate> aggregates;
+  static const u64 calibrationTicks = Gm_GetProfilerTicks();
+  static const auto calibrationTime = std::chrono::steady_clock::now();
+
+  /**
+   * Gm_CollectEvents
+   * ----------------
+   *
+   * Copies a thread buffer's events in [from, head) which
+   * haven't yet been overwritten.
+   */
+  static void Gm_CollectEvents(ProfileThreadBuffer* buffer, u64 from, u64 head, std::vector<ProfileEvent>& events) {
+    if (head - from > PROFILE_BUFFER_SIZE) {
+      from = head - PROFILE_BUFFER_SIZE;
+    }
+
+    for (u64 i = from; i < head; i++) {
+      events.push_back(buffer->events[i & (PROFILE_BUFFER_SIZE - 1)]);
+    }
+  }
+
+  /**
+   * Gm_CreateProfileThreadBuffer
+   * ----------------------------
+   *
+   * Registers a buffer for the calling thread. Buffers are
+   * never freed, since events may still be read after
+   * their threads have exited.
+   */
+  ProfileThreadBuffer* Gm_CreateProfileThreadBuffer() {
+    std::lock_guard<std::mutex> lock(bufferMutex);
+
+    auto* buffer = new ProfileThreadBuffer();
+
+    buffer->threadId = threadBuffers.size();
+
+    threadBuffers.push_back(buffer);
+    aggregatedHeads.push_back(0);
+
+    return buffer;
+  }
+
+  /**
+   * Gm_GetNanosecondsPerProfilerTick
+   * --------------------------------
+   *
+   * Measures the profiler clock rate against the system
+   * clock since startup, so the estimate improves as the
+   * program runs.
+   */
+  double Gm_GetNanosecondsPerProfilerTick() {
+    #if GAMMA_USE_RDTSC
+      u64 ticks = Gm_GetProfilerTicks() - calibrationTicks;
+      auto time = std::chrono::steady_clock::now() - calibrationTime;
+      double nanoseconds = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+
+      return ticks > 0 ? nanoseconds / (double)ticks : 1.0;
+    #else
+      return 1.0;
+    #endif
+  }
+
+  /**
+   * Gm_GetProfileAggregates
+   * -----------------------
+   *
+   * Returns the scope aggregates computed by the last call
+   * to Gm_UpdateProfileAggregates(), ordered by the start
+   * time of each scope's first call.
+   */
+  const std::vector<ProfileAggregate>& Gm_GetProfileAggregates() {
+    return aggregates;
+  }
+
+  /**
+   * Gm_UpdateProfileAggregates
+   * --------------------------
+   *
+   * Aggregates all events completed since the previous
+   * call, e.g. over the previous frame. Scopes which are
+   * still open are counted once they complete.
+   */
+  void Gm_UpdateProfileAggregates() {
+    std::lock_guard<std::mutex> lock(bufferMutex);
+    std::vector<ProfileEvent> events;
+
+    for (u32 i = 0; i < threadBuffers.size(); i++) {
+      u64 head = threadBuffers[i]->head.load(std::memory_order_acquire);
+
+      Gm_CollectEvents(threadBuffers[i], aggregatedHeads[i], head, events);
+
+      aggregatedHeads[i] = head;
+    }
+
+    std::sort(events.begin(), events.end(), [](const ProfileEvent& a, const ProfileEvent& b) {
+      return a.start < b.start;
+    });
+
+    aggregates.clear();
+
+    double nanosecondsPerTick = Gm_GetNanosecondsPerProfilerTick();
+
+    for (auto& event : events) {
+      u64 duration = u64((event.end - event.start) * nanosecondsPerTick);
+      ProfileAggregate* aggregate = nullptr;
+
+      for (auto& existing : aggregates) {
+        if (existing.name == event.name && existing.depth == event.depth) {
+          aggregate = &existing;
+
+          break;
+        }
+      }
+
+      if (aggregate == nullptr) {
+        aggregate = &aggregates.emplace_back();
+
+        aggregate->name = event.name;
+        aggregate->depth = event.depth;
+      }
+
+      aggregate->calls++;
+      aggregate->totalNanoseconds += duration;
+      aggregate->maxNanoseconds = std::max(aggregate->maxNanoseconds, duration);
+    }
+  }
+
+  /**
+   * Gm_WriteProfileTrace
+   * --------------------
+   *
+   * Writes all buffered events as a Chrome trace event
+   * file, which can be opened in chrome://tracing or the
+   * Perfetto UI. Returns false if the file couldn't be
+   * opened for writing.
+   */
+  bool Gm_WriteProfileTrace(const std::string& path) {
+    std::lock_guard<std::mutex> lock(bufferMutex);
+    FILE* file = fopen(path.c_str(), "w");
+
+    if (file == nullptr) {
+      return false;
+    }
+
+    std::vector<ProfileEvent> events;
+    std::vector<u32> eventThreadIds;
+    u64 firstStart = UINT64_MAX;
+
+    for (auto* buffer : threadBuffers) {
+      u64 head = buffer->head.load(std::memory_order_acquire);
+
+      Gm_CollectEvents(buffer, 0, head, events);
+      eventThreadIds.resize(events.size(), buffer->threadId);
+    }
+
+    for (auto& event : events) {
+      firstStart = std::min(firstStart, event.start);
+    }
+
+    // Convert ticks to microseconds
+    double scale = Gm_GetNanosecondsPerProfilerTick() / 1000.0;
+
+    fputs("{\"traceEvents\":[\n", file);
+
+    for (u32 i = 0; i < events.size(); i++) {
+      auto& event = events[i];
+
+      fprintf(
+        file,
+        "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+        i > 0 ? ",\n" : "",
+        event.name,
+        eventThreadIds[i],
+        (event.start - firstStart) * scale,
+        (event.end - event.start) * scale
+      );
+    }
+
+    fputs("\n],\"displayTimeUnit\":\"ns\"}\n", file);
+    fclose(file);
+
+    return true;
+  }
+}
\ No newline at end of file
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "system/flags.h"
+#include "system/type_aliases.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+  #define GAMMA_USE_RDTSC 1
+
+  #if defined(_MSC_VER)
+    #include <intrin.h>
+  #else
+    #include <x86intrin.h>
+  #endif
+#endif
+
+#ifndef GAMMA_ENABLE_PROFILER
+  #if GAMMA_DEVELOPER_MODE
+    #define GAMMA_ENABLE_PROFILER 1
+  #else
+    #define GAMMA_ENABLE_PROFILER 0
+  #endif
+#endif
+
+#define _GM_PROFILE_CONCAT(a, b) a##b
+#define _GM_PROFILE_NAME(line) _GM_PROFILE_CONCAT(_gm_profile_scope_, line)
+
+#if GAMMA_ENABLE_PROFILER
+  #define GM_PROFILE_SCOPE(name) Gamma::ProfileScope _GM_PROFILE_NAME(__LINE__)(name)
+#else
+  #define GM_PROFILE_SCOPE(name)
+#endif
+
+namespace Gamma {
+  // Must be a power of 2
+  constexpr static u32 PROFILE_BUFFER_SIZE = 1 << 14;
+
+  /**
+   * ProfileEvent
+   * ------------
+   *
+   * A single timed scope. Timestamps are in profiler
+   * ticks; see Gm_GetProfilerTicks().
+   */
+  struct ProfileEvent {
+    const char* name = nullptr;
+    u64 start = 0;
+    u64 end = 0;
+    u32 depth = 0;
+  };
+
+  /**
+   * ProfileThreadBuffer
+   * -------------------
+   *
+   * A ring buffer of the most recent scopes completed
+   * on one thread. Only the owning thread writes to it;
+   * head is published after each write so other threads
+   * can read completed events.
+   */
+  struct ProfileThreadBuffer {
+    u32 threadId = 0;
+    u32 depth = 0;
+    std::atomic<u64> head = 0;
+    ProfileEvent events[PROFILE_BUFFER_SIZE];
+  };
+
+  /**
+   * ProfileAggregate
+   * ----------------
+   *
+   * Totals for all calls to a scope at a given depth
+   * over one frame, across all threads.
+   */
+  struct ProfileAggregate {
+    const char* name = nullptr;
+    u32 depth = 0;
+    u32 calls = 0;
+    u64 totalNanoseconds = 0;
+    u64 maxNanoseconds = 0;
+  };
+
+  ProfileThreadBuffer* Gm_CreateProfileThreadBuffer();
+  double Gm_GetNanosecondsPerProfilerTick();
+  const std::vector<ProfileAggregate>& Gm_GetProfileAggregates();
+  void Gm_UpdateProfileAggregates();
+  bool Gm_WriteProfileTrace(const std::string& path);
+
+  /**
+   * Returns a timestamp from the cheapest available clock:
+   * the CPU timestamp counter where supported, which is
+   * calibrated against the system clock, and otherwise
+   * nanoseconds from the system clock.
+   */
+  inline u64 Gm_GetProfilerTicks() {
+    #if GAMMA_USE_RDTSC
+      return __rdtsc();
+    #else
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    #endif
+  }
+
+  inline ProfileThreadBuffer* Gm_GetProfileThreadBuffer() {
+    thread_local ProfileThreadBuffer* buffer = Gm_CreateProfileThreadBuffer();
+
+    return buffer;
+  }
+
+  /**
+   * ProfileScope
+   * ------------
+   *
+   * Records the time between its construction and
+   * destruction into the current thread's buffer.
+   * Use GM_PROFILE_SCOPE() rather than constructing
+   * these directly, so scopes compile out when the
+   * profiler is disabled.
+   */
+  class ProfileScope {
+  public:
+    ProfileScope(const char* name) : name(name) {
+      buffer = Gm_GetProfileThreadBuffer();
+      depth = buffer->depth++;
+      start = Gm_GetProfilerTicks();
+    }
+
+    ~ProfileScope() {
+      u64 end = Gm_GetProfilerTicks();
+      u64 head = buffer->head.load(std::memory_order_relaxed);
+      auto& event = buffer->events[head & (PROFILE_BUFFER_SIZE - 1)];
+
+      event.name = name;
+      event.start = start;
+      event.end = end;
+      event.depth = depth;
+
+      buffer->depth--;
+      buffer->head.store(head + 1, std::memory_order_release);
+    }
+
+  private:
+    ProfileThreadBuffer* buffer = nullptr;
+    const char* name = nullptr;
+    u64 start = 0;
+    u32 depth = 0;
+  };
+}
\ No newline at end of file
@@ -3,17 +3,16 @@
 #include "system/type_aliases.h"
 
 namespace Gamma {
+  /**
+   * Averager
+   * --------
+   *
+   * Tracks the last [size] values added. Empty averagers
+   * report 0 for their average, high and low.
+   */
   template<u32 size, typename T>
   class Averager {
   public:
-    Averager() {
-      values = new T[size];
-    }
-
-    ~Averager() {
-      delete[] values;
-    }
-
     void add(T value) {
       values[index++ % size] = value;
     }
@@ -22,6 +21,10 @@ namespace Gamma {
       T sum = (T)0;
       u32 total = index > size ? size : index;
 
+      if (total == 0) {
+        return (T)0;
+      }
+
       for (u32 i = 0; i < total; i++) {
         sum += values[i];
       }
@@ -43,10 +46,15 @@ namespace Gamma {
     }
 
     T low() {
-      T lowest = (T)values[0];
       u32 total = index > size ? size : index;
 
-      for (u32 i = 0; i < total; i++) {
+      if (total == 0) {
+        return (T)0;
+      }
+
+      T lowest = values[0];
+
+      for (u32 i = 1; i < total; i++) {
         if (values[i] < lowest) {
           lowest = values[i];
         }
@@ -56,7 +64,7 @@ namespace Gamma {
     }
 
   private:
-    T* values = nullptr;
+    T values[size] = {};
     u32 index = 0;
   };
 }
\ No newline at end of file
@@ -0,0 +1,292 @@
+#include <cmath>
+
+#include "math/simd.h"
+#include "performance/parallel.h"
+#include "physics/broadphase.h"
+#include "system/assert.h"
+
+namespace Gamma {
+  constexpr static u32 COLLISION_BATCH_SIZE = 32;
+  constexpr static u32 MAX_QUERY_BUCKETS = 64;
+
+  /**
+   * Gm_GetCollisionCell
+   * -------------------
+   */
+  static inline s32 Gm_GetCollisionCell(float value, float inverseCellSize) {
+    return (s32)floorf(value * inverseCellSize);
+  }
+
+  /**
+   * Gm_GetCollisionBucket
+   * ---------------------
+   */
+  static inline u32 Gm_GetCollisionBucket(const CollisionGrid& grid, s32 cellX, s32 cellZ) {
+    return (((u32)cellX * 73856093u) ^ ((u32)cellZ * 19349663u)) & (grid.totalBuckets - 1);
+  }
+
+  /**
+   * Gm_IsOverlapping
+   * ----------------
+   */
+  template<CollisionShape shape>
+  static inline bool Gm_IsOverlapping(float dx, float dz, float reach) {
+    if (shape == CollisionShape::AABB) {
+      return fabsf(dx) <= reach && fabsf(dz) <= reach;
+    } else {
+      return dx * dx + dz * dz <= reach * reach;
+    }
+  }
+
+  /**
+   * Gm_TestColliderRange
+   * --------------------
+   *
+   * Tests a single collider against a contiguous range of
+   * grid colliders, appending a pair for each overlap. Four
+   * grid colliders are tested at a time where SSE is
+   * available.
+   */
+  template<CollisionShape shape>
+  static void Gm_TestColliderRange(const CollisionLayer& colliders, u32 start, u32 end, float x, float z, float size, u32 id, std::vector<CollisionPair>& pairs) {
+    u32 i = start;
+
+    #if GAMMA_USE_SSE == 1
+      __m128 targetX = _mm_set1_ps(x);
+      __m128 targetZ = _mm_set1_ps(z);
+      __m128 targetSize = _mm_set1_ps(size);
+      __m128 signBit = _mm_set1_ps(-0.f);
+
+      for (; i + 4 <= end; i += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(&colliders.x[i]), targetX);
+        __m128 dz = _mm_sub_ps(_mm_loadu_ps(&colliders.z[i]), targetZ);
+        __m128 reach = _mm_add_ps(_mm_loadu_ps(&colliders.size[i]), targetSize);
+        int mask;
+
+        if (shape == CollisionShape::AABB) {
+          __m128 overlapX = _mm_cmple_ps(_mm_andnot_ps(signBit, dx), reach);
+          __m128 overlapZ = _mm_cmple_ps(_mm_andnot_ps(signBit, dz), reach);
+
+          mask = _mm_movemask_ps(_mm_and_ps(overlapX, overlapZ));
+        } else {
+          __m128 distance = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dz, dz));
+
+          mask = _mm_movemask_ps(_mm_cmple_ps(distance, _mm_mul_ps(reach, reach)));
+        }
+
+        if (mask != 0) {
+          for (u32 lane = 0; lane < 4; lane++) {
+            if (mask & (1 << lane)) {
+              pairs.push_back({ colliders.ids[i + lane], id });
+            }
+          }
+        }
+      }
+    #endif
+
+    for (; i < end; i++) {
+      float dx = colliders.x[i] - x;
+      float dz = colliders.z[i] - z;
+
+      if (Gm_IsOverlapping<shape>(dx, dz, colliders.size[i] + size)) {
+        pairs.push_back({ colliders.ids[i], id });
+      }
+    }
+  }
+
+  /**
+   * Gm_QueryCollisionGrid
+   * ---------------------
+   *
+   * Tests a single collider against all grid colliders in
+   * the buckets it may overlap. Each bucket is visited once,
+   * even when several cells hash to it, so no pair is
+   * reported twice.
+   */
+  template<CollisionShape shape>
+  static void Gm_QueryCollisionGrid(const CollisionGrid& grid, float x, float z, float size, u32 id, std::vector<CollisionPair>& pairs) {
+    auto& colliders = grid.colliders;
+    float inverseCellSize = 1.f / grid.cellSize;
+    // Grid colliders are bucketed by their centers, so extend
+    // the query by the largest grid collider size to reach
+    // colliders centered in neighboring cells
+    float reach = size + colliders.maxSize;
+    s32 x0 = Gm_GetCollisionCell(x - reach, inverseCellSize);
+    s32 x1 = Gm_GetCollisionCell(x + reach, inverseCellSize);
+    s32 z0 = Gm_GetCollisionCell(z - reach, inverseCellSize);
+    s32 z1 = Gm_GetCollisionCell(z + reach, inverseCellSize);
+    u64 totalCells = u64(x1 - x0 + 1) * u64(z1 - z0 + 1);
+
+    if (totalCells > MAX_QUERY_BUCKETS) {
+      // Very large colliders would visit most buckets anyway,
+      // so test them against every grid collider instead
+      Gm_TestColliderRange<shape>(colliders, 0, (u32)colliders.ids.size(), x, z, size, id, pairs);
+
+      return;
+    }
+
+    u32 buckets[MAX_QUERY_BUCKETS];
+    u32 totalBuckets = 0;
+
+    for (s32 cellZ = z0; cellZ <= z1; cellZ++) {
+      for (s32 cellX = x0; cellX <= x1; cellX++) {
+        u32 bucket = Gm_GetCollisionBucket(grid, cellX, cellZ);
+        bool isVisited = false;
+
+        for (u32 i = 0; i < totalBuckets; i++) {
+          if (buckets[i] == bucket) {
+            isVisited = true;
+
+            break;
+          }
+        }
+
+        if (!isVisited) {
+          buckets[totalBuckets++] = bucket;
+        }
+      }
+    }
+
+    for (u32 i = 0; i < totalBuckets; i++) {
+      u32 start = grid.bucketOffsets[buckets[i]];
+      u32 end = grid.bucketOffsets[buckets[i] + 1];
+
+      Gm_TestColliderRange<shape>(colliders, start, end, x, z, size, id, pairs);
+    }
+  }
+
+  /**
+   * Gm_AddCollider
+   * --------------
+   */
+  void Gm_AddCollider(CollisionLayer& layer, u32 id, float x, float z, float size) {
+    layer.x.push_back(x);
+    layer.z.push_back(z);
+    layer.size.push_back(size);
+    layer.ids.push_back(id);
+
+    if (size > layer.maxSize) {
+      layer.maxSize = size;
+    }
+  }
+
+  /**
+   * Gm_BuildCollisionGrid
+   * ---------------------
+   *
+   * Rebuilds a grid from the colliders in a layer, sorting
+   * them into buckets with a single counting sort pass.
+   * Intended to be rebuilt each frame from the layer with
+   * the most colliders, e.g. bullets, and then queried with
+   * the smaller layer.
+   */
+  void Gm_BuildCollisionGrid(CollisionGrid& grid, const CollisionLayer& layer) {
+    assert(grid.totalBuckets > 0 && (grid.totalBuckets & (grid.totalBuckets - 1)) == 0, "Collision grid bucket count must be a power of 2");
+
+    auto& offsets = grid.bucketOffsets;
+    auto& colliderBuckets = grid.colliderBuckets;
+    auto& colliders = grid.colliders;
+    u32 totalColliders = (u32)layer.ids.size();
+    float inverseCellSize = 1.f / grid.cellSize;
+
+    offsets.assign(grid.totalBuckets + 1, 0);
+    colliderBuckets.resize(totalColliders);
+
+    // Count the colliders in each bucket
+    for (u32 i = 0; i < totalColliders; i++) {
+      s32 cellX = Gm_GetCollisionCell(layer.x[i], inverseCellSize);
+      s32 cellZ = Gm_GetCollisionCell(layer.z[i], inverseCellSize);
+      u32 bucket = Gm_GetCollisionBucket(grid, cellX, cellZ);
+
+      colliderBuckets[i] = bucket;
+      offsets[bucket + 1]++;
+    }
+
+    for (u32 bucket = 1; bucket <= grid.totalBuckets; bucket++) {
+      offsets[bucket] += offsets[bucket - 1];
+    }
+
+    // Copy colliders into bucket order, using each bucket's
+    // start offset as its write cursor
+    colliders.x.resize(totalColliders);
+    colliders.z.resize(totalColliders);
+    colliders.size.resize(totalColliders);
+    colliders.ids.resize(totalColliders);
+    colliders.maxSize = layer.maxSize;
+
+    for (u32 i = 0; i < totalColliders; i++) {
+      u32 index = offsets[colliderBuckets[i]]++;
+
+      colliders.x[index] = layer.x[i];
+      colliders.z[index] = layer.z[i];
+      colliders.size[index] = layer.size[i];
+      colliders.ids[index] = layer.ids[i];
+    }
+
+    // Each cursor now sits at the start of the following
+    // bucket, so shift them back to restore start offsets
+    for (u32 bucket = grid.totalBuckets; bucket > 0; bucket--) {
+      offsets[bucket] = offsets[bucket - 1];
+    }
+
+    offsets[0] = 0;
+  }
+
+  /**
+   * Gm_ClearCollisionLayer
+   * ----------------------
+   */
+  void Gm_ClearCollisionLayer(CollisionLayer& layer) {
+    layer.x.clear();
+    layer.z.clear();
+    layer.size.clear();
+    layer.ids.clear();
+
+    layer.maxSize = 0.f;
+  }
+
+  /**
+   * Gm_FindCollisionPairs
+   * ---------------------
+   *
+   * Finds all overlapping pairs between the colliders in a
+   * grid and those in another layer. Layer colliders are
+   * queried in parallel batches, and pairs are returned in
+   * layer order regardless of how batches were scheduled.
+   */
+  void Gm_FindCollisionPairs(CollisionGrid& grid, const CollisionLayer& layer, CollisionShape shape, std::vector<CollisionPair>& pairs) {
+    u32 totalColliders = (u32)layer.ids.size();
+    u32 totalBatches = (totalColliders + COLLISION_BATCH_SIZE - 1) / COLLISION_BATCH_SIZE;
+    auto& batchPairs = grid.batchPairs;
+
+    pairs.clear();
+
+    if (totalColliders == 0 || grid.colliders.ids.size() == 0) {
+      return;
+    }
+
+    if (batchPairs.size() < totalBatches) {
+      batchPairs.resize(totalBatches);
+    }
+
+    for (u32 i = 0; i < totalBatches; i++) {
+      batchPairs[i].clear();
+    }
+
+    Gm_ParallelFor(totalColliders, COLLISION_BATCH_SIZE, [&](u32 start, u32 end) {
+      auto& batch = batchPairs[start / COLLISION_BATCH_SIZE];
+
+      for (u32 i = start; i < end; i++) {
+        if (shape == CollisionShape::AABB) {
+          Gm_QueryCollisionGrid<CollisionShape::AABB>(grid, layer.x[i], layer.z[i], layer.size[i], layer.ids[i], batch);
+        } else {
+          Gm_QueryCollisionGrid<CollisionShape::CIRCLE>(grid, layer.x[i], layer.z[i], layer.size[i], layer.ids[i], batch);
+        }
+      }
+    });
+
+    for (u32 i = 0; i < totalBatches; i++) {
+      pairs.insert(pairs.end(), batchPairs[i].begin(), batchPairs[i].end());
+    }
+  }
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vector>
+
+#include "system/type_aliases.h"
+
+namespace Gamma {
+  /**
+   * CollisionShape
+   * --------------
+   *
+   * The narrow-phase test used between colliders. Collider
+   * sizes are treated as half-extents for AABB tests, and
+   * as radii for circle tests.
+   */
+  enum class CollisionShape {
+    AABB,
+    CIRCLE
+  };
+
+  /**
+   * CollisionLayer
+   * --------------
+   *
+   * A set of square/circular colliders in the XZ plane, e.g.
+   * all active player bullets, stored as separate component
+   * arrays so they can be tested several at a time. Each
+   * collider carries a caller-defined id, typically the
+   * index of the entity it belongs to.
+   */
+  struct CollisionLayer {
+    std::vector<float> x;
+    std::vector<float> z;
+    std::vector<float> size;
+    std::vector<u32> ids;
+    float maxSize = 0.f;
+  };
+
+  /**
+   * CollisionPair
+   * -------------
+   *
+   * A pair of overlapping colliders, where a is the id of
+   * a collider in a CollisionGrid's layer, and b is the id
+   * of a collider in the layer tested against the grid.
+   */
+  struct CollisionPair {
+    u32 a = 0;
+    u32 b = 0;
+  };
+
+  /**
+   * CollisionGrid
+   * -------------
+   *
+   * A spatial hash over the XZ plane, dividing space into
+   * square cells of cellSize units and hashing each cell
+   * into one of totalBuckets buckets. Colliders are copied
+   * into bucket order when the grid is built, so each bucket
+   * is a contiguous run of colliders.
+   *
+   * cellSize should be on the order of the largest collider
+   * sizes in either layer, and totalBuckets must be a power
+   * of 2.
+   */
+  struct CollisionGrid {
+    float cellSize = 64.f;
+    u32 totalBuckets = 4096;
+    std::vector<u32> bucketOffsets;
+    std::vector<u32> colliderBuckets;
+    CollisionLayer colliders;
+    std::vector<std::vector<CollisionPair>> batchPairs;
+  };
+
+  void Gm_AddCollider(CollisionLayer& layer, u32 id, float x, float z, float size);
+  void Gm_BuildCollisionGrid(CollisionGrid& grid, const CollisionLayer& layer);
+  void Gm_ClearCollisionLayer(CollisionLayer& layer);
+  void Gm_FindCollisionPairs(CollisionGrid& grid, const CollisionLayer& layer, CollisionShape shape, std::vector<CollisionPair>& pairs);
+}
\ No newline at end of file
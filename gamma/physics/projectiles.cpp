@@ -0,0 +1,209 @@
+#include "math/matrix.h"
+#include "math/simd.h"
+#include "physics/projectiles.h"
+#include "system/assert.h"
+#include "system/entities.h"
+#include "system/ObjectPool.h"
+
+namespace Gamma {
+  /**
+   * Gm_WriteProjectileMatrix
+   * ------------------------
+   *
+   * Writes the (transposed) transformation matrix for an
+   * unrotated, uniformly-scaled instance, equivalent to
+   * Matrix4f::transformation(...).transpose() without
+   * the rotation/scale multiplication.
+   */
+  static inline void Gm_WriteProjectileMatrix(Matrix4f& matrix, float x, float y, float z, float scale) {
+    float* m = matrix.m;
+
+    #if GAMMA_USE_SSE == 1
+      _mm_storeu_ps(&m[0], _mm_set_ps(0.f, 0.f, 0.f, scale));
+      _mm_storeu_ps(&m[4], _mm_set_ps(0.f, 0.f, scale, 0.f));
+      _mm_storeu_ps(&m[8], _mm_set_ps(0.f, scale, 0.f, 0.f));
+      _mm_storeu_ps(&m[12], _mm_set_ps(1.f, z, y, x));
+    #else
+      m[0] = scale; m[1] = 0.f; m[2] = 0.f; m[3] = 0.f;
+      m[4] = 0.f; m[5] = scale; m[6] = 0.f; m[7] = 0.f;
+      m[8] = 0.f; m[9] = 0.f; m[10] = scale; m[11] = 0.f;
+      m[12] = x; m[13] = y; m[14] = z; m[15] = 1.f;
+    #endif
+  }
+
+  /**
+   * Gm_KillProjectile
+   * -----------------
+   *
+   * Marks a projectile for removal on the next update.
+   */
+  void Gm_KillProjectile(Projectiles& projectiles, u32 index) {
+    projectiles.lifetime[index] = 0.f;
+  }
+
+  /**
+   * Gm_ReserveProjectiles
+   * ---------------------
+   */
+  void Gm_ReserveProjectiles(Projectiles& projectiles, u32 max) {
+    // Pad to a multiple of 4 for SIMD loops
+    u32 capacity = (max + 3) & ~3u;
+
+    projectiles.x.assign(capacity, 0.f);
+    projectiles.y.assign(capacity, 0.f);
+    projectiles.z.assign(capacity, 0.f);
+    projectiles.vx.assign(capacity, 0.f);
+    projectiles.vy.assign(capacity, 0.f);
+    projectiles.vz.assign(capacity, 0.f);
+    projectiles.scale.assign(capacity, 0.f);
+    projectiles.lifetime.assign(capacity, 0.f);
+    projectiles.colors.assign(capacity, pVec4());
+    projectiles.total = 0;
+    projectiles.max = max;
+  }
+
+  /**
+   * Gm_SpawnProjectile
+   * ------------------
+   *
+   * Adds a projectile to the end of the live range. Returns
+   * false if the set is already full.
+   */
+  bool Gm_SpawnProjectile(Projectiles& projectiles, const Projectile& projectile) {
+    if (projectiles.total >= projectiles.max) {
+      return false;
+    }
+
+    u32 index = projectiles.total++;
+
+    projectiles.x[index] = projectile.position.x;
+    projectiles.y[index] = projectile.position.y;
+    projectiles.z[index] = projectile.position.z;
+    projectiles.vx[index] = projectile.velocity.x;
+    projectiles.vy[index] = projectile.velocity.y;
+    projectiles.vz[index] = projectile.velocity.z;
+    projectiles.scale[index] = projectile.scale;
+    projectiles.lifetime[index] = projectile.lifetime;
+    projectiles.colors[index] = pVec4(projectile.color);
+
+    return true;
+  }
+
+  /**
+   * Gm_UpdateProjectiles
+   * --------------------
+   *
+   * Advances all live projectiles by their velocities, plus
+   * an optional offset (e.g. for scrolling), and counts down
+   * their lifetimes. Projectiles with no remaining lifetime,
+   * including those passed to Gm_KillProjectile, are then
+   * removed by moving the last live projectile into their
+   * place.
+   */
+  void Gm_UpdateProjectiles(Projectiles& projectiles, float dt, const Vec3f& offset) {
+    #if GAMMA_USE_SSE == 1
+      u32 end = (projectiles.total + 3) & ~3u;
+      __m128 delta = _mm_set1_ps(dt);
+      __m128 offsetX = _mm_set1_ps(offset.x);
+      __m128 offsetY = _mm_set1_ps(offset.y);
+      __m128 offsetZ = _mm_set1_ps(offset.z);
+
+      for (u32 i = 0; i < end; i += 4) {
+        __m128 x = _mm_loadu_ps(&projectiles.x[i]);
+        __m128 y = _mm_loadu_ps(&projectiles.y[i]);
+        __m128 z = _mm_loadu_ps(&projectiles.z[i]);
+        __m128 lifetime = _mm_loadu_ps(&projectiles.lifetime[i]);
+
+        x = _mm_add_ps(x, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&projectiles.vx[i]), delta), offsetX));
+        y = _mm_add_ps(y, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&projectiles.vy[i]), delta), offsetY));
+        z = _mm_add_ps(z, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&projectiles.vz[i]), delta), offsetZ));
+        lifetime = _mm_sub_ps(lifetime, delta);
+
+        _mm_storeu_ps(&projectiles.x[i], x);
+        _mm_storeu_ps(&projectiles.y[i], y);
+        _mm_storeu_ps(&projectiles.z[i], z);
+        _mm_storeu_ps(&projectiles.lifetime[i], lifetime);
+      }
+    #else
+      for (u32 i = 0; i < projectiles.total; i++) {
+        projectiles.x[i] += projectiles.vx[i] * dt + offset.x;
+        projectiles.y[i] += projectiles.vy[i] * dt + offset.y;
+        projectiles.z[i] += projectiles.vz[i] * dt + offset.z;
+        projectiles.lifetime[i] -= dt;
+      }
+    #endif
+
+    // Compact the live range
+    u32 index = 0;
+
+    while (index < projectiles.total) {
+      if (projectiles.lifetime[index] > 0.f) {
+        index++;
+
+        continue;
+      }
+
+      u32 last = --projectiles.total;
+
+      projectiles.x[index] = projectiles.x[last];
+      projectiles.y[index] = projectiles.y[last];
+      projectiles.z[index] = projectiles.z[last];
+      projectiles.vx[index] = projectiles.vx[last];
+      projectiles.vy[index] = projectiles.vy[last];
+      projectiles.vz[index] = projectiles.vz[last];
+      projectiles.scale[index] = projectiles.scale[last];
+      projectiles.lifetime[index] = projectiles.lifetime[last];
+      projectiles.colors[index] = projectiles.colors[last];
+    }
+  }
+
+  /**
+   * Gm_WriteProjectileInstances
+   * ---------------------------
+   *
+   * Writes instance matrices and colors for all live
+   * projectiles directly into a pair of object pools: one
+   * for the projectile cores, and one for their glows,
+   * scaled by glowScale. Each pool's visible range is set
+   * to the live projectile count, so no Gm_Commit() calls
+   * are needed, and dead projectiles are never drawn.
+   *
+   * Both pools must have at least as many active objects
+   * as there are live projectiles.
+   */
+  void Gm_WriteProjectileInstances(const Projectiles& projectiles, ObjectPool& cores, ObjectPool& glows, float glowScale) {
+    u32 total = projectiles.total;
+
+    assert(total <= cores.totalActive() && total <= glows.totalActive(), "Not enough objects to write " + std::to_string(total) + " projectiles");
+
+    Matrix4f* coreMatrices = cores.getMatrices();
+    Matrix4f* glowMatrices = glows.getMatrices();
+    pVec4* coreColors = cores.getColors();
+    pVec4* glowColors = glows.getColors();
+
+    for (u32 i = 0; i < total; i++) {
+      float x = projectiles.x[i];
+      float y = projectiles.y[i];
+      float z = projectiles.z[i];
+      float scale = projectiles.scale[i];
+      float glowSize = scale * glowScale;
+      auto& color = projectiles.colors[i];
+      auto& core = cores[i];
+      auto& glow = glows[i];
+
+      Gm_WriteProjectileMatrix(coreMatrices[i], x, y, z, scale);
+      Gm_WriteProjectileMatrix(glowMatrices[i], x, y, z, glowSize);
+
+      coreColors[i] = color;
+      glowColors[i] = color;
+
+      // Keep object positions/scales in sync for CPU-side culling
+      core.position = glow.position = Vec3f(x, y, z);
+      core.scale = Vec3f(scale);
+      glow.scale = Vec3f(glowSize);
+    }
+
+    cores.setTotalVisible((u16)total);
+    glows.setTotalVisible((u16)total);
+  }
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+
+#include "math/vector.h"
+#include "system/packed_data.h"
+#include "system/type_aliases.h"
+
+namespace Gamma {
+  class ObjectPool;
+
+  /**
+   * Projectile
+   * ----------
+   *
+   * Describes a single projectile to spawn into a
+   * Projectiles set.
+   */
+  struct Projectile {
+    Vec3f velocity = Vec3f(0.f);
+    Vec3f position = Vec3f(0.f);
+    Vec3f color = Vec3f(1.f);
+    float scale = 1.f;
+    /**
+     * The time in seconds before the projectile is
+     * automatically removed.
+     */
+    float lifetime = 1.f;
+  };
+
+  /**
+   * Projectiles
+   * -----------
+   *
+   * A set of simple moving projectiles (e.g. bullets), stored
+   * as separate component arrays so they can be integrated
+   * several at a time. Live projectiles occupy indices
+   * [0, total); removed projectiles are compacted out of
+   * that range by Gm_UpdateProjectiles, so indices are
+   * only stable between updates.
+   *
+   * Arrays are padded to a multiple of 4 elements, allowing
+   * SIMD loops to run past total without a scalar tail.
+   */
+  struct Projectiles {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<float> vx;
+    std::vector<float> vy;
+    std::vector<float> vz;
+    std::vector<float> scale;
+    std::vector<float> lifetime;
+    std::vector<pVec4> colors;
+    u32 total = 0;
+    u32 max = 0;
+  };
+
+  void Gm_KillProjectile(Projectiles& projectiles, u32 index);
+  void Gm_ReserveProjectiles(Projectiles& projectiles, u32 max);
+  bool Gm_SpawnProjectile(Projectiles& projectiles, const Projectile& projectile);
+  void Gm_UpdateProjectiles(Projectiles& projectiles, float dt, const Vec3f& offset = Vec3f(0.f));
+  void Gm_WriteProjectileInstances(const Projectiles& projectiles, ObjectPool& cores, ObjectPool& glows, float glowScale);
+}
\ No newline at end of file
@@ -1,3 +1,4 @@
+#include <cstdio>
 #include <iostream>
 #include <string>
 #include <algorithm>
@@ -50,10 +51,9 @@ namespace Gamma {
   }
 
   void AbstractLoader::load(const char* filePath) {
-    FILE* f;
-    errno_t err = fopen_s(&f, filePath, "r");
+    FILE* f = fopen(filePath, "r");
 
-    assert(err == 0, "[Gamma] AbstractLoader failed to load file:" + std::string(filePath));
+    assert(f != nullptr, "[Gamma] AbstractLoader failed to load file:" + std::string(filePath));
 
     file = f;
     isLoading = true;
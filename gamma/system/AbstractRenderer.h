@@ -1,5 +1,12 @@
 #pragma once
 
+#include <string>
+#include <vector>
+
+#include "SDL_ttf.h"
+
+#include "math/plane.h"
+#include "math/vector.h"
 #include "system/traits.h"
 #include "system/type_aliases.h"
 
@@ -21,10 +28,32 @@ namespace Gamma {
     bool useStableTemporalSampling = false;
   };
 
+  /**
+   * RenderPassTime
+   * --------------
+   *
+   * The GPU time spent on a render pass in a recent frame.
+   */
+  struct RenderPassTime {
+    const char* name = nullptr;
+    u64 gpuNanoseconds = 0;
+  };
+
   struct RenderStats {
     u32 gpuMemoryTotal = 0;
     u32 gpuMemoryUsed = 0;
     bool isVSynced = false;
+    /**
+     * Shadow caster instances submitted to/culled from
+     * point and spot light shadow maps in the last frame.
+     */
+    u32 shadowCastersSubmitted = 0;
+    u32 shadowCastersCulled = 0;
+    /**
+     * GPU times for each render pass, read back from
+     * a frame or two ago.
+     */
+    std::vector<RenderPassTime> passTimes;
   };
 
   class AbstractRenderer : public Initable, public Renderable, public Destroyable {
@@ -53,6 +82,6 @@ namespace Gamma {
   protected:
     GmContext* gmContext = nullptr;
     Area<u32> internalResolution = { 1920, 1080 };
-    RenderStats stats = { 0, 0, false };
+    RenderStats stats;
   };
 }
\ No newline at end of file
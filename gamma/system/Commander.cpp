@@ -1,3 +1,4 @@
+#include "performance/profiler.h"
 #include "system/Commander.h"
 #include "system/console.h"
 #include "system/flags.h"
@@ -16,6 +17,7 @@ namespace Gamma {
     { "light discs", "Light discs", GammaFlags::ENABLE_DEV_LIGHT_DISCS },
     { "buffers", "Dev buffers", GammaFlags::ENABLE_DEV_BUFFERS },
     { "tools", "Dev tools", GammaFlags::ENABLE_DEV_TOOLS },
+    { "profiler", "Profiler", GammaFlags::ENABLE_DEV_PROFILER },
 
     { "reflect", "Reflections", GammaFlags::RENDER_REFLECTIONS },
     { "refract", "Refractive geometry", GammaFlags::RENDER_REFRACTIVE_GEOMETRY },
@@ -24,7 +26,8 @@ namespace Gamma {
     { "ao", "Ambient occlusion", GammaFlags::RENDER_AMBIENT_OCCLUSION },
     { "gi", "Global illumination", GammaFlags::RENDER_GLOBAL_ILLUMINATION },
     { "skylight", "Indirect sky light", GammaFlags::RENDER_INDIRECT_SKY_LIGHT },
-    { "dof", "Depth of Field", GammaFlags::RENDER_DEPTH_OF_FIELD }
+    { "dof", "Depth of Field", GammaFlags::RENDER_DEPTH_OF_FIELD },
+    { "clustered", "Clustered lighting", GammaFlags::RENDER_CLUSTERED_LIGHTING }
   };
 
   Commander::Commander() {
@@ -93,6 +96,14 @@ namespace Gamma {
           Console::log("[Gamma]", command.displayName, "disabled");
         }
       }
+    } else if (currentCommandIncludes("trace")) {
+      const std::string path = "./profile_trace.json";
+
+      if (Gm_WriteProfileTrace(path)) {
+        Console::log("[Gamma] Profile trace written to", path);
+      } else {
+        Console::warn("[Gamma] Failed to write profile trace to", path);
+      }
     }
 
     signal("command", command);
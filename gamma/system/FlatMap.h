@@ -0,0 +1,202 @@
+#pragma once
+
+#include <vector>
+
+#include "system/type_aliases.h"
+
+namespace Gamma {
+  /**
+   * FlatMap
+   * -------
+   *
+   * An open-addressing hash map from u32 keys (e.g. NameId
+   * hashes) to values, stored in a single contiguous slot
+   * array with linear probing. Lookups never allocate or
+   * compare strings.
+   *
+   * Pointers to values are invalidated when the map grows
+   * or when entries are erased.
+   */
+  template<typename V>
+  class FlatMap {
+  public:
+    struct Slot {
+      u32 key = 0;
+      bool occupied = false;
+      V value = V();
+    };
+
+    class Iterator {
+    public:
+      Iterator(Slot* slot, Slot* end): slot(slot), end(end) {
+        skipUnoccupiedSlots();
+      }
+
+      Slot& operator*() const {
+        return *slot;
+      }
+
+      Iterator& operator++() {
+        slot++;
+
+        skipUnoccupiedSlots();
+
+        return *this;
+      }
+
+      bool operator!=(const Iterator& iterator) const {
+        return slot != iterator.slot;
+      }
+
+    private:
+      Slot* slot = nullptr;
+      Slot* end = nullptr;
+
+      void skipUnoccupiedSlots() {
+        while (slot != end && !slot->occupied) {
+          slot++;
+        }
+      }
+    };
+
+    V& operator[](u32 key) {
+      auto* value = find(key);
+
+      if (value != nullptr) {
+        return *value;
+      }
+
+      if ((totalEntries + 1) * 4 > slots.size() * 3) {
+        resize(slots.size() == 0 ? 16 : (u32)slots.size() * 2);
+      }
+
+      u32 index = getSlotIndex(key);
+
+      while (slots[index].occupied) {
+        index = (index + 1) & mask;
+      }
+
+      auto& slot = slots[index];
+
+      slot.key = key;
+      slot.occupied = true;
+      slot.value = V();
+
+      totalEntries++;
+
+      return slot.value;
+    }
+
+    Iterator begin() {
+      return Iterator(slots.data(), slots.data() + slots.size());
+    }
+
+    void clear() {
+      slots.clear();
+
+      totalEntries = 0;
+      mask = 0;
+      shift = 32;
+    }
+
+    Iterator end() {
+      return Iterator(slots.data() + slots.size(), slots.data() + slots.size());
+    }
+
+    void erase(u32 key) {
+      if (totalEntries == 0) {
+        return;
+      }
+
+      u32 index = getSlotIndex(key);
+
+      while (slots[index].occupied && slots[index].key != key) {
+        index = (index + 1) & mask;
+      }
+
+      if (!slots[index].occupied) {
+        return;
+      }
+
+      // Shift subsequent entries in the probe sequence back
+      // into the vacated slot, so lookups don't need to
+      // step over deleted entries
+      u32 next = (index + 1) & mask;
+
+      while (slots[next].occupied) {
+        u32 ideal = getSlotIndex(slots[next].key);
+
+        if (((next - ideal) & mask) >= ((next - index) & mask)) {
+          slots[index] = slots[next];
+          index = next;
+        }
+
+        next = (next + 1) & mask;
+      }
+
+      slots[index] = Slot();
+
+      totalEntries--;
+    }
+
+    V* find(u32 key) {
+      if (totalEntries == 0) {
+        return nullptr;
+      }
+
+      u32 index = getSlotIndex(key);
+
+      while (slots[index].occupied) {
+        if (slots[index].key == key) {
+          return &slots[index].value;
+        }
+
+        index = (index + 1) & mask;
+      }
+
+      return nullptr;
+    }
+
+    const V* find(u32 key) const {
+      return const_cast<FlatMap<V>*>(this)->find(key);
+    }
+
+    bool has(u32 key) const {
+      return find(key) != nullptr;
+    }
+
+    u32 size() const {
+      return totalEntries;
+    }
+
+  private:
+    std::vector<Slot> slots;
+    u32 totalEntries = 0;
+    u32 mask = 0;
+    u32 shift = 32;
+
+    u32 getSlotIndex(u32 key) const {
+      // Fibonacci hashing, spreading keys across the high bits
+      return (u32)((key * 2654435769u) >> shift) & mask;
+    }
+
+    void resize(u32 capacity) {
+      std::vector<Slot> previousSlots = std::move(slots);
+
+      slots.assign(capacity, Slot());
+      totalEntries = 0;
+      mask = capacity - 1;
+      shift = 32;
+
+      for (u32 bits = capacity; bits > 1; bits >>= 1) {
+        shift--;
+      }
+
+      for (auto& slot : previousSlots) {
+        if (slot.occupied) {
+          (*this)[slot.key] = slot.value;
+        }
+      }
+    }
+  };
+}
\ No newline at end of file
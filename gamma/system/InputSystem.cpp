@@ -95,6 +95,24 @@ namespace Gamma {
     return mousewheelDirection;
   }
 
+  InputState InputSystem::getState() const {
+    InputState state;
+
+    state.heldKeys = heldKeyState;
+    state.pressedKeys = pressedKeyState;
+    state.releasedKeys = releasedKeyState;
+    state.lastKeyDown = lastKeyDown;
+    state.mouseDelta = mouseDelta;
+    state.didClickMouse = didClickMouseThisFrame;
+    state.didRightClickMouse = didRightClickThisFrame;
+    state.didReleaseMouse = didReleaseMouseThisFrame;
+    state.didMoveMouseWheel = didMoveMouseWheelThisFrame;
+    state.isMouseHeld = isMouseButtonHeldDown;
+    state.mouseWheelDirection = mousewheelDirection;
+
+    return state;
+  }
+
   void InputSystem::handleEvent(const SDL_Event& event) {
     switch (event.type) {
       case SDL_KEYDOWN:
@@ -221,4 +239,23 @@ namespace Gamma {
     didMoveMouseWheelThisFrame = false;
     mouseDelta = { 0, 0 };
   }
+
+  /**
+   * Restores a captured input state. No input events are
+   * signaled, so only code which polls the input system's
+   * state will observe the change.
+   */
+  void InputSystem::setState(const InputState& state) {
+    heldKeyState = state.heldKeys;
+    pressedKeyState = state.pressedKeys;
+    releasedKeyState = state.releasedKeys;
+    lastKeyDown = state.lastKeyDown;
+    mouseDelta = state.mouseDelta;
+    didClickMouseThisFrame = state.didClickMouse;
+    didRightClickThisFrame = state.didRightClickMouse;
+    didReleaseMouseThisFrame = state.didReleaseMouse;
+    didMoveMouseWheelThisFrame = state.didMoveMouseWheel;
+    isMouseButtonHeldDown = state.isMouseHeld;
+    mousewheelDirection = state.mouseWheelDirection;
+  }
 }
\ No newline at end of file
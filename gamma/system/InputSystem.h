@@ -80,6 +80,27 @@ namespace Gamma {
     Key key;
   };
 
+  /**
+   * InputState
+   * ----------
+   *
+   * A snapshot of the input system's state for a frame,
+   * which can be captured and restored to replay input.
+   */
+  struct InputState {
+    u64 heldKeys = 0;
+    u64 pressedKeys = 0;
+    u64 releasedKeys = 0;
+    u64 lastKeyDown = 0;
+    Point<int> mouseDelta = { 0, 0 };
+    bool didClickMouse = false;
+    bool didRightClickMouse = false;
+    bool didReleaseMouse = false;
+    bool didMoveMouseWheel = false;
+    bool isMouseHeld = false;
+    MouseWheelEvent::Direction mouseWheelDirection = MouseWheelEvent::UP;
+  };
+
   class InputSystem : public Signaler {
   public:
     bool didClickMouse() const;
@@ -92,10 +113,12 @@ namespace Gamma {
     u64 getLastKeyDown() const;
     const Point<int>& getMouseDelta() const;
     const MouseWheelEvent::Direction getMouseWheelDirection() const;
+    InputState getState() const;
     void handleEvent(const SDL_Event& event);
     bool isKeyHeld(Key key) const;
     bool isMouseHeld() const;
     void resetPerFrameState();
+    void setState(const InputState& state);
 
   private:
     u64 heldKeyState = 0;
@@ -109,7 +132,7 @@ namespace Gamma {
     bool didMoveMouseWheelThisFrame = false;
     bool isMouseButtonHeldDown = false;
     Point<int> mouseDelta = { 0, 0 };
-    MouseWheelEvent::Direction mousewheelDirection;
+    MouseWheelEvent::Direction mousewheelDirection = MouseWheelEvent::UP;
 
     void handleKeyDown(const SDL_Keycode& code);
     void handleKeyUp(const SDL_Keycode& code);
@@ -0,0 +1,135 @@
+#include "system/assert.h"
+#include "system/entities.h"
+#include "system/LightPool.h"
+
+#define UNUSED_LIGHT_INDEX 0xffff
+
+namespace Gamma {
+  /**
+   * LightPool
+   * ---------
+   */
+  Light& LightPool::operator[](u32 index) {
+    return lights[index];
+  }
+
+  Light* LightPool::begin() const {
+    return lights;
+  }
+
+  Light& LightPool::createLight() {
+    if (lights == nullptr) {
+      reserve(MAX_LIGHTS);
+    }
+
+    assert(freeIds.size() > 0, "Light Pool out of space: " + std::to_string(max()) + " lights allowed");
+
+    u16 id = freeIds.back();
+    u16 index = totalActiveLights;
+
+    freeIds.pop_back();
+
+    Light& light = lights[index];
+
+    light = Light();
+    light._handle.id = id;
+    light._handle.generation = ++generations[id];
+
+    // Enable light lookup by ID -> index
+    indices[id] = index;
+
+    totalActiveLights++;
+
+    return light;
+  }
+
+  Light* LightPool::end() const {
+    return &lights[totalActiveLights];
+  }
+
+  void LightPool::free() {
+    if (lights != nullptr) {
+      delete[] lights;
+    }
+
+    lights = nullptr;
+    maxLights = 0;
+    totalActiveLights = 0;
+
+    freeIds.clear();
+  }
+
+  Light* LightPool::getByHandle(const LightHandle& handle) const {
+    auto* light = getById(handle.id);
+
+    if (light == nullptr || light->_handle.generation != handle.generation) {
+      return nullptr;
+    }
+
+    return light;
+  }
+
+  Light* LightPool::getById(u16 lightId) const {
+    if (lightId >= maxLights) {
+      return nullptr;
+    }
+
+    u16 index = indices[lightId];
+
+    return index == UNUSED_LIGHT_INDEX ? nullptr : &lights[index];
+  }
+
+  u16 LightPool::max() const {
+    return maxLights;
+  }
+
+  void LightPool::remove(const Light* light) {
+    if (light < begin() || light >= end()) {
+      return;
+    }
+
+    removeByIndex(u16(light - lights));
+  }
+
+  void LightPool::removeByHandle(const LightHandle& handle) {
+    auto* light = getByHandle(handle);
+
+    if (light != nullptr) {
+      remove(light);
+    }
+  }
+
+  void LightPool::removeByIndex(u16 index) {
+    u16 id = lights[index]._handle.id;
+    u16 lastIndex = --totalActiveLights;
+
+    // Move the last light into the removed index
+    lights[index] = lights[lastIndex];
+
+    // Update ID -> index lookup table
+    indices[lights[index]._handle.id] = index;
+    indices[id] = UNUSED_LIGHT_INDEX;
+
+    freeIds.push_back(id);
+  }
+
+  void LightPool::reserve(u16 size) {
+    free();
+
+    assert(size <= MAX_LIGHTS, "Light Pool size cannot exceed " + std::to_string(MAX_LIGHTS) + " lights");
+
+    maxLights = size;
+    lights = new Light[size];
+
+    // Hand out IDs in ascending order
+    for (u16 i = 0; i < size; i++) {
+      indices[i] = UNUSED_LIGHT_INDEX;
+      generations[i] = 0;
+      freeIds.push_back(size - 1 - i);
+    }
+  }
+
+  u16 LightPool::totalActive() const {
+    return totalActiveLights;
+  }
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+
+#include "system/type_aliases.h"
+
+namespace Gamma {
+  struct Light;
+  struct LightHandle;
+
+  /**
+   * The maximum number of lights in a scene.
+   */
+  constexpr static u16 MAX_LIGHTS = 1000;
+
+  /**
+   * LightPool
+   * ---------
+   *
+   * A densely packed collection of scene Lights. Lights are
+   * moved to fill gaps when removed, so references to them
+   * are only stable until the next removal; LightHandles
+   * remain valid for as long as their light exists.
+   */
+  class LightPool {
+  public:
+    Light& operator[](u32 index);
+
+    Light* begin() const;
+    Light& createLight();
+    Light* end() const;
+    void free();
+    Light* getByHandle(const LightHandle& handle) const;
+    Light* getById(u16 lightId) const;
+    u16 max() const;
+    void remove(const Light* light);
+    void removeByHandle(const LightHandle& handle);
+    void reserve(u16 size);
+    u16 totalActive() const;
+
+  private:
+    Light* lights = nullptr;
+    /**
+     * Light ID -> index lookup table.
+     */
+    u16 indices[MAX_LIGHTS];
+    /**
+     * The current generation of each light ID, incremented
+     * each time the ID is assigned to a new light.
+     */
+    u16 generations[MAX_LIGHTS];
+    std::vector<u16> freeIds;
+    u16 maxLights = 0;
+    u16 totalActiveLights = 0;
+
+    void removeByIndex(u16 index);
+  };
+}
\ No newline at end of file
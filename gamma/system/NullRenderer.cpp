@@ -0,0 +1,264 @@
+#include <cstring>
+
+#include "performance/profiler.h"
+#include "system/camera.h"
+#include "system/context.h"
+#include "system/culling.h"
+#include "system/entities.h"
+#include "system/flags.h"
+#include "system/NullRenderer.h"
+
+namespace Gamma {
+  void NullRenderer::init() {
+    stats.isVSynced = false;
+  }
+
+  void NullRenderer::destroy() {
+    pointLights.clear();
+    pointShadowcasters.clear();
+    spotLights.clear();
+    spotShadowcasters.clear();
+    clusteredLights.clear();
+    discs.clear();
+    instanceColors.clear();
+    instanceMatrices.clear();
+    instanceIndices.clear();
+  }
+
+  /**
+   * Mirrors the CPU work done by OpenGLRenderer::render(),
+   * skipping everything it would hand off to the GPU.
+   */
+  void NullRenderer::render() {
+    GM_PROFILE_SCOPE("render");
+
+    stats.shadowCastersSubmitted = 0;
+    stats.shadowCastersCulled = 0;
+
+    initializeLightArrays();
+    packInstances();
+
+    if (Gm_IsFlagEnabled(GammaFlags::RENDER_SHADOWS)) {
+      cullSpotShadowcasters();
+      cullPointShadowcasters();
+    }
+
+    prepareLights();
+
+    frame++;
+
+    frameFlags.useStableTemporalSampling = false;
+  }
+
+  const RenderStats& NullRenderer::getRenderStats() {
+    return stats;
+  }
+
+  /**
+   * Configures light discs for a set of lights, as they
+   * would be drawn by OpenGLLightDisc.
+   */
+  void NullRenderer::configureLightDiscs(const std::vector<Light*>& lights) {
+    auto& camera = gmContext->scene.camera;
+    float aspectRatio = (float)internalResolution.width / (float)internalResolution.height;
+    Matrix4f matProjection = Matrix4f::glPerspective(internalResolution, camera.fov, 1.f, 10000.f);
+    Matrix4f matView = Gm_GetCameraViewMatrix(camera);
+    u32 totalDiscs = 0;
+
+    discs.resize(lights.size());
+
+    for (auto* light : lights) {
+      if (Gm_ConfigureLightDisc(discs[totalDiscs], *light, matProjection, matView, aspectRatio)) {
+        totalDiscs++;
+      }
+    }
+  }
+
+  /**
+   * Counts the instances which would be submitted to or
+   * culled from each point light shadow map.
+   */
+  void NullRenderer::cullPointShadowcasters() {
+    GM_PROFILE_SCOPE("cullPointShadowcasters");
+
+    for (auto* light : pointShadowcasters) {
+      for (auto* mesh : gmContext->scene.meshes) {
+        if (!mesh->canCastShadows || mesh->disabled) {
+          continue;
+        }
+
+        if (mesh->type == MeshType::PARTICLES) {
+          stats.shadowCastersSubmitted += mesh->objects.totalVisible();
+
+          continue;
+        }
+
+        auto* objects = mesh->objects.begin();
+
+        for (u32 i = 0; i < mesh->objects.totalVisible(); i++) {
+          auto& object = objects[i];
+          float radius = Gm_GetObjectBoundingRadius(*mesh, object);
+          u8 mask = 0;
+
+          if (radius > 0.f && Gm_IsSphereWithinLightRadius(*light, object.position, radius)) {
+            mask = Gm_GetCubeFaceMask(light->position, object.position, radius);
+          }
+
+          if (mask == 0) {
+            stats.shadowCastersCulled++;
+          } else {
+            stats.shadowCastersSubmitted++;
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * Counts the instances which would be submitted to or
+   * culled from each spot light shadow map.
+   */
+  void NullRenderer::cullSpotShadowcasters() {
+    GM_PROFILE_SCOPE("cullSpotShadowcasters");
+
+    for (auto* light : spotShadowcasters) {
+      for (auto* mesh : gmContext->scene.meshes) {
+        if (!mesh->canCastShadows || mesh->disabled) {
+          continue;
+        }
+
+        if (mesh->type == MeshType::PARTICLES) {
+          stats.shadowCastersSubmitted += mesh->objects.totalVisible();
+
+          continue;
+        }
+
+        auto* objects = mesh->objects.begin();
+
+        for (u32 i = 0; i < mesh->objects.totalVisible(); i++) {
+          auto& object = objects[i];
+          float radius = Gm_GetObjectBoundingRadius(*mesh, object);
+
+          if (radius == 0.f || !Gm_IsSphereWithinLightCone(*light, object.position, radius)) {
+            stats.shadowCastersCulled++;
+          } else {
+            stats.shadowCastersSubmitted++;
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * Sorts active point/spot lights by type, matching
+   * OpenGLRenderer::initializeLightArrays().
+   */
+  void NullRenderer::initializeLightArrays() {
+    bool useShadows = Gm_IsFlagEnabled(GammaFlags::RENDER_SHADOWS);
+
+    pointLights.clear();
+    pointShadowcasters.clear();
+    spotLights.clear();
+    spotShadowcasters.clear();
+
+    for (auto& light : gmContext->scene.lights) {
+      if (light.power == 0.f && (light.type == LightType::POINT || light.type == LightType::SPOT)) {
+        continue;
+      }
+
+      switch (light.type) {
+        case LightType::POINT:
+          pointLights.push_back(&light);
+          break;
+        case LightType::POINT_SHADOWCASTER:
+          (useShadows ? pointShadowcasters : pointLights).push_back(&light);
+          break;
+        case LightType::SPOT:
+          spotLights.push_back(&light);
+          break;
+        case LightType::SPOT_SHADOWCASTER:
+          (useShadows ? spotShadowcasters : spotLights).push_back(&light);
+          break;
+        default:
+          break;
+      }
+    }
+  }
+
+  /**
+   * Copies changed instance colors/matrices into staging
+   * storage, as OpenGLMesh::bufferInstances() would copy
+   * them into the instance buffers. Meshes are packed back
+   * to back, so offsets may shift between frames; nothing
+   * reads the packed data, only its cost matters.
+   */
+  void NullRenderer::packInstances() {
+    GM_PROFILE_SCOPE("packInstances");
+
+    u32 offset = 0;
+
+    for (auto* mesh : gmContext->scene.meshes) {
+      auto& objects = mesh->objects;
+      u32 totalInstances = mesh->useVisibilityIndices ? objects.totalActive() : objects.totalVisible();
+
+      if (mesh->disabled || totalInstances == 0) {
+        continue;
+      }
+
+      bool isGpuParticleMesh = mesh->type == MeshType::PARTICLES && mesh->particles.useGpuParticles;
+
+      if (instanceMatrices.size() < offset + totalInstances) {
+        instanceColors.resize(offset + totalInstances);
+        instanceMatrices.resize(offset + totalInstances);
+      }
+
+      if (objects.changed && !isGpuParticleMesh) {
+        memcpy(instanceColors.data() + offset, objects.getColors(), totalInstances * sizeof(pVec4));
+        memcpy(instanceMatrices.data() + offset, objects.getMatrices(), totalInstances * sizeof(Matrix4f));
+
+        objects.changed = false;
+      }
+
+      if (mesh->useVisibilityIndices) {
+        auto& visibleIndices = mesh->visibleIndices;
+
+        instanceIndices.resize(visibleIndices.size());
+
+        for (u32 i = 0; i < visibleIndices.size(); i++) {
+          instanceIndices[i] = offset + visibleIndices[i];
+        }
+      }
+
+      offset += totalInstances;
+    }
+  }
+
+  /**
+   * Builds light clusters, or configures light discs,
+   * depending on the lighting mode.
+   */
+  void NullRenderer::prepareLights() {
+    GM_PROFILE_SCOPE("prepareLights");
+
+    bool useClusteredLighting = (
+      Gm_IsFlagEnabled(GammaFlags::RENDER_CLUSTERED_LIGHTING) &&
+      !Gm_IsFlagEnabled(GammaFlags::ENABLE_DEV_LIGHT_DISCS)
+    );
+
+    if (useClusteredLighting) {
+      clusteredLights.clear();
+      clusteredLights.insert(clusteredLights.end(), pointLights.begin(), pointLights.end());
+      clusteredLights.insert(clusteredLights.end(), spotLights.begin(), spotLights.end());
+
+      if (clusteredLights.size() > 0) {
+        Gm_BuildLightClusters(lightClusters, clusteredLights, gmContext->scene.camera, internalResolution);
+      }
+    } else {
+      configureLightDiscs(spotLights);
+      configureLightDiscs(pointLights);
+    }
+
+    configureLightDiscs(spotShadowcasters);
+    configureLightDiscs(pointShadowcasters);
+  }
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+
+#include "math/matrix.h"
+#include "system/AbstractRenderer.h"
+#include "system/light_clusters.h"
+#include "system/light_discs.h"
+#include "system/packed_data.h"
+#include "system/type_aliases.h"
+
+namespace Gamma {
+  /**
+   * NullRenderer
+   * ------------
+   *
+   * A renderer which performs the CPU-side work of each frame
+   * (light sorting, light disc/cluster setup, shadowcaster
+   * culling and instance packing) without issuing any graphics
+   * API calls. Used to measure pure CPU frame costs in headless
+   * runs, where no window or GPU is available.
+   */
+  class NullRenderer : public AbstractRenderer {
+  public:
+    NullRenderer(GmContext* gmContext): AbstractRenderer(gmContext) {};
+
+    virtual void init() override;
+    virtual void render() override;
+    virtual void destroy() override;
+    virtual const RenderStats& getRenderStats() override;
+
+  private:
+    u32 frame = 0;
+    std::vector<Light*> pointLights;
+    std::vector<Light*> pointShadowcasters;
+    std::vector<Light*> spotLights;
+    std::vector<Light*> spotShadowcasters;
+    std::vector<Light*> clusteredLights;
+    std::vector<Disc> discs;
+    LightClusters lightClusters;
+    /**
+     * Staging storage standing in for the GPU instance
+     * buffers, so instance packing costs are preserved.
+     */
+    std::vector<pVec4> instanceColors;
+    std::vector<Matrix4f> instanceMatrices;
+    std::vector<u32> instanceIndices;
+
+    void configureLightDiscs(const std::vector<Light*>& lights);
+    void cullPointShadowcasters();
+    void cullSpotShadowcasters();
+    void initializeLightArrays();
+    void packInstances();
+    void prepareLights();
+  };
+}
\ No newline at end of file
@@ -1,11 +1,29 @@
+#include <climits>
+#include <vector>
+
+#include "performance/parallel.h"
 #include "system/assert.h"
 #include "system/camera.h"
+#include "system/culling.h"
 #include "system/entities.h"
 #include "system/ObjectPool.h"
+#include "system/occlusion.h"
 
 #define UNUSED_OBJECT_INDEX 0xffff
 
 namespace Gamma {
+  constexpr static u32 DEPTH_BATCH_SIZE = 4096;
+  constexpr static u32 OCCLUSION_BATCH_SIZE = 256;
+
+  // Scratch buffers for depth sorting
+  static std::vector<float> sortDepths;
+  static std::vector<u32> sortOrder;
+  static std::vector<Object> sortObjects;
+  static std::vector<Matrix4f> sortMatrices;
+  static std::vector<pVec4> sortColors;
+  // Scratch buffer for occlusion test results
+  static std::vector<u8> occludedFlags;
+
   /**
    * ObjectPool
    * ----------
@@ -14,14 +32,97 @@ namespace Gamma {
     return objects[index];
   }
 
+  // Reuses the first inactive object, if any, as a new visible
+  // object. Its generation is incremented, so any records of
+  // its previous use become stale.
+  Object* ObjectPool::acquireInactiveObject() {
+    if (totalInactiveObjects == 0) {
+      return nullptr;
+    }
+
+    Object& object = objects[totalActiveObjects];
+
+    object._record.generation++;
+
+    activateById(object._record.id);
+
+    return &objects[totalVisibleObjects - 1];
+  }
+
+  void ObjectPool::activateById(u16 objectId) {
+    u16 index = indices[objectId];
+
+    if (index == UNUSED_OBJECT_INDEX || index < totalActiveObjects) {
+      return;
+    }
+
+    // Move the object to the front of the inactive range,
+    // then grow the active and visible ranges to include it
+    swapObjects(index, totalActiveObjects);
+
+    totalActiveObjects++;
+    totalInactiveObjects--;
+
+    swapObjects(totalActiveObjects - 1, totalVisibleObjects);
+
+    totalVisibleObjects++;
+
+    changed = true;
+  }
+
   Object* ObjectPool::begin() const {
     return objects;
   }
 
+  // @todo consolidate visibility test with partitionByVisibility
+  void ObjectPool::collectVisibleIndices(const Camera& camera, std::vector<u32>& visibleIndices) const {
+    Vec3f cameraDirection = camera.orientation.getDirection();
+
+    visibleIndices.clear();
+
+    for (u16 i = 0; i < totalActiveObjects; i++) {
+      Vec3f objectUnitViewPosition = (objects[i].position - camera.position).unit();
+
+      // @todo use camera FoV to determine dot product threshold
+      if (Vec3f::dot(cameraDirection, objectUnitViewPosition) >= 0.7f) {
+        visibleIndices.push_back(i);
+      }
+    }
+  }
+
+  // Removes the indices of objects hidden behind occluders from
+  // a list of visible object indices, preserving the order of
+  // the remaining indices. Returns the number of indices removed.
+  u32 ObjectPool::cullOccludedIndices(const OcclusionBuffer& buffer, const Mesh& mesh, std::vector<u32>& visibleIndices) const {
+    u32 total = (u32)visibleIndices.size();
+
+    occludedFlags.resize(total);
+
+    Gm_ParallelFor(total, OCCLUSION_BATCH_SIZE, [&](u32 start, u32 end) {
+      for (u32 i = start; i < end; i++) {
+        auto& object = objects[visibleIndices[i]];
+
+        occludedFlags[i] = Gm_IsSphereOccluded(buffer, object.position, Gm_GetObjectBoundingRadius(mesh, object));
+      }
+    });
+
+    u32 totalVisible = 0;
+
+    for (u32 i = 0; i < total; i++) {
+      if (!occludedFlags[i]) {
+        visibleIndices[totalVisible++] = visibleIndices[i];
+      }
+    }
+
+    visibleIndices.resize(totalVisible);
+
+    return total - totalVisible;
+  }
+
   Object& ObjectPool::createObject() {
     u16 id = runningId++;
 
-    assert(max() > totalActive(), "Object Pool out of space: " + std::to_string(max()) + " objects allowed in this pool");
+    assert(max() > totalActive() + totalInactive(), "Object Pool out of space: " + std::to_string(max()) + " objects allowed in this pool");
     // @todo cycle through indices until an unoccupied slot is found
     assert(indices[id] == UNUSED_OBJECT_INDEX, "Attempted to create an Object in an occupied slot");
 
@@ -31,10 +132,14 @@ namespace Gamma {
 
     // Retrieve and initialize object
     u16 index = totalActiveObjects;
-    Object& object = objects[index];
 
-    object._record.id = id;
-    object._record.generation++;
+    if (totalInactiveObjects > 0) {
+      // Make room at the end of the active range
+      moveObject(index, index + totalInactiveObjects);
+    }
+
+    objects[index]._record.id = id;
+    objects[index]._record.generation++;
 
     // Reset object matrix/color
     matrices[index] = Matrix4f::identity();
@@ -44,11 +149,40 @@ namespace Gamma {
     indices[id] = index;
 
     totalActiveObjects++;
+
+    // Move the object to the end of the visible range, ahead
+    // of any culled objects, then grow the range to include it
+    swapObjects(index, totalVisibleObjects);
+
     totalVisibleObjects++;
 
     changed = true;
 
-    return object;
+    return objects[totalVisibleObjects - 1];
+  }
+
+  void ObjectPool::deactivateById(u16 objectId) {
+    u16 index = indices[objectId];
+
+    if (index == UNUSED_OBJECT_INDEX || index >= totalActiveObjects) {
+      return;
+    }
+
+    // Move the object to the end of the visible range (if
+    // visible), then to the end of the active range, which
+    // becomes the front of the inactive range
+    if (index < totalVisibleObjects) {
+      swapObjects(index, totalVisibleObjects - 1);
+
+      index = --totalVisibleObjects;
+    }
+
+    swapObjects(index, totalActiveObjects - 1);
+
+    totalActiveObjects--;
+    totalInactiveObjects++;
+
+    changed = true;
   }
 
   Object* ObjectPool::end() const {
@@ -106,6 +240,20 @@ namespace Gamma {
     return matrices;
   }
 
+  /**
+   * Returns the memory used by the pool's object, matrix
+   * and color arrays, as well as its fixed index table.
+   */
+  u64 ObjectPool::getMemoryUsage() const {
+    u64 bytes = sizeof(ObjectPool);
+
+    if (objects != nullptr) {
+      bytes += (u64)maxObjects * (sizeof(Object) + sizeof(Matrix4f) + sizeof(pVec4));
+    }
+
+    return bytes;
+  }
+
   u16 ObjectPool::max() const {
     return maxObjects;
   }
@@ -142,6 +290,75 @@ namespace Gamma {
     return current;
   }
 
+  // Partitions a range of object indices so that indices of objects
+  // within a distance of the camera come first, without reordering
+  // the objects themselves. Returns the end of the within-distance
+  // range.
+  u32 ObjectPool::partitionIndicesByDistance(u32* indices, u32 start, u32 end, float distance, const Vec3f& cameraPosition) const {
+    float distanceSquared = distance * distance;
+    u32 current = start;
+
+    while (end > current) {
+      Vec3f offset = objects[indices[current]].position - cameraPosition;
+
+      if (Vec3f::dot(offset, offset) <= distanceSquared) {
+        current++;
+      } else {
+        u32 index = indices[current];
+
+        indices[current] = indices[--end];
+        indices[end] = index;
+      }
+    }
+
+    return current;
+  }
+
+  // Moves visible objects hidden behind occluders out of the
+  // visible range, tested in parallel. Returns the number of
+  // objects hidden.
+  u16 ObjectPool::partitionByOcclusion(const OcclusionBuffer& buffer, const Mesh& mesh) {
+    u16 total = totalVisibleObjects;
+
+    occludedFlags.resize(total);
+
+    Gm_ParallelFor(total, OCCLUSION_BATCH_SIZE, [&](u32 start, u32 end) {
+      for (u32 i = start; i < end; i++) {
+        occludedFlags[i] = Gm_IsSphereOccluded(buffer, objects[i].position, Gm_GetObjectBoundingRadius(mesh, objects[i]));
+      }
+    });
+
+    u16 current = 0;
+    u16 end = total;
+
+    while (end > current) {
+      if (!occludedFlags[current]) {
+        current++;
+      } else {
+        // Swap the occluded object with the last unoccluded
+        // object, if any, in the remaining range
+        do {
+          end--;
+        } while (end > current && occludedFlags[end]);
+
+        if (current != end) {
+          swapObjects(current, end);
+
+          occludedFlags[current] = 0;
+          occludedFlags[end] = 1;
+        }
+      }
+    }
+
+    if (current != total) {
+      changed = true;
+    }
+
+    totalVisibleObjects = current;
+
+    return total - current;
+  }
+
   // @todo consolidate logic in partitionByDistance/partitionByVisibility
   // @todo accept a distance threshold to avoid culling partially
   // in-frame/partially out-of-frame objects
@@ -174,6 +391,18 @@ namespace Gamma {
     totalVisibleObjects = current;
   }
 
+  void ObjectPool::moveObject(u16 fromIndex, u16 toIndex) {
+    if (fromIndex == toIndex) {
+      return;
+    }
+
+    objects[toIndex] = objects[fromIndex];
+    matrices[toIndex] = matrices[fromIndex];
+    colors[toIndex] = colors[fromIndex];
+
+    indices[objects[toIndex]._record.id] = toIndex;
+  }
+
   void ObjectPool::removeById(u16 objectId) {
     u16 index = indices[objectId];
 
@@ -181,29 +410,47 @@ namespace Gamma {
       return;
     }
 
-    totalActiveObjects--;
-    totalVisibleObjects--;
+    if (index >= totalActiveObjects) {
+      // Move the last inactive object into the removed index
+      totalInactiveObjects--;
+
+      moveObject(totalActiveObjects + totalInactiveObjects, index);
+    } else {
+      if (index < totalVisibleObjects) {
+        // Move the last visible object into the removed index,
+        // leaving the gap at the end of the visible range
+        totalVisibleObjects--;
+
+        moveObject(totalVisibleObjects, index);
+
+        index = totalVisibleObjects;
+      }
+
+      totalActiveObjects--;
 
-    u16 lastIndex = totalActiveObjects;
+      u16 lastIndex = totalActiveObjects;
 
-    // Move last object/matrix/color into removed index
-    objects[index] = objects[lastIndex];
-    matrices[index] = matrices[lastIndex];
-    colors[index] = colors[lastIndex];
+      // Move last object/matrix/color into removed index
+      moveObject(lastIndex, index);
+
+      if (totalInactiveObjects > 0) {
+        // Fill the gap left at the end of the active range
+        moveObject(lastIndex + totalInactiveObjects, lastIndex);
+      }
+    }
 
-    // Update ID -> index lookup table
-    indices[objects[index]._record.id] = index;
     indices[objectId] = UNUSED_OBJECT_INDEX;
 
     changed = true;
   }
 
   void ObjectPool::reset() {
-    for (u16 i = 0; i < totalActiveObjects; i++) {
+    for (u16 i = 0; i < totalActiveObjects + totalInactiveObjects; i++) {
       indices[objects[i]._record.id] = UNUSED_OBJECT_INDEX;
     }
 
     totalActiveObjects = 0;
+    totalInactiveObjects = 0;
     totalVisibleObjects = 0;
     runningId = 0;
     changed = true;
@@ -214,6 +461,7 @@ namespace Gamma {
 
     maxObjects = size;
     totalActiveObjects = 0;
+    totalInactiveObjects = 0;
     totalVisibleObjects = 0;
     objects = new Object[size];
     matrices = new Matrix4f[size];
@@ -226,6 +474,82 @@ namespace Gamma {
     changed = true;
   }
 
+  // Sorts a range of objects by their view depth from the camera.
+  // Objects sorted on a previous frame are usually still nearly
+  // in order, and are cheap to re-sort; objects already in order
+  // are left untouched. Returns true if any objects were moved.
+  bool ObjectPool::sortByDepth(u16 start, u16 end, const Camera& camera, DepthSortOrder order) {
+    if (end <= start + 1) {
+      return false;
+    }
+
+    u32 total = end - start;
+    Vec3f cameraDirection = camera.orientation.getDirection();
+
+    sortDepths.resize(total);
+    sortOrder.resize(total);
+
+    Gm_ParallelFor(total, DEPTH_BATCH_SIZE, [&](u32 first, u32 last) {
+      for (u32 i = first; i < last; i++) {
+        sortDepths[i] = Vec3f::dot(cameraDirection, objects[start + i].position - camera.position);
+        sortOrder[i] = start + i;
+      }
+    });
+
+    if (!Gm_SortByDepth(sortDepths.data(), sortOrder.data(), total, order)) {
+      return false;
+    }
+
+    // Gather objects/matrices/colors in sorted order,
+    // then copy them back into place
+    sortObjects.resize(total);
+    sortMatrices.resize(total);
+    sortColors.resize(total);
+
+    for (u32 i = 0; i < total; i++) {
+      u32 index = sortOrder[i];
+
+      sortObjects[i] = objects[index];
+      sortMatrices[i] = matrices[index];
+      sortColors[i] = colors[index];
+    }
+
+    for (u32 i = 0; i < total; i++) {
+      u16 index = u16(start + i);
+
+      objects[index] = sortObjects[i];
+      matrices[index] = sortMatrices[i];
+      colors[index] = sortColors[i];
+
+      indices[objects[index]._record.id] = index;
+    }
+
+    changed = true;
+
+    return true;
+  }
+
+  // Sorts a range of object indices by the view depth of their
+  // objects from the camera, without reordering the objects
+  void ObjectPool::sortIndicesByDepth(u32* indices, u32 start, u32 end, const Camera& camera, DepthSortOrder order) const {
+    if (end <= start + 1) {
+      return;
+    }
+
+    u32 total = end - start;
+    Vec3f cameraDirection = camera.orientation.getDirection();
+
+    sortDepths.resize(total);
+
+    Gm_ParallelFor(total, DEPTH_BATCH_SIZE, [&](u32 first, u32 last) {
+      for (u32 i = first; i < last; i++) {
+        sortDepths[i] = Vec3f::dot(cameraDirection, objects[indices[start + i]].position - camera.position);
+      }
+    });
+
+    Gm_SortByDepth(sortDepths.data(), indices + start, total, order);
+  }
+
   void ObjectPool::swapObjects(u16 indexA, u16 indexB) {
     Object objectA = objects[indexA];
     Matrix4f matrixA = matrices[indexA];
@@ -248,10 +572,21 @@ namespace Gamma {
     changed = true;
   }
 
+  void ObjectPool::setTotalVisible(u16 total) {
+    assert(total <= totalActiveObjects, "Cannot show more objects than are active in the pool");
+
+    totalVisibleObjects = total;
+    changed = true;
+  }
+
   u16 ObjectPool::totalActive() const {
     return totalActiveObjects;
   }
 
+  u16 ObjectPool::totalInactive() const {
+    return totalInactiveObjects;
+  }
+
   u16 ObjectPool::totalVisible() const {
     return totalVisibleObjects;
   }
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <vector>
+
 #include "math/matrix.h"
+#include "system/depth_sort.h"
 #include "system/packed_data.h"
 #include "system/type_aliases.h"
 
@@ -8,6 +11,8 @@ namespace Gamma {
   struct Object;
   struct ObjectRecord;
   struct Camera;
+  struct Mesh;
+  struct OcclusionBuffer;
 
   /**
    * ObjectPool
@@ -16,6 +21,12 @@ namespace Gamma {
    * A collection of Objects tied to a given Mesh, designed
    * to facilitate instanced/batched rendering.
    *
+   * Objects are stored in three contiguous ranges: visible
+   * objects, followed by active objects which are not visible,
+   * followed by inactive objects. Inactive objects keep their
+   * IDs and are never iterated, uploaded or drawn, and can
+   * be reactivated or reused without creating new objects.
+   *
    * @todo u16 -> u32 to support >65K objects per pool
    */
   class ObjectPool {
@@ -28,8 +39,13 @@ namespace Gamma {
 
     Object& operator[](u32 index);
 
+    Object* acquireInactiveObject();
+    void activateById(u16 objectId);
     Object* begin() const;
+    void collectVisibleIndices(const Camera& camera, std::vector<u32>& visibleIndices) const;
+    u32 cullOccludedIndices(const OcclusionBuffer& buffer, const Mesh& mesh, std::vector<u32>& visibleIndices) const;
     Object& createObject();
+    void deactivateById(u16 objectId);
     Object* end() const;
     void free();
     Object* getById(u16 objectId) const;
@@ -37,15 +53,22 @@ namespace Gamma {
     pVec4* getColors() const;
     u16 getHighestId() const;
     Matrix4f* getMatrices() const;
+    u64 getMemoryUsage() const;
     u16 max() const;
     u16 partitionByDistance(u16 start, float distance, const Vec3f& cameraPosition);
+    u32 partitionIndicesByDistance(u32* indices, u32 start, u32 end, float distance, const Vec3f& cameraPosition) const;
+    u16 partitionByOcclusion(const OcclusionBuffer& buffer, const Mesh& mesh);
     void partitionByVisibility(const Camera& camera);
     void removeById(u16 objectId);
     void reset();
     void reserve(u16 size);
     void setColorById(u16 objectId, const pVec4& color);
+    void setTotalVisible(u16 total);
     void showAll();
+    bool sortByDepth(u16 start, u16 end, const Camera& camera, DepthSortOrder order);
+    void sortIndicesByDepth(u32* indices, u32 start, u32 end, const Camera& camera, DepthSortOrder order) const;
     u16 totalActive() const;
+    u16 totalInactive() const;
     u16 totalVisible() const;
     void transformById(u16 objectId, const Matrix4f& matrix);
 
@@ -59,10 +82,12 @@ namespace Gamma {
     u16 indices[0xffff];
     u16 maxObjects = 0;
     u16 totalActiveObjects = 0;
+    u16 totalInactiveObjects = 0;
     u16 totalVisibleObjects = 0;
     u16 runningId = 0;
     u16 highestId = 0;
 
+    void moveObject(u16 fromIndex, u16 toIndex);
     void swapObjects(u16 indexA, u16 indexB);
   };
 }
\ No newline at end of file
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "system/type_aliases.h"
+
+namespace Gamma {
+  /**
+   * RangeAllocator
+   * --------------
+   *
+   * Suballocates ranges of elements from a linear region,
+   * e.g. a GPU buffer, using a first-fit free list. Free
+   * blocks are kept sorted by offset so neighboring blocks
+   * can be merged when ranges are freed. The allocator only
+   * tracks offsets; callers own the underlying storage, and
+   * call grow() after enlarging it.
+   */
+  class RangeAllocator {
+  public:
+    bool allocate(u32 size, u32& offset) {
+      if (size == 0) {
+        offset = 0;
+
+        return true;
+      }
+
+      for (u32 i = 0; i < freeBlocks.size(); i++) {
+        auto& block = freeBlocks[i];
+
+        if (block.size >= size) {
+          offset = block.offset;
+
+          block.offset += size;
+          block.size -= size;
+
+          if (block.size == 0) {
+            freeBlocks.erase(freeBlocks.begin() + i);
+          }
+
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    u32 capacity() const {
+      return totalCapacity;
+    }
+
+    void free(u32 offset, u32 size) {
+      if (size == 0) {
+        return;
+      }
+
+      auto next = std::lower_bound(freeBlocks.begin(), freeBlocks.end(), offset, [](const Block& block, u32 offset) {
+        return block.offset < offset;
+      });
+
+      u32 index = (u32)(next - freeBlocks.begin());
+
+      freeBlocks.insert(next, { offset, size });
+
+      // Merge with the following block
+      if (index + 1 < freeBlocks.size() && freeBlocks[index].offset + freeBlocks[index].size == freeBlocks[index + 1].offset) {
+        freeBlocks[index].size += freeBlocks[index + 1].size;
+
+        freeBlocks.erase(freeBlocks.begin() + index + 1);
+      }
+
+      // Merge with the preceding block
+      if (index > 0 && freeBlocks[index - 1].offset + freeBlocks[index - 1].size == freeBlocks[index].offset) {
+        freeBlocks[index - 1].size += freeBlocks[index].size;
+
+        freeBlocks.erase(freeBlocks.begin() + index);
+      }
+    }
+
+    void grow(u32 capacity) {
+      if (capacity > totalCapacity) {
+        u32 previousCapacity = totalCapacity;
+
+        totalCapacity = capacity;
+
+        free(previousCapacity, capacity - previousCapacity);
+      }
+    }
+
+    void reset() {
+      freeBlocks.clear();
+
+      totalCapacity = 0;
+    }
+
+  private:
+    struct Block {
+      u32 offset = 0;
+      u32 size = 0;
+    };
+
+    std::vector<Block> freeBlocks;
+    u32 totalCapacity = 0;
+  };
+}
\ No newline at end of file
@@ -1,10 +1,18 @@
+#include <cstdio>
+#include <cstdlib>
+
 #include "SDL.h"
 #include "system/assert.h"
 
 namespace Gamma {
   void assert(bool condition, std::string message) {
     if (!condition) {
-      SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Error", message.c_str(), 0);
+      fprintf(stderr, "%s\n", message.c_str());
+
+      #if !GAMMA_HEADLESS
+        SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "Error", message.c_str(), 0);
+      #endif
+
       exit(0);
     }
   }
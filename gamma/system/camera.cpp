@@ -4,6 +4,26 @@
 #include "system/camera.h"
 
 namespace Gamma {
+  /**
+   * Gm_GetCameraViewMatrix
+   * ----------------------
+   *
+   * Returns the view matrix for a camera in engine space,
+   * as opposed to the GL-space view matrix used for scene
+   * rendering. Points in front of the camera have positive
+   * view-space z.
+   */
+  Matrix4f Gm_GetCameraViewMatrix(const Camera& camera) {
+    Orientation viewOrientation = camera.orientation.invert();
+
+    viewOrientation.roll *= -1.f;  // @hack
+
+    return (
+      Matrix4f::rotation(viewOrientation) *
+      Matrix4f::translation(camera.position.invert())
+    );
+  }
+
   /**
    * ThirdPersonCamera::calculatePosition()
    * --------------------------------------
@@ -22,4 +22,6 @@ namespace Gamma {
     bool isUpsideDown() const;
     void limitAltitude(float factor);
   };
+
+  Matrix4f Gm_GetCameraViewMatrix(const Camera& camera);
 }
\ No newline at end of file
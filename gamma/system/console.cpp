@@ -1,6 +1,7 @@
-#include "system/console.h"
+#include <chrono>
 
-#include "SDL.h"
+#include "performance/memory.h"
+#include "system/console.h"
 
 namespace Gamma {
   std::stringstream Console::output;
@@ -8,6 +9,8 @@ namespace Gamma {
   ConsoleMessage* Console::lastMessage = nullptr;
   u32 Console::messageCounter = 0;
 
+  static auto consoleStartTime = std::chrono::steady_clock::now();
+
   void Console::clearMessages() {
     // @todo
   }
@@ -17,11 +20,13 @@ namespace Gamma {
 
     // @todo use system time or something we can
     // determine HH:MM:SS from
-    consoleMessage->time = SDL_GetTicks();
+    consoleMessage->time = (u32)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - consoleStartTime).count();
     consoleMessage->warning = warning;
     consoleMessage->text = message;
     consoleMessage->next = nullptr;
 
+    Gm_TrackMemory(MemoryCategory::CONSOLE, sizeof(ConsoleMessage) + consoleMessage->text.capacity());
+
     if (firstMessage == nullptr) {
       firstMessage = consoleMessage;
     } else {
@@ -33,6 +38,8 @@ namespace Gamma {
     if (++messageCounter > 5) {
       auto* newFirstMessage = firstMessage->next;
 
+      Gm_TrackMemory(MemoryCategory::CONSOLE, -(s64)(sizeof(ConsoleMessage) + firstMessage->text.capacity()));
+
       delete firstMessage;
 
       firstMessage = newFirstMessage;
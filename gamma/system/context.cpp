@@ -1,3 +1,4 @@
+#include <cstring>
 #include <string>
 
 #include "SDL.h"
@@ -6,21 +7,98 @@
 
 #include "opengl/OpenGLRenderer.h"
 #include "performance/benchmark.h"
+#include "performance/profiler.h"
 #include "performance/tools.h"
 #include "system/assert.h"
 #include "system/console.h"
 #include "system/context.h"
 #include "system/file.h"
 #include "system/flags.h"
+#include "system/NullRenderer.h"
+#include "system/random.h"
 #include "system/scene.h"
 
 using namespace Gamma;
 
 #define String(value) std::to_string(value)
 
+/**
+ * Gm_EndFramePhase
+ * ----------------
+ *
+ * Records the time since the previous phase ended, or
+ * since the frame started, as a phase of the frame.
+ */
+static void Gm_EndFramePhase(GmContext* context, const char* name) {
+  u64 microseconds = Gm_GetMicroseconds();
+
+  context->frameStats.addPhase(name, microseconds - context->framePhaseStartMicroseconds);
+  context->framePhaseStartMicroseconds = microseconds;
+}
+
+static void Gm_DisplayProfiler(GmContext* context) {
+  using namespace Gamma;
+
+  auto& renderer = *context->renderer;
+  auto& window = context->window;
+  auto& aggregates = Gm_GetProfileAggregates();
+  const Vec3f TEXT_COLOR = Vec3f(1.f);
+  const Vec4f BACKGROUND_COLOR = Vec4f(0, 0, 0.5f, 0.5f);
+  const u32 MAX_DEPTH = 3;
+  u32 x = window.size.width - 450;
+  u32 y = window.size.height / 4;
+  char label[128];
+
+  // Render GPU pass times alongside their CPU times
+  for (auto& pass : renderer.getRenderStats().passTimes) {
+    u64 cpuNanoseconds = 0;
+
+    for (auto& aggregate : aggregates) {
+      if (strcmp(aggregate.name, pass.name) == 0) {
+        cpuNanoseconds += aggregate.totalNanoseconds;
+      }
+    }
+
+    snprintf(
+      label, sizeof(label), "%s: GPU %.2fms, CPU %.2fms",
+      pass.name,
+      pass.gpuNanoseconds / 1000000.0,
+      cpuNanoseconds / 1000000.0
+    );
+
+    renderer.renderText(window.font_sm, label, x, y, TEXT_COLOR, BACKGROUND_COLOR);
+
+    y += 25;
+  }
+
+  y += 25;
+
+  // Render CPU scope aggregates
+  for (auto& aggregate : aggregates) {
+    if (aggregate.depth > MAX_DEPTH || y > window.size.height - 250) {
+      continue;
+    }
+
+    snprintf(
+      label, sizeof(label), "%*s%s: %.2fms (%ux, max %.2fms)",
+      aggregate.depth * 2, "",
+      aggregate.name,
+      aggregate.totalNanoseconds / 1000000.0,
+      aggregate.calls,
+      aggregate.maxNanoseconds / 1000000.0
+    );
+
+    renderer.renderText(window.font_sm, label, x, y, TEXT_COLOR, BACKGROUND_COLOR);
+
+    y += 25;
+  }
+}
+
 static void Gm_DisplayDevtools(GmContext* context) {
   using namespace Gamma;
 
+  GM_PROFILE_SCOPE("Gm_DisplayDevtools");
+
   auto& renderer = *context->renderer;
   auto& resolution = renderer.getInternalResolution();
   auto& renderStats = renderer.getRenderStats();
@@ -56,7 +134,37 @@ static void Gm_DisplayDevtools(GmContext* context) {
       auto trisLabel = "Tris: " + String(sceneStats.tris);
       auto totalLightsLabel = "Lights: " + String(sceneStats.totalLights);
       auto totalMeshesLabel = "Meshes: " + String(sceneStats.totalMeshes);
-      auto memoryLabel = "GPU Memory: " + String(renderStats.gpuMemoryUsed) + "MB / " + String(renderStats.gpuMemoryTotal) + "MB";
+      auto memoryLabel = renderStats.gpuMemoryTotal > 0
+        ? "GPU Memory: " + String(renderStats.gpuMemoryUsed) + "MB / " + String(renderStats.gpuMemoryTotal) + "MB"
+        : "GPU Memory: " + String(renderStats.gpuMemoryUsed) + "MB (estimated)";
+      auto shadowCastersLabel = "Shadow casters: " + String(renderStats.shadowCastersSubmitted) + " drawn, " + String(renderStats.shadowCastersCulled) + " culled";
+      auto geometryMemoryLabel = "CPU geometry: " + String(sceneStats.geometryMemory / 1024) + "KB (" + String(sceneStats.releasedGeometryMemory / 1024) + "KB released)";
+      auto& occlusionStats = context->scene.occlusion.stats;
+      auto frameTimes = context->frameStats.getSummary();
+      char frameTimesLabel[128];
+
+      snprintf(
+        frameTimesLabel, sizeof(frameTimesLabel), "Frame times (last %u): p50 %.2fms, p90 %.2fms, p99 %.2fms, p99.9 %.2fms, max %.2fms",
+        frameTimes.frames,
+        frameTimes.p50 / 1000.0,
+        frameTimes.p90 / 1000.0,
+        frameTimes.p99 / 1000.0,
+        frameTimes.p999 / 1000.0,
+        frameTimes.max / 1000.0
+      );
+
+      auto memorySnapshot = Gm_GetMemorySnapshot(context, false);
+      std::string cpuMemoryLabel = "CPU tracked:";
+      std::string gpuMemoryLabel = "GPU tracked:";
+
+      for (u32 i = 0; i < TOTAL_MEMORY_CATEGORIES; i++) {
+        auto category = (MemoryCategory)i;
+        auto& label = Gm_IsGpuMemoryCategory(category) ? gpuMemoryLabel : cpuMemoryLabel;
+
+        label += " " + std::string(Gm_GetMemoryCategoryName(category)) + " " + String(memorySnapshot.bytes[i] / 1024) + "KB";
+      }
+
+      auto occlusionLabel = "Occluded: " + String(occlusionStats.totalOccludedObjects) + " / " + String(occlusionStats.totalTestedObjects) + " (" + String(occlusionStats.totalOccluderTriangles) + " tris, " + String(occlusionStats.rasterMicroseconds) + "us raster, " + String(occlusionStats.testMicroseconds) + "us test)";
 
       const Vec3f TEXT_COLOR = Vec3f(1.f);
       const Vec4f BACKGROUND_COLOR = Vec4f(0.5f, 0, 0, 0.5f);
@@ -69,6 +177,12 @@ static void Gm_DisplayDevtools(GmContext* context) {
       renderer.renderText(font_sm, totalLightsLabel.c_str(), 25, 150, TEXT_COLOR, BACKGROUND_COLOR);
       renderer.renderText(font_sm, totalMeshesLabel.c_str(), 25, 175, TEXT_COLOR, BACKGROUND_COLOR);
       renderer.renderText(font_sm, memoryLabel.c_str(), 25, 200, TEXT_COLOR, BACKGROUND_COLOR);
+      renderer.renderText(font_sm, shadowCastersLabel.c_str(), 25, 225, TEXT_COLOR, BACKGROUND_COLOR);
+      renderer.renderText(font_sm, occlusionLabel.c_str(), 25, 250, TEXT_COLOR, BACKGROUND_COLOR);
+      renderer.renderText(font_sm, geometryMemoryLabel.c_str(), 25, 275, TEXT_COLOR, BACKGROUND_COLOR);
+      renderer.renderText(font_sm, frameTimesLabel, 25, 300, TEXT_COLOR, BACKGROUND_COLOR);
+      renderer.renderText(font_sm, cpuMemoryLabel.c_str(), 25, 325, TEXT_COLOR, BACKGROUND_COLOR);
+      renderer.renderText(font_sm, gpuMemoryLabel.c_str(), 25, 350, TEXT_COLOR, BACKGROUND_COLOR);
     }
 
     // Render user-defined debug messages
@@ -79,10 +193,15 @@ static void Gm_DisplayDevtools(GmContext* context) {
       u8 index = 0;
 
       for (auto& message : context->debugMessages) {
-        renderer.renderText(font_sm, message.c_str(), 25, 250 + index++ * 25, TEXT_COLOR, BACKGROUND_COLOR);
+        renderer.renderText(font_sm, message.c_str(), 25, 375 + index++ * 25, TEXT_COLOR, BACKGROUND_COLOR);
       }
     }
 
+    // Render profiler scope aggregates
+    if (Gm_IsFlagEnabled(GammaFlags::ENABLE_DEV_PROFILER)) {
+      Gm_DisplayProfiler(context);
+    }
+
     // Display console messages
     {
       auto* message = Console::getFirstMessage();
@@ -135,6 +254,16 @@ GmContext* Gm_CreateContext() {
   context->window.font_sm = TTF_OpenFont("./fonts/OpenSans-Regular.ttf", 16);
   context->window.font_lg = TTF_OpenFont("./fonts/OpenSans-Regular.ttf", 22);
 
+  context->commander.on<std::string>("command", [context](const std::string& command) {
+    if (command.find("memory") != std::string::npos) {
+      const std::string path = "./memory_snapshot.csv";
+
+      Gm_WriteMemorySnapshot(path, Gm_GetMemorySnapshot(context));
+
+      Console::log("[Gamma] Memory snapshot written to", path);
+    }
+  });
+
   return context;
 }
 
@@ -149,6 +278,19 @@ void Gm_OpenWindow(GmContext* context, const char* title, const Gamma::Area<u32>
   context->window.size = size;
 }
 
+/**
+ * Gm_OpenOffscreenWindow
+ * ----------------------
+ *
+ * Sets up a context to render offscreen, without a window,
+ * e.g. for automated performance runs. Render modes set
+ * afterward create their own offscreen surfaces.
+ */
+void Gm_OpenOffscreenWindow(GmContext* context, const Gamma::Area<u32>& size) {
+  context->window.offscreen = true;
+  context->window.size = size;
+}
+
 void Gm_SetWindowSize(GmContext* context, const Area<u32>& size) {
   context->window.size = size;
 
@@ -156,7 +298,7 @@ void Gm_SetWindowSize(GmContext* context, const Area<u32>& size) {
 }
 
 void Gm_SetRenderMode(GmContext* context, GmRenderMode mode) {
-  assert(context->window.sdl_window != nullptr, "Attempted to set render mode before calling Gm_OpenWindow()!");
+  assert(mode == GmRenderMode::HEADLESS || context->window.sdl_window != nullptr || context->window.offscreen, "Attempted to set render mode before calling Gm_OpenWindow()!");
 
   if (context->renderer != nullptr) {
     context->renderer->destroy();
@@ -173,6 +315,9 @@ void Gm_SetRenderMode(GmContext* context, GmRenderMode mode) {
     case GmRenderMode::VULKAN:
       // @todo
       break;
+    case GmRenderMode::HEADLESS:
+      context->renderer = new NullRenderer(context);
+      break;
   }
 
   if (context->renderer != nullptr) {
@@ -180,47 +325,130 @@ void Gm_SetRenderMode(GmContext* context, GmRenderMode mode) {
   }
 }
 
+/**
+ * Gm_RecordInput
+ * --------------
+ *
+ * Records the input state and delta time of each frame,
+ * saving them to a replay file when the context is
+ * destroyed. The random seed is fixed at the start of
+ * recording and saved along with the replay.
+ */
+void Gm_RecordInput(GmContext* context, const std::string& path) {
+  auto& replay = context->inputReplay;
+
+  replay = InputReplay();
+  replay.mode = InputReplayMode::RECORDING;
+  replay.path = path;
+  replay.seed = std::random_device()();
+
+  Gm_SeedRandom(replay.seed);
+}
+
+/**
+ * Gm_ReplayInput
+ * --------------
+ *
+ * Replays recorded input and delta times in place of live
+ * input and timing. Live input events are ignored, and the
+ * window is closed after the last recorded frame.
+ */
+bool Gm_ReplayInput(GmContext* context, const std::string& path) {
+  auto& replay = context->inputReplay;
+
+  replay = InputReplay();
+
+  if (!Gm_LoadInputReplay(path, replay)) {
+    return false;
+  }
+
+  replay.mode = InputReplayMode::REPLAYING;
+  replay.path = path;
+
+  Gm_SeedRandom(replay.seed);
+
+  return true;
+}
+
 float Gm_GetDeltaTime(GmContext* context) {
+  auto& replay = context->inputReplay;
   u32 ticks = SDL_GetTicks();
   float dt = float(ticks - context->lastTick) / 1000.0f;
 
   context->lastTick = ticks;
 
+  if (context->fixedDeltaTime > 0.f) {
+    dt = context->fixedDeltaTime;
+  }
+
+  if (replay.mode == InputReplayMode::REPLAYING && replay.frameIndex < replay.frames.size()) {
+    dt = replay.frames[replay.frameIndex].dt;
+  }
+
+  replay.dt = dt;
+
   return dt;
 }
 
 void Gm_HandleFrameStart(GmContext* context) {
   context->frameStartMicroseconds = Gm_GetMicroseconds();
+  context->framePhaseStartMicroseconds = context->frameStartMicroseconds;
 
-  SDL_Event event;
-
-  while (SDL_PollEvent(&event)) {
-    switch (event.type) {
-      case SDL_QUIT:
-        context->window.closed = true;
-        break;
-      case SDL_WINDOWEVENT:
-        if (event.window.event == SDL_WINDOWEVENT_RESIZED) {
-          context->window.size = {
-            (u32)event.window.data1,
-            (u32)event.window.data2
-          };
-        }
-
-        break;
-      default:
-        break;
+  #if GAMMA_ENABLE_PROFILER
+    Gm_UpdateProfileAggregates();
+  #endif
+
+  GM_PROFILE_SCOPE("Gm_HandleFrameStart");
+
+  {
+    GM_PROFILE_SCOPE("Poll input");
+
+    SDL_Event event;
+
+    while (SDL_PollEvent(&event)) {
+      switch (event.type) {
+        case SDL_QUIT:
+          context->window.closed = true;
+          break;
+        case SDL_WINDOWEVENT:
+          if (event.window.event == SDL_WINDOWEVENT_RESIZED) {
+            context->window.size = {
+              (u32)event.window.data1,
+              (u32)event.window.data2
+            };
+          }
+
+          break;
+        default:
+          break;
+      }
+
+      if (!context->commander.isOpen() && context->inputReplay.mode != InputReplayMode::REPLAYING) {
+        context->scene.input.handleEvent(event);
+      }
+
+      #if GAMMA_DEVELOPER_MODE
+        context->commander.input.handleEvent(event);
+      #endif
     }
+  }
+
+  auto& replay = context->inputReplay;
 
-    if (!context->commander.isOpen()) {
-      context->scene.input.handleEvent(event);
+  if (replay.mode == InputReplayMode::RECORDING) {
+    replay.frames.push_back({ replay.dt, context->scene.input.getState() });
+  } else if (replay.mode == InputReplayMode::REPLAYING) {
+    if (replay.frameIndex < replay.frames.size()) {
+      context->scene.input.setState(replay.frames[replay.frameIndex++].input);
     }
 
-    #if GAMMA_DEVELOPER_MODE
-      context->commander.input.handleEvent(event);
-    #endif
+    if (replay.frameIndex == replay.frames.size()) {
+      context->window.closed = true;
+    }
   }
 
+  Gm_EndFramePhase(context, "input");
+
   if (context->lastTick - context->lastWatchedFilesCheckTime > 1000) {
     Gm_HandleWatchedFiles();
 
@@ -229,33 +457,48 @@ void Gm_HandleFrameStart(GmContext* context) {
 }
 
 void Gm_RenderScene(GmContext* context) {
+  GM_PROFILE_SCOPE("Gm_RenderScene");
+
   auto& renderer = *context->renderer;
 
+  Gm_EndFramePhase(context, "update");
+
   renderer.render();
 
-  for (auto& [ image, x, y, w, h ] : context->scene.ui.surfaces) {
-    renderer.renderSurface(image, x, y, w, h, Vec3f(1.f), Vec4f(0.f));
-  }
+  Gm_EndFramePhase(context, "render");
+
+  {
+    GM_PROFILE_SCOPE("Render UI");
+
+    for (auto& [ image, x, y, w, h ] : context->scene.ui.surfaces) {
+      renderer.renderSurface(image, x, y, w, h, Vec3f(1.f), Vec4f(0.f));
+    }
 
-  for (auto& [ font, text, x, y ] : context->scene.ui.texts) {
-    renderer.renderText(font, text.c_str(), x, y, Vec3f(1.f), Vec4f(0.f));
+    for (auto& [ font, text, x, y ] : context->scene.ui.texts) {
+      renderer.renderText(font, text.c_str(), x, y, Vec3f(1.f), Vec4f(0.f));
+    }
   }
 
   #if GAMMA_DEVELOPER_MODE
     Gm_DisplayDevtools(context);
   #endif
 
+  Gm_EndFramePhase(context, "ui");
+
   renderer.present();
+
+  Gm_EndFramePhase(context, "present");
 }
 
 void Gm_HandleFrameEnd(GmContext* context) {
   using namespace Gamma;
 
   u64 frameTimeInMicroseconds = Gm_GetMicroseconds() - context->frameStartMicroseconds;
-  u32 fps = (u32)(1000000.0f / (float)frameTimeInMicroseconds);
+  u32 fps = frameTimeInMicroseconds > 0 ? (u32)(1000000.0f / (float)frameTimeInMicroseconds) : 0;
 
   context->fpsAverager.add(fps);
   context->frameTimeAverager.add(frameTimeInMicroseconds);
+  context->frameStats.endFrame(context->scene.frame, frameTimeInMicroseconds);
   context->contextTime += frameTimeInMicroseconds / 1000000.0f;
 
   context->scene.frame++;
@@ -271,13 +514,24 @@ void Gm_HandleFrameEnd(GmContext* context) {
 void Gm_DestroyContext(GmContext* context) {
   // @todo clear scene
 
+  if (context->inputReplay.mode == InputReplayMode::RECORDING) {
+    auto& replay = context->inputReplay;
+
+    if (Gm_SaveInputReplay(replay.path, replay)) {
+      Console::log("[Gamma] Saved input replay:", replay.path, "(" + String(replay.frames.size()) + " frames)");
+    }
+  }
+
   IMG_Quit();
 
   TTF_CloseFont(context->window.font_sm);
   TTF_CloseFont(context->window.font_lg);
   TTF_Quit();
 
-  SDL_DestroyWindow(context->window.sdl_window);
+  if (context->window.sdl_window != nullptr) {
+    SDL_DestroyWindow(context->window.sdl_window);
+  }
+
   SDL_Quit();
 }
 
@@ -1,10 +1,12 @@
 #pragma once
 
 #include "math/plane.h"
+#include "performance/frame_stats.h"
 #include "performance/tools.h"
 #include "system/AbstractRenderer.h"
 #include "system/Commander.h"
 #include "system/entities.h"
+#include "system/input_replay.h"
 #include "system/macros.h"
 #include "system/scene.h"
 #include "system/traits.h"
@@ -17,24 +19,40 @@
 
 enum GmRenderMode {
   OPENGL,
-  VULKAN
+  VULKAN,
+  // Performs CPU-side rendering work only; see NullRenderer
+  HEADLESS
 };
 
 struct GmContext {
   GmScene scene;
   Gamma::AbstractRenderer* renderer = nullptr;
   u32 lastTick = 0;
+  /**
+   * When set, Gm_GetDeltaTime() returns this instead of
+   * the real time elapsed, e.g. for uncapped offscreen runs.
+   */
+  float fixedDeltaTime = 0.f;
+  Gamma::InputReplay inputReplay;
   u64 frameStartMicroseconds = 0;
+  u64 framePhaseStartMicroseconds = 0;
   float contextTime = 0.f;
   u32 lastWatchedFilesCheckTime = 0;
   // @todo debug-mode only
   Gamma::Averager<5, u32> fpsAverager;
   Gamma::Averager<5, u64> frameTimeAverager;
+  Gamma::FrameStats frameStats;
   Gamma::Commander commander;
   std::vector<std::string> debugMessages;
 
   struct GmWindow {
     bool closed = false;
+    /**
+     * Set for windows opened with Gm_OpenOffscreenWindow(),
+     * which render to an offscreen surface instead of an
+     * SDL window.
+     */
+    bool offscreen = false;
     TTF_Font* font_sm = nullptr;
     TTF_Font* font_lg = nullptr;
     SDL_Window* sdl_window = nullptr;
@@ -44,7 +62,10 @@ struct GmContext {
 
 GmContext* Gm_CreateContext();
 void Gm_OpenWindow(GmContext* context, const char* title, const Gamma::Area<u32>& size);
+void Gm_OpenOffscreenWindow(GmContext* context, const Gamma::Area<u32>& size);
 void Gm_SetRenderMode(GmContext* context, GmRenderMode mode);
+void Gm_RecordInput(GmContext* context, const std::string& path);
+bool Gm_ReplayInput(GmContext* context, const std::string& path);
 float Gm_GetDeltaTime(GmContext* context);
 void Gm_HandleFrameStart(GmContext* context);
 void Gm_RenderScene(GmContext* context);
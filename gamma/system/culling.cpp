@@ -0,0 +1,108 @@
+#include <cmath>
+
+#include "math/utilities.h"
+#include "system/culling.h"
+#include "system/entities.h"
+
+namespace Gamma {
+  /**
+   * Gm_GetObjectBoundingRadius
+   * --------------------------
+   *
+   * Returns the radius of a sphere enclosing an object,
+   * based on its mesh bounds and largest scale component.
+   * Objects with a scale of 0 have a radius of 0.
+   */
+  float Gm_GetObjectBoundingRadius(const Mesh& mesh, const Object& object) {
+    float scale = Gm_Maxf(Gm_Absf(object.scale.x), Gm_Maxf(Gm_Absf(object.scale.y), Gm_Absf(object.scale.z)));
+
+    return mesh.boundingRadius * scale;
+  }
+
+  /**
+   * Gm_GetCubeFaceMask
+   * ------------------
+   *
+   * Determines which faces of a point light's cube map a sphere
+   * overlaps, returning a bitmask where each bit corresponds to
+   * a face in { -X, +X, -Y, +Y, -Z, +Z } order. Faces are defined
+   * in GL space, matching point light shadow map face directions.
+   */
+  u8 Gm_GetCubeFaceMask(const Vec3f& lightPosition, const Vec3f& center, float radius) {
+    // Each cube face frustum is bounded by four planes at 45 degrees
+    // to the face axis; a sphere overlaps the frustum when it is not
+    // fully behind any of them. Planes are unnormalized, so scale
+    // the radius by sqrt(2) to compensate.
+    constexpr static float SQRT_2 = 1.41421356f;
+    Vec3f local = (center - lightPosition).gl();
+    float axes[3] = { local.x, local.y, local.z };
+    float r = radius * SQRT_2;
+    u8 mask = 0;
+
+    for (u8 axis = 0; axis < 3; axis++) {
+      float a = axes[axis];
+      float b = axes[(axis + 1) % 3];
+      float c = axes[(axis + 2) % 3];
+
+      for (u8 side = 0; side < 2; side++) {
+        float s = side == 0 ? -a : a;
+
+        if (
+          s - b >= -r &&
+          s + b >= -r &&
+          s - c >= -r &&
+          s + c >= -r
+        ) {
+          mask |= 1 << (axis * 2 + side);
+        }
+      }
+    }
+
+    return mask;
+  }
+
+  /**
+   * Gm_IsSphereWithinLightCone
+   * --------------------------
+   *
+   * Determines whether a sphere overlaps a spot light's cone,
+   * using the same cone edge alignment as the spot light shader.
+   */
+  bool Gm_IsSphereWithinLightCone(const Light& light, const Vec3f& center, float radius) {
+    if (!Gm_IsSphereWithinLightRadius(light, center, radius)) {
+      return false;
+    }
+
+    float coneEdgeAlignment = 1.f - (light.fov / 180.f);
+
+    if (coneEdgeAlignment <= -1.f) {
+      // Cone covers the full sphere of directions
+      return true;
+    }
+
+    Vec3f lightToCenter = center - light.position;
+    float distance = lightToCenter.magnitude();
+
+    if (distance <= radius) {
+      return true;
+    }
+
+    float halfAngle = acosf(coneEdgeAlignment);
+    float centerAlignment = Gm_Clampf(Vec3f::dot(lightToCenter / distance, light.direction.unit()), -1.f, 1.f);
+    float centerAngle = acosf(centerAlignment);
+    float sphereAngle = asinf(radius / distance);
+
+    return centerAngle - sphereAngle <= halfAngle;
+  }
+
+  /**
+   * Gm_IsSphereWithinLightRadius
+   * ----------------------------
+   */
+  bool Gm_IsSphereWithinLightRadius(const Light& light, const Vec3f& center, float radius) {
+    Vec3f lightToCenter = center - light.position;
+    float range = light.radius + radius;
+
+    return Vec3f::dot(lightToCenter, lightToCenter) <= range * range;
+  }
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "math/vector.h"
+#include "system/type_aliases.h"
+
+namespace Gamma {
+  struct Light;
+  struct Mesh;
+  struct Object;
+
+  /**
+   * InstanceRun
+   * -----------
+   *
+   * A contiguous range of object instances within an ObjectPool,
+   * used to draw a culled subset of a pool's instances without
+   * reordering its instance data.
+   */
+  struct InstanceRun {
+    u32 offset = 0;
+    u32 count = 0;
+    /**
+     * An optional bitmask for run-specific render targets,
+     * e.g. point light cube map faces.
+     */
+    u8 mask = 0xFF;
+  };
+
+  float Gm_GetObjectBoundingRadius(const Mesh& mesh, const Object& object);
+  u8 Gm_GetCubeFaceMask(const Vec3f& lightPosition, const Vec3f& center, float radius);
+  bool Gm_IsSphereWithinLightCone(const Light& light, const Vec3f& center, float radius);
+  bool Gm_IsSphereWithinLightRadius(const Light& light, const Vec3f& center, float radius);
+}
\ No newline at end of file
@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "performance/parallel.h"
+#include "system/depth_sort.h"
+
+namespace Gamma {
+  constexpr static u32 RADIX_BUCKETS = 256;
+  constexpr static u32 MINIMUM_SORT_BATCH_SIZE = 4096;
+  // Average number of positions each value may move before
+  // insertion sorting is abandoned in favor of radix sorting
+  constexpr static u32 INSERTION_SORT_MOVES_PER_VALUE = 4;
+
+  static std::vector<u16> keys;
+  static std::vector<u16> sortedKeys;
+  static std::vector<u32> sortedValues;
+  static std::vector<u32> histograms;
+  static std::vector<float> batchRanges;
+
+  /**
+   * Gm_ForEachBatch
+   * ---------------
+   *
+   * Runs a handler on each batch of [0, total) in parallel.
+   * Batches are fixed up front, so per-batch results stay
+   * valid even if Gm_ParallelFor() runs serially.
+   */
+  static void Gm_ForEachBatch(u32 total, u32 batchSize, const std::function<void(u32 batch, u32 start, u32 end)>& handler) {
+    u32 totalBatches = (total + batchSize - 1) / batchSize;
+
+    Gm_ParallelFor(totalBatches, 1, [&](u32 firstBatch, u32 lastBatch) {
+      for (u32 batch = firstBatch; batch < lastBatch; batch++) {
+        handler(batch, batch * batchSize, std::min(batch * batchSize + batchSize, total));
+      }
+    });
+  }
+
+  /**
+   * Gm_QuantizeDepths
+   * -----------------
+   *
+   * Maps depths onto keys in [0, 65535], reversing them when
+   * sorting back-to-front so keys are always sorted ascending.
+   */
+  static void Gm_QuantizeDepths(const float* depths, u32 total, u32 batchSize, DepthSortOrder order) {
+    u32 totalBatches = (total + batchSize - 1) / batchSize;
+
+    batchRanges.resize(totalBatches * 2);
+
+    Gm_ForEachBatch(total, batchSize, [&](u32 batch, u32 start, u32 end) {
+      float minDepth = depths[start];
+      float maxDepth = depths[start];
+
+      for (u32 i = start + 1; i < end; i++) {
+        minDepth = std::min(minDepth, depths[i]);
+        maxDepth = std::max(maxDepth, depths[i]);
+      }
+
+      batchRanges[batch * 2] = minDepth;
+      batchRanges[batch * 2 + 1] = maxDepth;
+    });
+
+    float minDepth = batchRanges[0];
+    float maxDepth = batchRanges[1];
+
+    for (u32 i = 1; i < totalBatches; i++) {
+      minDepth = std::min(minDepth, batchRanges[i * 2]);
+      maxDepth = std::max(maxDepth, batchRanges[i * 2 + 1]);
+    }
+
+    float scale = maxDepth > minDepth ? 65535.f / (maxDepth - minDepth) : 0.f;
+
+    Gm_ForEachBatch(total, batchSize, [&](u32, u32 start, u32 end) {
+      for (u32 i = start; i < end; i++) {
+        u16 key = u16((depths[i] - minDepth) * scale);
+
+        keys[i] = order == DepthSortOrder::FRONT_TO_BACK ? key : 0xFFFF - key;
+      }
+    });
+  }
+
+  /**
+   * Gm_InsertionSort
+   * ----------------
+   *
+   * Insertion sorts keys/values until a budget of moves is
+   * exhausted. Returns false if the budget runs out, leaving
+   * keys/values partially sorted.
+   */
+  static bool Gm_InsertionSort(u32* values, u32 total, u32 maxMoves) {
+    u32 moves = 0;
+
+    for (u32 i = 1; i < total; i++) {
+      u16 key = keys[i];
+      u32 value = values[i];
+      u32 j = i;
+
+      while (j > 0 && keys[j - 1] > key) {
+        keys[j] = keys[j - 1];
+        values[j] = values[j - 1];
+
+        j--;
+      }
+
+      keys[j] = key;
+      values[j] = value;
+      moves += i - j;
+
+      if (moves > maxMoves) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * Gm_RadixSort
+   * ------------
+   *
+   * Sorts keys/values with two 8-bit LSD radix passes. Each
+   * batch counts its digits and scatters its values to its
+   * own offsets within each digit bucket, so batches can run
+   * in parallel while keeping the sort stable.
+   */
+  static void Gm_RadixSort(u32* values, u32 total, u32 batchSize) {
+    u32 totalBatches = (total + batchSize - 1) / batchSize;
+    u16* keysIn = keys.data();
+    u16* keysOut = sortedKeys.data();
+    u32* valuesIn = values;
+    u32* valuesOut = sortedValues.data();
+
+    histograms.resize(totalBatches * RADIX_BUCKETS);
+
+    for (u32 shift = 0; shift < 16; shift += 8) {
+      Gm_ForEachBatch(total, batchSize, [&](u32 batch, u32 start, u32 end) {
+        u32* histogram = &histograms[batch * RADIX_BUCKETS];
+
+        std::fill(histogram, histogram + RADIX_BUCKETS, 0);
+
+        for (u32 i = start; i < end; i++) {
+          histogram[(keysIn[i] >> shift) & 0xFF]++;
+        }
+      });
+
+      // Skip passes where all keys share the same digit
+      bool hasSingleDigit = false;
+
+      for (u32 digit = 0; digit < RADIX_BUCKETS; digit++) {
+        u32 count = 0;
+
+        for (u32 batch = 0; batch < totalBatches; batch++) {
+          count += histograms[batch * RADIX_BUCKETS + digit];
+        }
+
+        if (count == total) {
+          hasSingleDigit = true;
+
+          break;
+        } else if (count > 0) {
+          break;
+        }
+      }
+
+      if (hasSingleDigit) {
+        continue;
+      }
+
+      // Convert counts into scatter offsets, ordered by
+      // digit, then by batch
+      u32 offset = 0;
+
+      for (u32 digit = 0; digit < RADIX_BUCKETS; digit++) {
+        for (u32 batch = 0; batch < totalBatches; batch++) {
+          u32& entry = histograms[batch * RADIX_BUCKETS + digit];
+          u32 count = entry;
+
+          entry = offset;
+          offset += count;
+        }
+      }
+
+      Gm_ForEachBatch(total, batchSize, [&](u32 batch, u32 start, u32 end) {
+        u32* offsets = &histograms[batch * RADIX_BUCKETS];
+
+        for (u32 i = start; i < end; i++) {
+          u32 target = offsets[(keysIn[i] >> shift) & 0xFF]++;
+
+          keysOut[target] = keysIn[i];
+          valuesOut[target] = valuesIn[i];
+        }
+      });
+
+      std::swap(keysIn, keysOut);
+      std::swap(valuesIn, valuesOut);
+    }
+
+    if (valuesIn != values) {
+      std::copy(valuesIn, valuesIn + total, values);
+    }
+  }
+
+  bool Gm_SortByDepth(const float* depths, u32* values, u32 total, DepthSortOrder order) {
+    if (total < 2) {
+      return false;
+    }
+
+    u32 batchSize = std::max(MINIMUM_SORT_BATCH_SIZE, (total + Gm_GetTotalParallelThreads() - 1) / Gm_GetTotalParallelThreads());
+
+    keys.resize(total);
+
+    Gm_QuantizeDepths(depths, total, batchSize, order);
+
+    bool isSorted = true;
+
+    for (u32 i = 1; i < total; i++) {
+      if (keys[i - 1] > keys[i]) {
+        isSorted = false;
+
+        break;
+      }
+    }
+
+    if (isSorted) {
+      return false;
+    }
+
+    if (!Gm_InsertionSort(values, total, total * INSERTION_SORT_MOVES_PER_VALUE)) {
+      sortedKeys.resize(total);
+      sortedValues.resize(total);
+
+      Gm_RadixSort(values, total, batchSize);
+    }
+
+    return true;
+  }
+}
\ No newline at end of file
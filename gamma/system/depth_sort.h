@@ -0,0 +1,28 @@
+#pragma once
+
+#include "system/type_aliases.h"
+
+namespace Gamma {
+  enum DepthSortOrder {
+    FRONT_TO_BACK,
+    BACK_TO_FRONT
+  };
+
+  /**
+   * Gm_SortByDepth
+   * --------------
+   *
+   * Sorts a list of values by their corresponding depths,
+   * quantizing depths to 16-bit keys over their range and
+   * radix sorting the keys in parallel. Input which is
+   * already nearly sorted, e.g. values sorted on a previous
+   * frame, is finished with a bounded insertion sort instead.
+   *
+   * Returns false if the values were already in order and
+   * were left untouched. Depths are not reordered.
+   *
+   * Uses shared scratch buffers, and must only be called
+   * from one thread at a time.
+   */
+  bool Gm_SortByDepth(const float* depths, u32* values, u32 total, DepthSortOrder order);
+}
\ No newline at end of file
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <map>
@@ -5,11 +6,20 @@
 
 #include "math/vector.h"
 #include "math/utilities.h"
+#include "performance/parallel.h"
 #include "system/assert.h"
 #include "system/entities.h"
 #include "system/ObjLoader.h"
 
 namespace Gamma {
+  constexpr static u32 TRANSFORM_BATCH_SIZE = 1024;
+  constexpr static u32 GENERATOR_BATCH_SIZE = 16384;
+  constexpr static u32 GENERATOR_ROW_BATCH_SIZE = 16;
+  constexpr static u32 VERTEX_BATCH_SIZE = 16384;
+  constexpr static u32 MIN_FACES_PER_CHUNK = 16384;
+  // Maximum ratio of total chunk vertex sums to mesh vertices
+  constexpr static u32 MAX_CHUNK_VERTEX_RATIO = 4;
+
   /**
    * Defines positions for each corner of the unit cube
    */
@@ -47,47 +57,177 @@ namespace Gamma {
   };
 
   /**
-   * Gm_ComputeNormals
-   * -----------------
+   * FaceChunk
+   * ---------
+   *
+   * A range of mesh faces, and the per-vertex sums of a face
+   * vector over the range of vertices those faces refer to.
    */
-  static void Gm_ComputeNormals(Mesh* mesh) {
+  struct FaceChunk {
+    u32 start = 0;
+    u32 end = 0;
+    u32 minVertex = 0;
+    u32 maxVertex = 0;
+    std::vector<Vec3f> sums;
+  };
+
+  /**
+   * Gm_AccumulateFaceVectors
+   * ------------------------
+   *
+   * Sets a vertex attribute to the normalized sum of a vector
+   * computed for each face the vertex belongs to.
+   *
+   * Faces are split into chunks, each summing its face vectors
+   * in parallel into a buffer spanning only the vertices its
+   * faces refer to. Chunk sums are then gathered per vertex,
+   * also in parallel. Meshes with spatially coherent faces,
+   * e.g. all procedural meshes, have narrow chunk vertex
+   * ranges; meshes where chunk ranges would use too much
+   * memory, small meshes, and single-threaded runs sum
+   * directly into the vertices instead.
+   */
+  template<typename FaceVectorHandler>
+  static void Gm_AccumulateFaceVectors(Mesh* mesh, Vec3f Vertex::* attribute, FaceVectorHandler getFaceVector) {
     auto& vertices = mesh->vertices;
     auto& faceElements = mesh->faceElements;
+    u32 totalVertices = vertices.size();
+    u32 totalFaces = faceElements.size() / 3;
+
+    if (totalVertices == 0) {
+      return;
+    }
+
+    u32 totalThreads = Gm_GetTotalParallelThreads();
+    u32 maxChunks = totalThreads > 1 ? totalThreads * 4 : 1;
+    u32 totalChunks = std::max(1u, std::min(maxChunks, totalFaces / MIN_FACES_PER_CHUNK));
+    u32 chunkSize = (totalFaces + totalChunks - 1) / totalChunks;
+    std::vector<FaceChunk> chunks(totalChunks);
+
+    auto sumIntoVertices = [&]() {
+      for (auto& vertex : vertices) {
+        vertex.*attribute = Vec3f(0.f);
+      }
+
+      for (u32 e = 0; e + 2 < totalFaces * 3; e += 3) {
+        Vertex& v1 = vertices[faceElements[e]];
+        Vertex& v2 = vertices[faceElements[e + 1]];
+        Vertex& v3 = vertices[faceElements[e + 2]];
+        Vec3f vector = getFaceVector(v1, v2, v3);
+
+        v1.*attribute += vector;
+        v2.*attribute += vector;
+        v3.*attribute += vector;
+      }
+
+      for (auto& vertex : vertices) {
+        vertex.*attribute = (vertex.*attribute).unit();
+      }
+    };
 
-    for (auto& vertex : vertices) {
-      vertex.normal = Vec3f(0.f);
+    if (totalChunks == 1) {
+      // Chunk buffers only pay off when summed in parallel
+      sumIntoVertices();
+
+      return;
     }
 
-    for (u32 i = 0; i < faceElements.size(); i += 3) {
-      Vertex& v1 = vertices[faceElements[i]];
-      Vertex& v2 = vertices[faceElements[i + 1]];
-      Vertex& v3 = vertices[faceElements[i + 2]];
+    // Determine the vertex range of each chunk
+    Gm_ParallelFor(totalChunks, 1, [&](u32 start, u32 end) {
+      for (u32 i = start; i < end; i++) {
+        auto& chunk = chunks[i];
+
+        chunk.start = std::min(i * chunkSize, totalFaces);
+        chunk.end = std::min(chunk.start + chunkSize, totalFaces);
+        chunk.minVertex = totalVertices - 1;
+        chunk.maxVertex = 0;
+
+        for (u32 e = chunk.start * 3; e < chunk.end * 3; e++) {
+          chunk.minVertex = std::min(chunk.minVertex, faceElements[e]);
+          chunk.maxVertex = std::max(chunk.maxVertex, faceElements[e]);
+        }
+      }
+    });
 
-      Vec3f normal = Vec3f::cross(v2.position - v1.position, v3.position - v1.position).unit();
+    u64 totalChunkVertices = 0;
 
-      v1.normal += normal;
-      v2.normal += normal;
-      v3.normal += normal;
+    for (auto& chunk : chunks) {
+      if (chunk.end > chunk.start) {
+        totalChunkVertices += chunk.maxVertex - chunk.minVertex + 1;
+      }
     }
 
-    for (auto& vertex : vertices) {
-      vertex.normal = vertex.normal.unit();
+    if (totalChunkVertices > (u64)totalVertices * MAX_CHUNK_VERTEX_RATIO) {
+      sumIntoVertices();
+
+      return;
     }
+
+    // Sum face vectors within each chunk
+    Gm_ParallelFor(chunks.size(), 1, [&](u32 start, u32 end) {
+      for (u32 i = start; i < end; i++) {
+        auto& chunk = chunks[i];
+
+        if (chunk.end == chunk.start) {
+          continue;
+        }
+
+        chunk.sums.assign(chunk.maxVertex - chunk.minVertex + 1, Vec3f(0.f));
+
+        for (u32 f = chunk.start; f < chunk.end; f++) {
+          u32 e1 = faceElements[f * 3];
+          u32 e2 = faceElements[f * 3 + 1];
+          u32 e3 = faceElements[f * 3 + 2];
+          Vec3f vector = getFaceVector(vertices[e1], vertices[e2], vertices[e3]);
+
+          chunk.sums[e1 - chunk.minVertex] += vector;
+          chunk.sums[e2 - chunk.minVertex] += vector;
+          chunk.sums[e3 - chunk.minVertex] += vector;
+        }
+      }
+    });
+
+    // Gather chunk sums for each vertex
+    Gm_ParallelFor(totalVertices, VERTEX_BATCH_SIZE, [&](u32 start, u32 end) {
+      for (u32 v = start; v < end; v++) {
+        vertices[v].*attribute = Vec3f(0.f);
+      }
+
+      for (auto& chunk : chunks) {
+        if (chunk.end == chunk.start || chunk.maxVertex < start || chunk.minVertex >= end) {
+          continue;
+        }
+
+        u32 first = std::max(start, chunk.minVertex);
+        u32 last = std::min(end - 1, chunk.maxVertex);
+
+        for (u32 v = first; v <= last; v++) {
+          vertices[v].*attribute += chunk.sums[v - chunk.minVertex];
+        }
+      }
+
+      for (u32 v = start; v < end; v++) {
+        vertices[v].*attribute = (vertices[v].*attribute).unit();
+      }
+    });
+  }
+
+  /**
+   * Gm_ComputeNormals
+   * -----------------
+   */
+  void Gm_ComputeNormals(Mesh* mesh) {
+    Gm_AccumulateFaceVectors(mesh, &Vertex::normal, [](const Vertex& v1, const Vertex& v2, const Vertex& v3) {
+      return Vec3f::cross(v2.position - v1.position, v3.position - v1.position).unit();
+    });
   }
 
   /**
    * Gm_ComputeTangents
    * ------------------
    */
-  static void Gm_ComputeTangents(Mesh* mesh) {
-    auto& vertices = mesh->vertices;
-    auto& faceElements = mesh->faceElements;
-
-    for (u32 i = 0; i < faceElements.size(); i += 3) {
-      Vertex& v1 = vertices[faceElements[i]];
-      Vertex& v2 = vertices[faceElements[i + 1]];
-      Vertex& v3 = vertices[faceElements[i + 2]];
-
+  void Gm_ComputeTangents(Mesh* mesh) {
+    Gm_AccumulateFaceVectors(mesh, &Vertex::tangent, [](const Vertex& v1, const Vertex& v2, const Vertex& v3) {
       Vec3f e1 = v2.position - v1.position;
       Vec3f e2 = v3.position - v1.position;
 
@@ -102,20 +242,12 @@ namespace Gamma {
       // and there is no delta between uv coordinates
       float f = 1.0f / (d == 0.f ? 0.001f : d);
 
-      Vec3f tangent = {
+      return Vec3f(
         f * (deltaV2 * e1.x - deltaV1 * e2.x),
         f * (deltaV2 * e1.y - deltaV1 * e2.y),
         f * (deltaV2 * e1.z - deltaV1 * e2.z)
-      };
-
-      v1.tangent += tangent;
-      v2.tangent += tangent;
-      v3.tangent += tangent;
-    }
-
-    for (auto& vertex : vertices) {
-      vertex.tangent = vertex.tangent.unit();
-    }
+      );
+    });
   }
 
   /**
@@ -126,12 +258,11 @@ namespace Gamma {
    * defined in a preliminary state, into vertex/face element
    * buffers defined on Meshes or other global buffers.
    *
-   * @todo we may not want to add the base vertex offset here;
-   * once this is used to pack multiple (distinct, not merely LOD)
-   * meshes into a common vertex/element buffer, it may be preferable
-   * to associate a baseVertex/firstIndex with each mesh. firstIndex
-   * alone is technically feasible though. reconsider when revisiting
-   * this for glMultiDrawElementsIndirect().
+   * Face elements are offset by the base vertex of each
+   * LOD within the mesh. Distinct meshes packed into the
+   * global geometry buffers are instead drawn with their
+   * own baseVertex/firstIndex, so mesh data itself remains
+   * relative to the start of the mesh.
    */
   static void Gm_BufferObjData(const ObjLoader& obj, std::vector<Vertex>& vertices, std::vector<u32>& faceElements) {
     u32 baseVertex = vertices.size();
@@ -217,6 +348,8 @@ namespace Gamma {
     auto& vertices = mesh->vertices;
     auto& faceElements = mesh->faceElements;
 
+    mesh->geometryKey = "cube";
+
     vertices.resize(24);
     faceElements.resize(36);
 
@@ -261,91 +394,86 @@ namespace Gamma {
     auto* mesh = new Mesh();
     auto& vertices = mesh->vertices;
     auto& faceElements = mesh->faceElements;
-    u8 h_divisions = u8(float(divisions) * 1.5f);
+    u32 h_divisions = u32(float(divisions) * 1.5f);
+    u32 totalRings = divisions > 2 ? divisions - 2 : 0;
+    u32 totalMidSections = divisions > 3 ? divisions - 3 : 0;
 
-    // Pole vertices
-    Vertex pole1, pole2;
+    mesh->geometryKey = "sphere:" + std::to_string(divisions);
 
-    // Top pole vertex
-    pole1.position = Vec3f(0, 1.f, 0);
+    vertices.resize(2 + totalRings * h_divisions);
+    faceElements.resize((2 + totalMidSections * 2) * h_divisions * 3);
 
-    vertices.push_back(pole1);
+    // Top pole vertex
+    vertices[0].position = Vec3f(0, 1.f, 0);
 
     // Surface vertices
-    for (u8 i = 1; i < divisions - 1; i++) {
-      for (u8 j = 0; j < h_divisions; j++) {
-        float y_progress = float(i) / float(divisions - 1);
-        float radius = std::sinf(y_progress * Gm_PI);
-        float x = radius * std::cosf(float(j) / float(h_divisions) * Gm_TAU);
-        float y = 1.f - 2.f * Gm_EaseInOut(y_progress);
-        float z = radius * std::sinf(float(j) / float(h_divisions) * Gm_TAU);
-
-        Vertex vertex;
-
-        vertex.position = Vec3f(x, y, z);
-
-        vertices.push_back(vertex);
+    Gm_ParallelFor(totalRings, GENERATOR_ROW_BATCH_SIZE, [&](u32 start, u32 end) {
+      for (u32 i = start + 1; i < end + 1; i++) {
+        for (u32 j = 0; j < h_divisions; j++) {
+          float y_progress = float(i) / float(divisions - 1);
+          float radius = sinf(y_progress * Gm_PI);
+          float x = radius * cosf(float(j) / float(h_divisions) * Gm_TAU);
+          float y = 1.f - 2.f * Gm_EaseInOut(y_progress);
+          float z = radius * sinf(float(j) / float(h_divisions) * Gm_TAU);
+
+          vertices[1 + (i - 1) * h_divisions + j].position = Vec3f(x, y, z);
+        }
       }
-    }
+    });
 
     // Bottom pole vertex
-    pole2.position = Vec3f(0, -1.f, 0);
-
-    vertices.push_back(pole2);
-
-    // Top cap faces
-    for (u8 i = 0; i < h_divisions; i++) {
-      u32 f1 = 0;
-      u32 f2 = (i + 1) % h_divisions + 1;
-      u32 f3 = i + 1;
-
-      faceElements.push_back(f1);
-      faceElements.push_back(f2);
-      faceElements.push_back(f3);
-    }
-
-    // Mid-section faces
-    for (u8 i = 1; i < divisions - 2; i++) {
-      u32 v_start = 1 + (i - 1) * h_divisions;
-      u32 v_end = v_start + h_divisions;
-
-      for (u8 j = 0; j < h_divisions; j++) {
-        u32 v_offset = v_start + j;
+    u32 lastVertexIndex = vertices.size() - 1;
 
-        u32 f1 = v_offset;
-        u32 f2 = v_offset + 1;
-        u32 f3 = v_offset + h_divisions;
+    vertices[lastVertexIndex].position = Vec3f(0, -1.f, 0);
 
-        // Ensure that the second vertex index stays on
-        // the same horizontal 'line' of the sphere
-        if (f2 >= v_end) f2 -= h_divisions;
+    // Top/bottom cap faces
+    u32 bottomCapOffset = (1 + totalMidSections * 2) * h_divisions * 3;
 
-        u32 f4 = f2;
-        u32 f5 = f2 + h_divisions;
-        u32 f6 = f1 + h_divisions;
+    for (u32 i = 0; i < h_divisions; i++) {
+      u32* top = &faceElements[i * 3];
+      u32* bottom = &faceElements[bottomCapOffset + i * 3];
 
-        faceElements.push_back(f1);
-        faceElements.push_back(f2);
-        faceElements.push_back(f3);
+      top[0] = 0;
+      top[1] = (i + 1) % h_divisions + 1;
+      top[2] = i + 1;
 
-        faceElements.push_back(f4);
-        faceElements.push_back(f5);
-        faceElements.push_back(f6);
-      }
+      bottom[0] = lastVertexIndex;
+      bottom[1] = lastVertexIndex - (i + 1) % h_divisions - 1;
+      bottom[2] = lastVertexIndex - (i + 1);
     }
 
-    // Bottom cap faces
-    u32 lastVertexIndex = vertices.size() - 1;
-
-    for (u8 i = 0; i < h_divisions; i++) {
-      u32 f1 = lastVertexIndex;
-      u32 f2 = lastVertexIndex - (i + 1) % h_divisions - 1;
-      u32 f3 = lastVertexIndex - (i + 1);
-
-      faceElements.push_back(f1);
-      faceElements.push_back(f2);
-      faceElements.push_back(f3);
-    }
+    // Mid-section faces
+    Gm_ParallelFor(totalMidSections, GENERATOR_ROW_BATCH_SIZE, [&](u32 start, u32 end) {
+      for (u32 i = start + 1; i < end + 1; i++) {
+        u32 v_start = 1 + (i - 1) * h_divisions;
+        u32 v_end = v_start + h_divisions;
+
+        for (u32 j = 0; j < h_divisions; j++) {
+          u32 v_offset = v_start + j;
+          u32* face = &faceElements[(h_divisions + ((i - 1) * h_divisions + j) * 2) * 3];
+
+          u32 f1 = v_offset;
+          u32 f2 = v_offset + 1;
+          u32 f3 = v_offset + h_divisions;
+
+          // Ensure that the second vertex index stays on
+          // the same horizontal 'line' of the sphere
+          if (f2 >= v_end) f2 -= h_divisions;
+
+          u32 f4 = f2;
+          u32 f5 = f2 + h_divisions;
+          u32 f6 = f1 + h_divisions;
+
+          face[0] = f1;
+          face[1] = f2;
+          face[2] = f3;
+
+          face[3] = f4;
+          face[4] = f5;
+          face[5] = f6;
+        }
+      }
+    });
 
     Gm_ComputeNormals(mesh);
     Gm_ComputeTangents(mesh);
@@ -364,6 +492,8 @@ namespace Gamma {
 
     auto* mesh = new Mesh();
 
+    mesh->geometryKey = std::string("model:") + path;
+
     Gm_BufferObjData(obj, mesh->vertices, mesh->faceElements);
 
     if (obj.normals.size() == 0) {
@@ -390,6 +520,7 @@ namespace Gamma {
 
     auto* mesh = new Mesh();
 
+    mesh->geometryKey = "model:";
     mesh->lods.resize(paths.size());
 
     for (u32 i = 0; i < paths.size(); i++) {
@@ -397,6 +528,8 @@ namespace Gamma {
 
       ObjLoader obj(path);
 
+      mesh->geometryKey += (i > 0 ? "|" : "") + paths[i];
+
       mesh->lods[i].elementOffset = mesh->faceElements.size();
       mesh->lods[i].vertexOffset = mesh->vertices.size();
 
@@ -440,12 +573,22 @@ namespace Gamma {
     auto* mesh = new Mesh();
     auto& vertices = mesh->vertices;
     auto& faceElements = mesh->faceElements;
+    u32 totalFaceVertices = size * size;
+    u32 totalFaceElements = (size - 1) * (size - 1) * 6;
+    // Generate around GENERATOR_BATCH_SIZE vertices per batch of rows
+    u32 rowsPerBatch = std::max(1u, GENERATOR_BATCH_SIZE / size);
+
+    mesh->geometryKey = "plane:" + std::to_string(size) + (useLoopingTexture ? ":looping" : "");
+
+    vertices.resize(totalFaceVertices * 2);
+    faceElements.resize(totalFaceElements * 2);
 
     // Front + back face vertices
-    for (u8 i = 0; i < 2; i++) {
-      // @bug size should represent the total number of
-      // tiles across the plane, not the total vertices
-      for (u32 x = 0; x < size; x++) {
+    //
+    // @bug size should represent the total number of
+    // tiles across the plane, not the total vertices
+    Gm_ParallelFor(size, rowsPerBatch, [&](u32 start, u32 end) {
+      for (u32 x = start; x < end; x++) {
         for (u32 z = 0; z < size; z++) {
           Vertex vertex;
 
@@ -460,42 +603,40 @@ namespace Gamma {
             vertex.uv = Vec2f(xr, 1.f - zr);
           }
 
-          vertices.push_back(vertex);
+          vertices[x * size + z] = vertex;
+          vertices[totalFaceVertices + x * size + z] = vertex;
         }
       }
-    }
+    });
 
-    // Front face
-    for (u32 z = 0; z < size - 1; z++) {
-      for (u32 x = 0; x < size - 1; x++) {
-        u32 offset = z * size + x;
+    // Front + back faces
+    Gm_ParallelFor(size - 1, rowsPerBatch, [&](u32 start, u32 end) {
+      for (u32 z = start; z < end; z++) {
+        for (u32 x = 0; x < size - 1; x++) {
+          u32 offset = z * size + x;
+          u32* front = &faceElements[(z * (size - 1) + x) * 6];
+          u32* back = front + totalFaceElements;
 
-        faceElements.push_back(offset);
-        faceElements.push_back(offset + 1 + size);
-        faceElements.push_back(offset + 1);
+          front[0] = offset;
+          front[1] = offset + 1 + size;
+          front[2] = offset + 1;
 
-        faceElements.push_back(offset);
-        faceElements.push_back(offset + size);
-        faceElements.push_back(offset + 1 + size);
-      }
-    }
-
-    // Back face
-    auto startingOffset = size * size;
+          front[3] = offset;
+          front[4] = offset + size;
+          front[5] = offset + 1 + size;
 
-    for (u32 z = 0; z < size - 1; z++) {
-      for (u32 x = 0; x < size - 1; x++) {
-        u32 offset = startingOffset + z * size + x;
+          offset += totalFaceVertices;
 
-        faceElements.push_back(offset);
-        faceElements.push_back(offset + 1);
-        faceElements.push_back(offset + 1 + size);
+          back[0] = offset;
+          back[1] = offset + 1;
+          back[2] = offset + 1 + size;
 
-        faceElements.push_back(offset);
-        faceElements.push_back(offset + 1 + size);
-        faceElements.push_back(offset + size);
+          back[3] = offset;
+          back[4] = offset + 1 + size;
+          back[5] = offset + size;
+        }
       }
-    }
+    });
 
     Gm_ComputeNormals(mesh);
     Gm_ComputeTangents(mesh);
@@ -514,64 +655,282 @@ namespace Gamma {
     auto& vertices = mesh->vertices;
     auto& faceElements = mesh->faceElements;
 
-    // Generate the center vertex
-    Vertex center;
+    mesh->geometryKey = "disc:" + std::to_string(slices);
 
-    center.position.x = 0.f;
-    center.position.z = 0.f;
+    vertices.resize(slices + 2);
+    faceElements.resize(slices * 3);
 
-    vertices.push_back(center);
+    // Generate the center vertex
+    vertices[0].position.x = 0.f;
+    vertices[0].position.z = 0.f;
 
     // Generate the edge vertices
-    for (u32 i = 0; i < slices + 1; i++) {
-      float ratio = (i / (float)slices) * Gm_TAU;
-
-      Vertex vertex;
-
-      vertex.position.x = cosf(ratio);
-      vertex.position.z = sinf(ratio);
+    Gm_ParallelFor(slices + 1, GENERATOR_BATCH_SIZE, [&](u32 start, u32 end) {
+      for (u32 i = start; i < end; i++) {
+        float ratio = (i / (float)slices) * Gm_TAU;
+        auto& vertex = vertices[i + 1];
 
-      vertex.uv.x = vertex.position.x * 0.5f + 0.5f;
-      vertex.uv.y = vertex.position.z * 0.5f + 0.5f;
+        vertex.position.x = cosf(ratio);
+        vertex.position.z = sinf(ratio);
 
-      vertices.push_back(vertex);
-    }
+        vertex.uv.x = vertex.position.x * 0.5f + 0.5f;
+        vertex.uv.y = vertex.position.z * 0.5f + 0.5f;
+      }
+    });
 
     // Generate the faces
-    for (u32 i = 0; i < slices; i++) {
-      if (i == slices - 1) {
-        faceElements.push_back(1);
-      } else {
-        faceElements.push_back(i + 2);
+    Gm_ParallelFor(slices, GENERATOR_BATCH_SIZE, [&](u32 start, u32 end) {
+      for (u32 i = start; i < end; i++) {
+        u32* face = &faceElements[i * 3];
+
+        face[0] = i == slices - 1 ? 1 : i + 2;
+        face[1] = i + 1;
+        face[2] = 0;
       }
+    });
 
-      faceElements.push_back(i + 1);
-      faceElements.push_back(0);
-    }
+    Gm_ComputeNormals(mesh);
+    Gm_ComputeTangents(mesh);
+
+    return mesh;
+  }
+
+  /**
+   * Mesh::Cylinder()
+   * ----------------
+   *
+   * Constructs a cylinder Mesh of radius 1 and height 2 with a
+   * given number of divisions around its circumference. Cap
+   * vertices are distinct from side vertices, so the caps
+   * remain flat-shaded.
+   */
+  Mesh* Mesh::Cylinder(u32 divisions) {
+    auto* mesh = new Mesh();
+    auto& vertices = mesh->vertices;
+    auto& faceElements = mesh->faceElements;
+    // Side vertices repeat the first column at the end,
+    // so side uvs can wrap around without a seam
+    u32 sideColumns = divisions + 1;
+    u32 topSide = 0;
+    u32 bottomSide = sideColumns;
+    u32 topCap = sideColumns * 2;
+    u32 bottomCap = topCap + divisions + 1;
+
+    mesh->geometryKey = "cylinder:" + std::to_string(divisions);
+
+    vertices.resize(sideColumns * 2 + (divisions + 1) * 2);
+    faceElements.resize(divisions * 12);
+
+    // Cap center vertices
+    vertices[topCap].position = Vec3f(0, 1.f, 0);
+    vertices[topCap].uv = Vec2f(0.5f);
+    vertices[bottomCap].position = Vec3f(0, -1.f, 0);
+    vertices[bottomCap].uv = Vec2f(0.5f);
+
+    // Side and cap edge vertices
+    Gm_ParallelFor(sideColumns, GENERATOR_BATCH_SIZE, [&](u32 start, u32 end) {
+      for (u32 j = start; j < end; j++) {
+        float progress = float(j) / float(divisions);
+        float x = cosf(progress * Gm_TAU);
+        float z = sinf(progress * Gm_TAU);
+
+        vertices[topSide + j].position = Vec3f(x, 1.f, z);
+        vertices[topSide + j].uv = Vec2f(progress, 0.f);
+        vertices[bottomSide + j].position = Vec3f(x, -1.f, z);
+        vertices[bottomSide + j].uv = Vec2f(progress, 1.f);
+
+        if (j < divisions) {
+          Vec2f uv = Vec2f(x * 0.5f + 0.5f, z * 0.5f + 0.5f);
+
+          vertices[topCap + 1 + j].position = Vec3f(x, 1.f, z);
+          vertices[topCap + 1 + j].uv = uv;
+          vertices[bottomCap + 1 + j].position = Vec3f(x, -1.f, z);
+          vertices[bottomCap + 1 + j].uv = uv;
+        }
+      }
+    });
+
+    // Side and cap faces, wound consistently with Sphere()
+    Gm_ParallelFor(divisions, GENERATOR_BATCH_SIZE, [&](u32 start, u32 end) {
+      for (u32 j = start; j < end; j++) {
+        u32 next = (j + 1) % divisions;
+        u32* side = &faceElements[j * 6];
+        u32* top = &faceElements[divisions * 6 + j * 3];
+        u32* bottom = &faceElements[divisions * 9 + j * 3];
+
+        side[0] = topSide + j;
+        side[1] = topSide + j + 1;
+        side[2] = bottomSide + j;
+
+        side[3] = topSide + j + 1;
+        side[4] = bottomSide + j + 1;
+        side[5] = bottomSide + j;
+
+        top[0] = topCap;
+        top[1] = topCap + 1 + next;
+        top[2] = topCap + 1 + j;
+
+        bottom[0] = bottomCap;
+        bottom[1] = bottomCap + 1 + j;
+        bottom[2] = bottomCap + 1 + next;
+      }
+    });
 
     Gm_ComputeNormals(mesh);
     Gm_ComputeTangents(mesh);
 
+    // Use exact radial side normals/tangents, which would otherwise
+    // be skewed by the triangulation and split at the uv seam
+    for (u32 j = 0; j < sideColumns; j++) {
+      for (u32 side : { topSide, bottomSide }) {
+        auto& vertex = vertices[side + j];
+
+        vertex.normal = Vec3f(vertex.position.x, 0.f, vertex.position.z);
+        vertex.tangent = Vec3f(-vertex.position.z, 0.f, vertex.position.x);
+      }
+    }
+
     return mesh;
   }
 
   /**
-   * Mesh::transformGeometry()
-   * -------------------------
+   * Gm_CreateMeshFromGeometryKey
+   * ----------------------------
    *
-   * @todo description
+   * Recreates a Mesh from its geometry key, returning
+   * nullptr if the key doesn't describe a Mesh constructor.
+   */
+  static Mesh* Gm_CreateMeshFromGeometryKey(const std::string& key) {
+    auto separator = key.find(':');
+    std::string type = key.substr(0, separator);
+    std::string parameters = separator == std::string::npos ? "" : key.substr(separator + 1);
+
+    if (type == "cube") {
+      return Mesh::Cube();
+    } else if (type == "sphere") {
+      return Mesh::Sphere((u8)std::stoi(parameters));
+    } else if (type == "plane") {
+      return Mesh::Plane(std::stoi(parameters), parameters.find(":looping") != std::string::npos);
+    } else if (type == "disc") {
+      return Mesh::Disc(std::stoi(parameters));
+    } else if (type == "cylinder") {
+      return Mesh::Cylinder(std::stoi(parameters));
+    } else if (type == "model") {
+      std::vector<std::string> paths;
+      size_t start = 0;
+
+      while (start <= parameters.size()) {
+        size_t end = parameters.find('|', start);
+
+        if (end == std::string::npos) {
+          end = parameters.size();
+        }
+
+        paths.push_back(parameters.substr(start, end - start));
+
+        start = end + 1;
+      }
+
+      return Mesh::Model(paths);
+    }
+
+    return nullptr;
+  }
+
+  /**
+   * Mesh::releaseGeometry()
+   * -----------------------
+   *
+   * Frees the mesh's CPU vertices and face elements, unless
+   * its geometry retention policy is to keep them.
+   */
+  void Mesh::releaseGeometry() {
+    if (retention == GeometryRetention::KEEP || isGeometryReleased) {
+      return;
+    }
+
+    totalVertices = vertices.size();
+    totalFaceElements = faceElements.size();
+    isGeometryReleased = true;
+
+    // clear() would retain the vector capacity
+    std::vector<Vertex>().swap(vertices);
+    std::vector<u32>().swap(faceElements);
+  }
+
+  /**
+   * Mesh::restoreGeometry()
+   * -----------------------
+   *
+   * Ensures that the mesh's CPU vertices and face elements
+   * are available, reloading them if they were released
+   * and the mesh's retention policy allows it. Returns
+   * false if the geometry is unavailable.
    */
-  void Mesh::transformGeometry(std::function<void(const Vertex&, Vertex&)> handler) {
+  bool Mesh::restoreGeometry() {
+    if (!isGeometryReleased) {
+      return true;
+    }
+
+    if (retention != GeometryRetention::RELOAD_ON_DEMAND) {
+      return false;
+    }
+
+    auto* source = Gm_CreateMeshFromGeometryKey(geometryKey);
+
+    if (source == nullptr) {
+      return false;
+    }
+
+    vertices = std::move(source->vertices);
+    faceElements = std::move(source->faceElements);
+    isGeometryReleased = false;
+
+    delete source;
+
+    return vertices.size() == totalVertices && faceElements.size() == totalFaceElements;
+  }
+
+  /**
+   * Mesh::transformGeometryRanges()
+   * -------------------------------
+   *
+   * Runs a kernel over batches of vertex index ranges in
+   * parallel, where each kernel invocation writes to the
+   * transformedVertices within its [start, end) range.
+   */
+  void Mesh::transformGeometryRanges(const std::function<void(u32 start, u32 end)>& kernel) {
     // Copy vertices the first time
     if (transformedVertices.size() == 0) {
-      for (auto& vertex : vertices) {
-        transformedVertices.push_back(vertex);
-      }
+      assert(restoreGeometry(), "Mesh '" + name + "' geometry was discarded, and cannot be transformed");
+
+      transformedVertices = vertices;
     }
 
-    for (u32 i = 0; i < vertices.size(); i++) {
-      handler(vertices[i], transformedVertices[i]);
+    Gm_ParallelFor(vertices.size(), TRANSFORM_BATCH_SIZE, kernel);
+
+    geometryVersion++;
+  }
+
+  /**
+   * Gm_ComputeBoundingRadius
+   * ------------------------
+   *
+   * Determines the radius of a sphere centered at the
+   * model space origin which encloses all mesh vertices.
+   */
+  void Gm_ComputeBoundingRadius(Mesh* mesh) {
+    float radiusSquared = 0.f;
+
+    for (auto& vertex : mesh->vertices) {
+      float distanceSquared = Vec3f::dot(vertex.position, vertex.position);
+
+      if (distanceSquared > radiusSquared) {
+        radiusSquared = distanceSquared;
+      }
     }
+
+    mesh->boundingRadius = sqrtf(radiusSquared);
   }
 
   /**
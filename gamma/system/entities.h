@@ -23,6 +23,35 @@ namespace Gamma {
     SPOT_SHADOWCASTER
   };
 
+  /**
+   * LightHandle
+   * -----------
+   *
+   * A unique identifier for a Light within a LightPool, with
+   * generation checks to detect handles to lights which have
+   * since been removed.
+   *
+   * @size 4 bytes
+   */
+  struct LightHandle {
+    u16 id = 0xffff;
+    u16 generation = 0;
+  };
+
+  /**
+   * MeshHandle
+   * ----------
+   *
+   * A reference to a Mesh by its index in a scene's Mesh
+   * array, allowing hot code to resolve meshes and their
+   * objects without name lookups.
+   *
+   * @size 2 bytes
+   */
+  struct MeshHandle {
+    u16 index = 0xffff;
+  };
+
   /**
    * Light
    * -----
@@ -31,6 +60,7 @@ namespace Gamma {
    * and color/reflective properties of illuminated surfaces.
    */
   struct Light {
+    LightHandle _handle;
     Vec3f position;
     float radius = 100.f;
     Vec3f color = Vec3f(1.f);
@@ -209,6 +239,30 @@ namespace Gamma {
     float factor = 1.f;
   };
 
+  /**
+   * GeometryRetention
+   * -----------------
+   *
+   * Policies for a mesh's CPU copy of its vertices and face
+   * elements once they have been uploaded to the renderer.
+   */
+  enum GeometryRetention {
+    /**
+     * Keeps the CPU copy for the lifetime of the mesh.
+     */
+    KEEP,
+    /**
+     * Frees the CPU copy after upload. Mesh geometry can no
+     * longer be transformed or used for occlusion.
+     */
+    DISCARD_AFTER_UPLOAD,
+    /**
+     * Frees the CPU copy after upload, and regenerates or
+     * reloads it from the mesh's geometry key when needed.
+     */
+    RELOAD_ON_DEMAND
+  };
+
   /**
    * MeshAttributes
    * --------------
@@ -280,6 +334,21 @@ namespace Gamma {
      * Controls whether geometry is textured across the xz plane.
      */
     bool useXzPlaneTexturing = false;
+    /**
+     * Controls whether the mesh's visible instances are drawn
+     * into the CPU occlusion buffer, hiding instances of other
+     * meshes behind them. Occluders should be low-poly, or
+     * define a low-poly lowest level of detail.
+     */
+    bool isOccluder = false;
+    /**
+     * Controls whether the mesh's CPU geometry is kept after
+     * being uploaded to the renderer. Must be set before the
+     * mesh is added to a scene.
+     *
+     * @see GeometryRetention
+     */
+    GeometryRetention retention = GeometryRetention::KEEP;
   };
 
   /**
@@ -313,6 +382,15 @@ namespace Gamma {
      * Static mesh vertices in model space.
      */
     std::vector<Vertex> vertices;
+    /**
+     * Identifies the generator and parameters, or the model
+     * files, which produced the mesh vertices/face elements.
+     * Meshes with the same geometry key share their GPU
+     * geometry. Code which modifies the vertices/face elements
+     * of a mesh created by one of the Mesh constructors should
+     * clear its geometry key.
+     */
+    std::string geometryKey = "";
     /**
      * Dynamic mesh vertices, based on the static vertices.
      * Remains empty unless transformGeometry() is used.
@@ -320,17 +398,64 @@ namespace Gamma {
      * @todo remove?
      */
     std::vector<Vertex> transformedVertices;
+    /**
+     * Incremented whenever transformedVertices change, so
+     * renderers only upload them once per change. Code which
+     * writes to transformedVertices directly should increment
+     * this as well.
+     */
+    u32 geometryVersion = 0;
     /**
      * Vertex indices for each triangle face of the mesh,
      * defined in groups of three.
      */
     std::vector<u32> faceElements;
+    /**
+     * The total number of mesh vertices and face elements,
+     * which remain available after the CPU geometry has
+     * been released.
+     */
+    u32 totalVertices = 0;
+    u32 totalFaceElements = 0;
+    /**
+     * Set once the mesh's vertices and face elements have
+     * been freed, per its geometry retention policy.
+     */
+    bool isGeometryReleased = false;
     /**
      * The LOD groups for the Mesh, if applicable.
      *
      * @see MeshLod
      */
     std::vector<MeshLod> lods;
+    /**
+     * Controls whether frustum culling and LOD grouping produce
+     * a list of visible object indices instead of reordering
+     * the mesh's objects. Object instance data then stays in
+     * place, and is only buffered when objects change.
+     *
+     * Meshes using visibility indices are drawn from their
+     * index list, so Gm_UseFrustumCulling() and/or
+     * Gm_UseLodByDistance() should be called for them
+     * each frame.
+     */
+    bool useVisibilityIndices = false;
+    /**
+     * Indices of visible objects, grouped by LOD when LODs
+     * are used, in which case each LOD's instance offset/count
+     * refer to a range within this list.
+     */
+    std::vector<u32> visibleIndices;
+    /**
+     * The scene frame (+1) on which visibleIndices were last
+     * built, or 0 if never.
+     */
+    u32 visibleIndicesFrame = 0;
+    /**
+     * The radius of a sphere enclosing the mesh vertices
+     * in model space, used for culling mesh instances.
+     */
+    float boundingRadius = 0.f;
     /**
      * A collection of objects representing unique instances
      * of the mesh.
@@ -349,12 +474,51 @@ namespace Gamma {
     static Mesh* Particles(bool useGpuParticles = false);
     static Mesh* Plane(u32 size, bool useLoopingTexture = false);
     static Mesh* Disc(u32 slices);
-    // @todo Cylinder(u32 divisions)
+    static Mesh* Cylinder(u32 divisions);
+
+    /**
+     * Transforms each static vertex into its counterpart in
+     * transformedVertices. Vertices are transformed in parallel,
+     * so the handler must be safe to call from multiple threads.
+     */
+    template<typename Handler>
+    void transformGeometry(Handler handler) {
+      transformGeometryRanges([&](u32 start, u32 end) {
+        for (u32 i = start; i < end; i++) {
+          handler(vertices[i], transformedVertices[i]);
+        }
+      });
+    }
 
-    // @todo remove?
-    void transformGeometry(std::function<void(const Vertex&, Vertex&)> handler);
+    void releaseGeometry();
+    bool restoreGeometry();
+    void transformGeometryRanges(const std::function<void(u32 start, u32 end)>& kernel);
   };
 
+  /**
+   * Gm_ComputeBoundingRadius
+   * ------------------------
+   */
+  void Gm_ComputeBoundingRadius(Mesh* mesh);
+
+  /**
+   * Gm_ComputeNormals
+   * -----------------
+   *
+   * Recomputes vertex normals by averaging the normals
+   * of each face a vertex belongs to.
+   */
+  void Gm_ComputeNormals(Mesh* mesh);
+
+  /**
+   * Gm_ComputeTangents
+   * ------------------
+   *
+   * Recomputes vertex tangents from face edges and
+   * texture coordinates.
+   */
+  void Gm_ComputeTangents(Mesh* mesh);
+
   /**
    * Gm_FreeMesh
    * -----------
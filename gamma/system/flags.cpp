@@ -12,7 +12,8 @@ namespace Gamma {
     GammaFlags::RENDER_INDIRECT_SKY_LIGHT |
     GammaFlags::RENDER_AMBIENT_OCCLUSION |
     GammaFlags::RENDER_GLOBAL_ILLUMINATION |
-    GammaFlags::RENDER_HORIZON_ATMOSPHERE;
+    GammaFlags::RENDER_HORIZON_ATMOSPHERE |
+    GammaFlags::RENDER_CLUSTERED_LIGHTING;
 
   static u32 previousFlags = internalFlags;
 
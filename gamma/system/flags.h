@@ -16,6 +16,7 @@ namespace Gamma {
     ENABLE_DEV_LIGHT_DISCS = 1 << 4,
     ENABLE_DEV_BUFFERS = 1 << 5,
     ENABLE_DEV_TOOLS = 1 << 6,
+    ENABLE_DEV_PROFILER = 1 << 7,
 
     RENDER_REFLECTIONS = 1 << 12,
     RENDER_REFRACTIVE_GEOMETRY = 1 << 13,
@@ -25,7 +26,8 @@ namespace Gamma {
     RENDER_GLOBAL_ILLUMINATION = 1 << 17,
     RENDER_INDIRECT_SKY_LIGHT = 1 << 18,
     RENDER_DEPTH_OF_FIELD = 1 << 19,
-    RENDER_HORIZON_ATMOSPHERE = 1 << 20
+    RENDER_HORIZON_ATMOSPHERE = 1 << 20,
+    RENDER_CLUSTERED_LIGHTING = 1 << 21
   };
 
   void Gm_DisableFlags(GammaFlags flags);
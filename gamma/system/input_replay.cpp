@@ -0,0 +1,210 @@
+#include <cstdio>
+#include <cstring>
+
+#include "system/console.h"
+#include "system/input_replay.h"
+
+namespace Gamma {
+  constexpr static char REPLAY_MAGIC[4] = { 'G', 'M', 'I', 'R' };
+  constexpr static u32 REPLAY_VERSION = 1;
+
+  /**
+   * ReplayField
+   * -----------
+   *
+   * Bits marking which input state fields changed from the
+   * previous frame. Only changed fields are written, which
+   * keeps frames with steady input down to a few bytes.
+   */
+  enum ReplayField {
+    HELD_KEYS = 1 << 0,
+    PRESSED_KEYS = 1 << 1,
+    RELEASED_KEYS = 1 << 2,
+    LAST_KEY_DOWN = 1 << 3,
+    MOUSE_DELTA = 1 << 4,
+    MOUSE_FLAGS = 1 << 5
+  };
+
+  enum ReplayMouseFlag {
+    CLICK = 1 << 0,
+    RIGHT_CLICK = 1 << 1,
+    RELEASE = 1 << 2,
+    WHEEL = 1 << 3,
+    HELD = 1 << 4,
+    WHEEL_DOWN = 1 << 5
+  };
+
+  template<typename T>
+  static void Gm_WriteReplayValue(FILE* file, const T& value) {
+    fwrite(&value, sizeof(T), 1, file);
+  }
+
+  template<typename T>
+  static bool Gm_ReadReplayValue(FILE* file, T& value) {
+    return fread(&value, sizeof(T), 1, file) == 1;
+  }
+
+  static u8 Gm_PackMouseFlags(const InputState& state) {
+    u8 flags = 0;
+
+    if (state.didClickMouse) flags |= ReplayMouseFlag::CLICK;
+    if (state.didRightClickMouse) flags |= ReplayMouseFlag::RIGHT_CLICK;
+    if (state.didReleaseMouse) flags |= ReplayMouseFlag::RELEASE;
+    if (state.didMoveMouseWheel) flags |= ReplayMouseFlag::WHEEL;
+    if (state.isMouseHeld) flags |= ReplayMouseFlag::HELD;
+    if (state.mouseWheelDirection == MouseWheelEvent::DOWN) flags |= ReplayMouseFlag::WHEEL_DOWN;
+
+    return flags;
+  }
+
+  static void Gm_UnpackMouseFlags(u8 flags, InputState& state) {
+    state.didClickMouse = flags & ReplayMouseFlag::CLICK;
+    state.didRightClickMouse = flags & ReplayMouseFlag::RIGHT_CLICK;
+    state.didReleaseMouse = flags & ReplayMouseFlag::RELEASE;
+    state.didMoveMouseWheel = flags & ReplayMouseFlag::WHEEL;
+    state.isMouseHeld = flags & ReplayMouseFlag::HELD;
+
+    state.mouseWheelDirection = flags & ReplayMouseFlag::WHEEL_DOWN
+      ? MouseWheelEvent::DOWN
+      : MouseWheelEvent::UP;
+  }
+
+  /**
+   * Gm_LoadInputReplay
+   * ------------------
+   *
+   * Loads a replay written by Gm_SaveInputReplay(). Replays
+   * are stored in native byte order, and are only meant to
+   * be replayed on the platform they were recorded on.
+   */
+  bool Gm_LoadInputReplay(const std::string& path, InputReplay& replay) {
+    FILE* file = fopen(path.c_str(), "rb");
+
+    if (file == nullptr) {
+      Console::warn("[Gamma] Failed to open input replay:", path);
+
+      return false;
+    }
+
+    char magic[4];
+    u32 version = 0;
+    u32 totalFrames = 0;
+
+    bool isValidHeader = (
+      fread(magic, sizeof(magic), 1, file) == 1 &&
+      memcmp(magic, REPLAY_MAGIC, sizeof(magic)) == 0 &&
+      Gm_ReadReplayValue(file, version) &&
+      version == REPLAY_VERSION &&
+      Gm_ReadReplayValue(file, replay.seed) &&
+      Gm_ReadReplayValue(file, totalFrames)
+    );
+
+    if (!isValidHeader) {
+      Console::warn("[Gamma] Invalid input replay:", path);
+
+      fclose(file);
+
+      return false;
+    }
+
+    InputReplayFrame frame;
+
+    replay.frames.clear();
+    replay.frames.reserve(totalFrames);
+
+    for (u32 i = 0; i < totalFrames; i++) {
+      u8 fields = 0;
+      u8 mouseFlags = 0;
+      bool isValidFrame = Gm_ReadReplayValue(file, frame.dt) && Gm_ReadReplayValue(file, fields);
+
+      auto& input = frame.input;
+
+      if (isValidFrame && fields & ReplayField::HELD_KEYS) isValidFrame = Gm_ReadReplayValue(file, input.heldKeys);
+      if (isValidFrame && fields & ReplayField::PRESSED_KEYS) isValidFrame = Gm_ReadReplayValue(file, input.pressedKeys);
+      if (isValidFrame && fields & ReplayField::RELEASED_KEYS) isValidFrame = Gm_ReadReplayValue(file, input.releasedKeys);
+      if (isValidFrame && fields & ReplayField::LAST_KEY_DOWN) isValidFrame = Gm_ReadReplayValue(file, input.lastKeyDown);
+
+      if (isValidFrame && fields & ReplayField::MOUSE_DELTA) {
+        isValidFrame = Gm_ReadReplayValue(file, input.mouseDelta.x) && Gm_ReadReplayValue(file, input.mouseDelta.y);
+      }
+
+      if (isValidFrame && fields & ReplayField::MOUSE_FLAGS) {
+        isValidFrame = Gm_ReadReplayValue(file, mouseFlags);
+
+        Gm_UnpackMouseFlags(mouseFlags, input);
+      }
+
+      if (!isValidFrame) {
+        Console::warn("[Gamma] Input replay ended early:", path, "(" + std::to_string(i) + "/" + std::to_string(totalFrames) + " frames)");
+
+        break;
+      }
+
+      replay.frames.push_back(frame);
+    }
+
+    fclose(file);
+
+    return true;
+  }
+
+  /**
+   * Gm_SaveInputReplay
+   * ------------------
+   */
+  bool Gm_SaveInputReplay(const std::string& path, const InputReplay& replay) {
+    FILE* file = fopen(path.c_str(), "wb");
+
+    if (file == nullptr) {
+      Console::warn("[Gamma] Failed to write input replay:", path);
+
+      return false;
+    }
+
+    // Fields are diffed against the default state for the
+    // first frame, matching how they're read back
+    InputState previous;
+    u8 previousMouseFlags = Gm_PackMouseFlags(previous);
+
+    fwrite(REPLAY_MAGIC, sizeof(REPLAY_MAGIC), 1, file);
+
+    Gm_WriteReplayValue(file, REPLAY_VERSION);
+    Gm_WriteReplayValue(file, replay.seed);
+    Gm_WriteReplayValue(file, (u32)replay.frames.size());
+
+    for (auto& frame : replay.frames) {
+      auto& input = frame.input;
+      u8 mouseFlags = Gm_PackMouseFlags(input);
+      u8 fields = 0;
+
+      if (input.heldKeys != previous.heldKeys) fields |= ReplayField::HELD_KEYS;
+      if (input.pressedKeys != previous.pressedKeys) fields |= ReplayField::PRESSED_KEYS;
+      if (input.releasedKeys != previous.releasedKeys) fields |= ReplayField::RELEASED_KEYS;
+      if (input.lastKeyDown != previous.lastKeyDown) fields |= ReplayField::LAST_KEY_DOWN;
+      if (input.mouseDelta.x != previous.mouseDelta.x || input.mouseDelta.y != previous.mouseDelta.y) fields |= ReplayField::MOUSE_DELTA;
+      if (mouseFlags != previousMouseFlags) fields |= ReplayField::MOUSE_FLAGS;
+
+      Gm_WriteReplayValue(file, frame.dt);
+      Gm_WriteReplayValue(file, fields);
+
+      if (fields & ReplayField::HELD_KEYS) Gm_WriteReplayValue(file, input.heldKeys);
+      if (fields & ReplayField::PRESSED_KEYS) Gm_WriteReplayValue(file, input.pressedKeys);
+      if (fields & ReplayField::RELEASED_KEYS) Gm_WriteReplayValue(file, input.releasedKeys);
+      if (fields & ReplayField::LAST_KEY_DOWN) Gm_WriteReplayValue(file, input.lastKeyDown);
+
+      if (fields & ReplayField::MOUSE_DELTA) {
+        Gm_WriteReplayValue(file, input.mouseDelta.x);
+        Gm_WriteReplayValue(file, input.mouseDelta.y);
+      }
+
+      if (fields & ReplayField::MOUSE_FLAGS) Gm_WriteReplayValue(file, mouseFlags);
+
+      previous = input;
+      previousMouseFlags = mouseFlags;
+    }
+
+    fclose(file);
+
+    return true;
+  }
+}
\ No newline at end of file
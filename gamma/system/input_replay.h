@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "system/InputSystem.h"
+#include "system/type_aliases.h"
+
+namespace Gamma {
+  /**
+   * InputReplayFrame
+   * ----------------
+   *
+   * The delta time and input state for a recorded frame.
+   */
+  struct InputReplayFrame {
+    float dt = 0.f;
+    InputState input;
+  };
+
+  enum class InputReplayMode {
+    NONE,
+    RECORDING,
+    REPLAYING
+  };
+
+  /**
+   * InputReplay
+   * -----------
+   *
+   * Per-frame input and timing, either being recorded from
+   * a live run or replayed in place of it. Replays use the
+   * same random seed as their recording, so given the same
+   * build, a replayed run simulates identically.
+   */
+  struct InputReplay {
+    InputReplayMode mode = InputReplayMode::NONE;
+    std::string path;
+    u32 seed = 0;
+    std::vector<InputReplayFrame> frames;
+    u32 frameIndex = 0;
+    /**
+     * The delta time returned for the frame in progress,
+     * recorded along with the frame's input.
+     */
+    float dt = 0.f;
+  };
+
+  bool Gm_LoadInputReplay(const std::string& path, InputReplay& replay);
+  bool Gm_SaveInputReplay(const std::string& path, const InputReplay& replay);
+}
\ No newline at end of file
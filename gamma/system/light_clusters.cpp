@@ -0,0 +1,213 @@
+#include <cmath>
+
+#include "math/constants.h"
+#include "math/matrix.h"
+#include "math/utilities.h"
+#include "performance/parallel.h"
+#include "system/entities.h"
+#include "system/light_clusters.h"
+
+namespace Gamma {
+  /**
+   * Gm_GetTileRange
+   * ---------------
+   *
+   * Determines the range of screen tiles along one axis
+   * covered by a view-space sphere, given the sphere's
+   * clamped view depth range and the projection scale
+   * for that axis. Returns false if the sphere falls
+   * outside of the screen along the axis.
+   */
+  static bool Gm_GetTileRange(float center, float radius, float zMin, float zMax, float projectionScale, u32 totalTiles, u16& start, u16& end) {
+    float high = center + radius;
+    float low = center - radius;
+    // Take the most extreme projected extents of the
+    // sphere's bounding box, which are nearest to the
+    // camera on the far side of the axis, and furthest
+    // on the near side
+    float ndcHigh = projectionScale * high / (high >= 0.f ? zMin : zMax);
+    float ndcLow = projectionScale * low / (low >= 0.f ? zMax : zMin);
+
+    if (ndcHigh < -1.f || ndcLow > 1.f) {
+      return false;
+    }
+
+    float tileLow = (Gm_Maxf(ndcLow, -1.f) * 0.5f + 0.5f) * (float)totalTiles;
+    float tileHigh = (Gm_Minf(ndcHigh, 1.f) * 0.5f + 0.5f) * (float)totalTiles;
+
+    start = (u16)Gm_Minf(floorf(tileLow), float(totalTiles - 1));
+    end = (u16)Gm_Minf(floorf(tileHigh), float(totalTiles - 1));
+
+    return true;
+  }
+
+  /**
+   * Gm_GetLightClusterSlice
+   * -----------------------
+   */
+  static u32 Gm_GetLightClusterSlice(const LightClusters& lightClusters, float viewDepth, float sliceScale) {
+    if (viewDepth <= lightClusters.near) {
+      return 0;
+    }
+
+    float slice = floorf(logf(viewDepth / lightClusters.near) * sliceScale);
+
+    return (u32)Gm_Minf(slice, float(lightClusters.depth - 1));
+  }
+
+  /**
+   * Gm_GetLightClusterBounds
+   * ------------------------
+   */
+  static LightClusterBounds Gm_GetLightClusterBounds(const LightClusters& lightClusters, const Light& light, const Matrix4f& matView, float scaleX, float scaleY, float sliceScale) {
+    LightClusterBounds bounds;
+
+    if (light.power == 0.f || light.radius <= 0.f) {
+      return bounds;
+    }
+
+    // @todo use a tighter bounding volume for spot lights
+    Vec3f localPosition = matView.transformVec3f(light.position);
+    float radius = light.radius;
+
+    if (localPosition.z + radius < lightClusters.near) {
+      // Behind the camera
+      return bounds;
+    }
+
+    float zMin = Gm_Maxf(localPosition.z - radius, lightClusters.near);
+    float zMax = Gm_Maxf(localPosition.z + radius, lightClusters.near);
+
+    if (
+      !Gm_GetTileRange(localPosition.x, radius, zMin, zMax, scaleX, lightClusters.width, bounds.x0, bounds.x1) ||
+      !Gm_GetTileRange(localPosition.y, radius, zMin, zMax, scaleY, lightClusters.height, bounds.y0, bounds.y1)
+    ) {
+      return bounds;
+    }
+
+    bounds.z0 = Gm_GetLightClusterSlice(lightClusters, zMin, sliceScale);
+    bounds.z1 = Gm_GetLightClusterSlice(lightClusters, zMax, sliceScale);
+    bounds.isVisible = true;
+
+    return bounds;
+  }
+
+  /**
+   * Gm_BuildLightClusters
+   * ---------------------
+   *
+   * Bins a list of point/spot lights into the clusters they
+   * overlap, writing each cluster's light index range. Lights
+   * with a power of 0 are skipped. Light bounds are computed
+   * in parallel across lights, and clusters are filled in
+   * parallel across depth slices, so no two threads write
+   * to the same cluster. Within a cluster, light indices
+   * are in ascending order.
+   */
+  void Gm_BuildLightClusters(LightClusters& lightClusters, const std::vector<Light*>& lights, const Camera& camera, const Area<u32>& resolution) {
+    auto& clusters = lightClusters.clusters;
+    auto& lightIndices = lightClusters.lightIndices;
+    auto& lightBounds = lightClusters.lightBounds;
+    auto& sliceLights = lightClusters.sliceLights;
+    u32 totalLights = lights.size();
+    u32 clustersPerSlice = lightClusters.width * lightClusters.height;
+
+    clusters.assign(clustersPerSlice * lightClusters.depth, LightCluster());
+    lightBounds.resize(totalLights);
+    sliceLights.resize(lightClusters.depth);
+
+    float aspectRatio = (float)resolution.width / (float)resolution.height;
+    float scaleY = 1.f / tanf(camera.fov / 2.f * DEGREES_TO_RADIANS);
+    float scaleX = scaleY / aspectRatio;
+    float sliceScale = (float)lightClusters.depth / logf(lightClusters.far / lightClusters.near);
+    Matrix4f matView = Gm_GetCameraViewMatrix(camera);
+
+    Gm_ParallelFor(totalLights, 256, [&](u32 start, u32 end) {
+      for (u32 i = start; i < end; i++) {
+        lightBounds[i] = Gm_GetLightClusterBounds(lightClusters, *lights[i], matView, scaleX, scaleY, sliceScale);
+      }
+    });
+
+    // Group visible lights by depth slice, so each slice
+    // only visits the lights which overlap it
+    for (auto& slice : sliceLights) {
+      slice.clear();
+    }
+
+    for (u32 i = 0; i < totalLights; i++) {
+      auto& bounds = lightBounds[i];
+
+      if (bounds.isVisible) {
+        for (u32 z = bounds.z0; z <= bounds.z1; z++) {
+          sliceLights[z].push_back(i);
+        }
+      }
+    }
+
+    // Count the lights in each cluster
+    Gm_ParallelFor(lightClusters.depth, 1, [&](u32 start, u32 end) {
+      for (u32 z = start; z < end; z++) {
+        for (u32 lightIndex : sliceLights[z]) {
+          auto& bounds = lightBounds[lightIndex];
+
+          for (u32 y = bounds.y0; y <= bounds.y1; y++) {
+            for (u32 x = bounds.x0; x <= bounds.x1; x++) {
+              clusters[Gm_GetLightClusterIndex(lightClusters, x, y, z)].count++;
+            }
+          }
+        }
+      }
+    });
+
+    // Assign each cluster its range in the index list
+    u32 totalIndices = 0;
+
+    for (auto& cluster : clusters) {
+      cluster.offset = totalIndices;
+      totalIndices += cluster.count;
+      cluster.count = 0;
+    }
+
+    lightIndices.resize(totalIndices);
+
+    // Write light indices
+    Gm_ParallelFor(lightClusters.depth, 1, [&](u32 start, u32 end) {
+      for (u32 z = start; z < end; z++) {
+        for (u32 lightIndex : sliceLights[z]) {
+          auto& bounds = lightBounds[lightIndex];
+
+          for (u32 y = bounds.y0; y <= bounds.y1; y++) {
+            for (u32 x = bounds.x0; x <= bounds.x1; x++) {
+              auto& cluster = clusters[Gm_GetLightClusterIndex(lightClusters, x, y, z)];
+
+              lightIndices[cluster.offset + cluster.count++] = lightIndex;
+            }
+          }
+        }
+      }
+    });
+  }
+
+  /**
+   * Gm_GetLightClusterIndex
+   * -----------------------
+   */
+  u32 Gm_GetLightClusterIndex(const LightClusters& lightClusters, u32 x, u32 y, u32 z) {
+    return (z * lightClusters.height + y) * lightClusters.width + x;
+  }
+
+  /**
+   * Gm_GetLightClusterSlice
+   * -----------------------
+   *
+   * Returns the depth slice containing a given view-space
+   * depth. Slices are distributed logarithmically between
+   * the near and far planes; depths beyond the far plane
+   * fall into the last slice.
+   */
+  u32 Gm_GetLightClusterSlice(const LightClusters& lightClusters, float viewDepth) {
+    float sliceScale = (float)lightClusters.depth / logf(lightClusters.far / lightClusters.near);
+
+    return Gm_GetLightClusterSlice(lightClusters, viewDepth, sliceScale);
+  }
+}
\ No newline at end of file
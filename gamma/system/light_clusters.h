@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+
+#include "math/plane.h"
+#include "math/vector.h"
+#include "system/camera.h"
+#include "system/type_aliases.h"
+
+namespace Gamma {
+  struct Light;
+
+  /**
+   * LightCluster
+   * ------------
+   *
+   * A range within a LightClusters index list, containing
+   * the indices of all lights affecting a single cluster.
+   */
+  struct LightCluster {
+    u32 offset = 0;
+    u32 count = 0;
+  };
+
+  /**
+   * LightClusterBounds
+   * ------------------
+   *
+   * The inclusive range of clusters a light overlaps
+   * along each axis of the cluster grid.
+   */
+  struct LightClusterBounds {
+    u16 x0 = 0;
+    u16 x1 = 0;
+    u16 y0 = 0;
+    u16 y1 = 0;
+    u16 z0 = 0;
+    u16 z1 = 0;
+    bool isVisible = false;
+  };
+
+  /**
+   * LightClusters
+   * -------------
+   *
+   * A 3D grid of clusters over the camera view frustum, with
+   * screen-space tiles along x/y and exponentially-distributed
+   * depth slices along z. Each cluster lists the lights which
+   * may affect the surfaces it contains.
+   *
+   * Clusters are stored in x, y, z order, and light indices
+   * refer to the light list the clusters were built from.
+   */
+  struct LightClusters {
+    u32 width = 16;
+    u32 height = 9;
+    u32 depth = 24;
+    float near = 1.f;
+    float far = 5000.f;
+    std::vector<LightCluster> clusters;
+    std::vector<u32> lightIndices;
+    std::vector<LightClusterBounds> lightBounds;
+    std::vector<std::vector<u32>> sliceLights;
+  };
+
+  void Gm_BuildLightClusters(LightClusters& lightClusters, const std::vector<Light*>& lights, const Camera& camera, const Area<u32>& resolution);
+  u32 Gm_GetLightClusterIndex(const LightClusters& lightClusters, u32 x, u32 y, u32 z);
+  u32 Gm_GetLightClusterSlice(const LightClusters& lightClusters, float viewDepth);
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#include "system/entities.h"
+#include "system/light_discs.h"
+
+namespace Gamma {
+  bool Gm_ConfigureLightDisc(Disc& disc, const Light& light, const Matrix4f& matProjection, const Matrix4f& matView, float resolutionAspectRatio) {
+    if (light.power == 0.f) {
+      return false;
+    }
+
+    Vec3f localLightPosition = matView.transformVec3f(light.position);
+
+    disc.position = light.position;
+    disc.radius = light.radius;
+    disc.color = light.color;
+    disc.power = light.power;
+    disc.direction = light.direction;
+    disc.fov = light.fov;
+
+    if (localLightPosition.z > 0.1f) {
+      // Light source in front of the camera
+      Vec3f screenLightPosition = matProjection.transformVec3f(localLightPosition) / localLightPosition.z;
+
+      disc.offset = Vec2f(screenLightPosition.x, screenLightPosition.y);
+      // @todo use 1 + log(light.power) or similar for scaling term
+      disc.scale.x = 1.5f * light.radius / localLightPosition.z;
+      disc.scale.y = 1.5f * light.radius / localLightPosition.z * resolutionAspectRatio;
+    } else {
+      // Light source behind the camera; scale to cover
+      // screen when within range, and scale to 0 when
+      // out of range
+      float scale = localLightPosition.magnitude() < light.radius ? 2.f : 0.f;
+
+      disc.offset = Vec2f(0.f);
+      disc.scale = Vec2f(scale);
+    }
+
+    return (
+      disc.scale.x > 0.f &&
+      disc.offset.x + disc.scale.x > -1.f &&
+      disc.offset.x - disc.scale.x < 1.f &&
+      disc.offset.y + disc.scale.y > -1.f &&
+      disc.offset.y - disc.scale.y < 1.f
+    );
+  }
+}
\ No newline at end of file
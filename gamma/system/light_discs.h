@@ -0,0 +1,37 @@
+#pragma once
+
+#include "math/matrix.h"
+#include "math/vector.h"
+#include "system/type_aliases.h"
+
+namespace Gamma {
+  struct Light;
+
+  /**
+   * Disc
+   * ----
+   *
+   * A light disc instance, containing the disc's screen
+   * transform and the light properties read by the light
+   * shaders.
+   */
+  struct Disc {
+    Vec2f offset;
+    Vec2f scale;
+    Vec3f position;
+    float radius;
+    Vec3f color;
+    float power;
+    Vec3f direction;
+    float fov;
+  };
+
+  /**
+   * Gm_ConfigureLightDisc
+   * ---------------------
+   *
+   * Configures a light disc instance, returning false
+   * if the disc would not cover any part of the screen.
+   */
+  bool Gm_ConfigureLightDisc(Disc& disc, const Light& light, const Matrix4f& matProjection, const Matrix4f& matView, float resolutionAspectRatio);
+}
\ No newline at end of file
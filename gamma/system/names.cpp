@@ -0,0 +1,43 @@
+#include <unordered_map>
+
+#include "system/assert.h"
+#include "system/names.h"
+
+namespace Gamma {
+  static std::unordered_map<u32, std::string> internedNames;
+
+  /**
+   * Gm_GetInternedName
+   * ------------------
+   *
+   * Returns the original name for an interned NameId,
+   * e.g. for diagnostic messages.
+   */
+  const std::string& Gm_GetInternedName(NameId nameId) {
+    const static std::string UNKNOWN_NAME = "<unknown>";
+    auto entry = internedNames.find(nameId.hash);
+
+    return entry == internedNames.end() ? UNKNOWN_NAME : entry->second;
+  }
+
+  /**
+   * Gm_InternName
+   * -------------
+   *
+   * Registers a name in the intern table and returns its
+   * NameId. Asserts if the name's hash collides with that
+   * of a different name.
+   */
+  NameId Gm_InternName(const std::string& name) {
+    NameId nameId(name);
+    auto entry = internedNames.find(nameId.hash);
+
+    if (entry == internedNames.end()) {
+      internedNames.emplace(nameId.hash, name);
+    } else {
+      assert(entry->second == name, "Name '" + name + "' collides with '" + entry->second + "'");
+    }
+
+    return nameId;
+  }
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <type_traits>
+
+#include "system/type_aliases.h"
+
+/**
+ * name_id
+ * -------
+ *
+ * Hashes a string literal into a NameId at compile time.
+ */
+#define name_id(literal) Gamma::NameId(std::integral_constant<u32, Gamma::Gm_HashName(literal)>::value)
+
+namespace Gamma {
+  /**
+   * Gm_HashName
+   * -----------
+   *
+   * Computes the 32-bit FNV-1a hash of a string.
+   */
+  constexpr u32 Gm_HashName(const char* name) {
+    u32 hash = 2166136261u;
+
+    while (*name != '\0') {
+      hash ^= (u8)*name++;
+      hash *= 16777619u;
+    }
+
+    return hash;
+  }
+
+  /**
+   * NameId
+   * ------
+   *
+   * A hashed mesh/object/light name, used to look up named
+   * scene entities without string comparisons. Converts
+   * implicitly from strings, so APIs accepting a NameId
+   * also accept names directly.
+   */
+  struct NameId {
+    u32 hash = 0;
+
+    constexpr NameId() {};
+    constexpr explicit NameId(u32 hash): hash(hash) {};
+    constexpr NameId(const char* name): hash(Gm_HashName(name)) {};
+    NameId(const std::string& name): hash(Gm_HashName(name.c_str())) {};
+
+    constexpr bool operator==(const NameId& nameId) const {
+      return hash == nameId.hash;
+    }
+  };
+
+  const std::string& Gm_GetInternedName(NameId nameId);
+  NameId Gm_InternName(const std::string& name);
+}
\ No newline at end of file
@@ -0,0 +1,345 @@
+#include <algorithm>
+#include <cmath>
+
+#include "math/constants.h"
+#include "math/simd.h"
+#include "performance/benchmark.h"
+#include "performance/parallel.h"
+#include "system/assert.h"
+#include "system/entities.h"
+#include "system/occlusion.h"
+
+namespace Gamma {
+  constexpr static u32 OCCLUSION_TILE_SIZE = 8;
+  constexpr static u32 OCCLUDER_BATCH_SIZE = 16;
+
+  /**
+   * Gm_ProjectX/Gm_ProjectY
+   * -----------------------
+   *
+   * Project view space x/y coordinates to occlusion
+   * buffer space, with y pointing down.
+   */
+  static inline float Gm_ProjectX(const OcclusionBuffer& buffer, float x, float z) {
+    return (x / z * buffer.scaleX * 0.5f + 0.5f) * (float)buffer.width;
+  }
+
+  static inline float Gm_ProjectY(const OcclusionBuffer& buffer, float y, float z) {
+    return (0.5f - y / z * buffer.scaleY * 0.5f) * (float)buffer.height;
+  }
+
+  /**
+   * Gm_CollectOccluderTriangles
+   * ---------------------------
+   *
+   * Transforms the triangles of an occluder object into
+   * occlusion buffer space. Triangles crossing the near
+   * plane are dropped rather than clipped, which can only
+   * make the occluder less effective, and never hides
+   * anything it shouldn't.
+   */
+  static void Gm_CollectOccluderTriangles(const OcclusionBuffer& buffer, const Mesh& mesh, const Object& object, std::vector<OcclusionTriangle>& triangles, std::vector<Vec3f>& viewVertices) {
+    Matrix4f matModelView = buffer.matView * Matrix4f::transformation(object.position, object.scale, object.rotation);
+    u32 elementOffset = 0;
+    u32 elementCount = (u32)mesh.faceElements.size();
+
+    if (mesh.lods.size() > 0) {
+      // Occlude with the lowest level of detail
+      auto& lod = mesh.lods.back();
+
+      elementOffset = lod.elementOffset;
+      elementCount = lod.elementCount;
+    }
+
+    viewVertices.resize(mesh.vertices.size());
+
+    for (u32 i = 0; i < mesh.vertices.size(); i++) {
+      viewVertices[i] = matModelView.transformVec3f(mesh.vertices[i].position);
+    }
+
+    for (u32 i = elementOffset; i + 2 < elementOffset + elementCount; i += 3) {
+      auto& v0 = viewVertices[mesh.faceElements[i]];
+      auto& v1 = viewVertices[mesh.faceElements[i + 1]];
+      auto& v2 = viewVertices[mesh.faceElements[i + 2]];
+
+      if (v0.z < buffer.near || v1.z < buffer.near || v2.z < buffer.near) {
+        continue;
+      }
+
+      OcclusionTriangle triangle;
+      const Vec3f* vertices[3] = { &v0, &v1, &v2 };
+
+      for (u32 j = 0; j < 3; j++) {
+        triangle.x[j] = Gm_ProjectX(buffer, vertices[j]->x, vertices[j]->z);
+        triangle.y[j] = Gm_ProjectY(buffer, vertices[j]->y, vertices[j]->z);
+        triangle.w[j] = 1.f / vertices[j]->z;
+      }
+
+      float minX = std::min(triangle.x[0], std::min(triangle.x[1], triangle.x[2]));
+      float maxX = std::max(triangle.x[0], std::max(triangle.x[1], triangle.x[2]));
+      float minY = std::min(triangle.y[0], std::min(triangle.y[1], triangle.y[2]));
+      float maxY = std::max(triangle.y[0], std::max(triangle.y[1], triangle.y[2]));
+
+      if (maxX < 0.f || minX > (float)buffer.width || maxY < 0.f || minY > (float)buffer.height) {
+        continue;
+      }
+
+      triangle.minY = std::max((s32)floorf(minY), 0);
+      triangle.maxY = std::min((s32)ceilf(maxY), (s32)buffer.height - 1);
+
+      triangles.push_back(triangle);
+    }
+  }
+
+  /**
+   * Gm_RasterizeTriangle
+   * --------------------
+   *
+   * Rasterizes a triangle into rows [startY, endY) of the
+   * occlusion buffer, keeping the nearest inverse depth at
+   * each covered pixel center. Four pixels are written at a
+   * time where SSE is available.
+   */
+  static void Gm_RasterizeTriangle(OcclusionBuffer& buffer, const OcclusionTriangle& triangle, s32 startY, s32 endY) {
+    float x0 = triangle.x[0], y0 = triangle.y[0];
+    float x1 = triangle.x[1], y1 = triangle.y[1];
+    float x2 = triangle.x[2], y2 = triangle.y[2];
+    float area = (x1 - x0) * (y2 - y0) - (x2 - x0) * (y1 - y0);
+
+    if (area == 0.f) {
+      return;
+    }
+
+    // Orient edges so covered pixels have positive edge values
+    float sign = area > 0.f ? 1.f : -1.f;
+
+    // Edge functions e(x, y) = a * x + b * y + c
+    float a0 = (y1 - y2) * sign, b0 = (x2 - x1) * sign, c0 = (x1 * y2 - x2 * y1) * sign;
+    float a1 = (y2 - y0) * sign, b1 = (x0 - x2) * sign, c1 = (x2 * y0 - x0 * y2) * sign;
+    float a2 = (y0 - y1) * sign, b2 = (x1 - x0) * sign, c2 = (x0 * y1 - x1 * y0) * sign;
+
+    // Inverse depth plane w(x, y) = wa * x + wb * y + wc
+    float inverseArea = 1.f / (area * sign);
+    float wa = (a0 * triangle.w[0] + a1 * triangle.w[1] + a2 * triangle.w[2]) * inverseArea;
+    float wb = (b0 * triangle.w[0] + b1 * triangle.w[1] + b2 * triangle.w[2]) * inverseArea;
+    float wc = (c0 * triangle.w[0] + c1 * triangle.w[1] + c2 * triangle.w[2]) * inverseArea;
+
+    float minX = std::min(x0, std::min(x1, x2));
+    float maxX = std::max(x0, std::max(x1, x2));
+    // Start on a multiple of 4 pixels, so SSE rows stay aligned
+    s32 startX = std::max((s32)floorf(minX), 0) & ~3;
+    s32 endX = std::min((s32)ceilf(maxX), (s32)buffer.width - 1);
+
+    startY = std::max(startY, triangle.minY);
+    endY = std::min(endY, triangle.maxY + 1);
+
+    for (s32 y = startY; y < endY; y++) {
+      float* row = &buffer.depth[y * buffer.width];
+      float py = (float)y + 0.5f;
+      s32 x = startX;
+
+      #if GAMMA_USE_SSE == 1
+        __m128 offsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+        __m128 zero = _mm_setzero_ps();
+
+        for (; x <= endX; x += 4) {
+          __m128 px = _mm_add_ps(_mm_set1_ps((float)x), offsets);
+          __m128 e0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a0), px), _mm_set1_ps(b0 * py + c0));
+          __m128 e1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a1), px), _mm_set1_ps(b1 * py + c1));
+          __m128 e2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a2), px), _mm_set1_ps(b2 * py + c2));
+          __m128 mask = _mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_and_ps(_mm_cmpge_ps(e1, zero), _mm_cmpge_ps(e2, zero)));
+
+          if (_mm_movemask_ps(mask) == 0) {
+            continue;
+          }
+
+          __m128 w = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(wa), px), _mm_set1_ps(wb * py + wc));
+          __m128 current = _mm_loadu_ps(&row[x]);
+          __m128 nearest = _mm_max_ps(current, w);
+
+          _mm_storeu_ps(&row[x], _mm_or_ps(_mm_and_ps(mask, nearest), _mm_andnot_ps(mask, current)));
+        }
+      #endif
+
+      for (; x <= endX; x++) {
+        float px = (float)x + 0.5f;
+
+        if (a0 * px + b0 * py + c0 >= 0.f && a1 * px + b1 * py + c1 >= 0.f && a2 * px + b2 * py + c2 >= 0.f) {
+          row[x] = std::max(row[x], wa * px + wb * py + wc);
+        }
+      }
+    }
+  }
+
+  /**
+   * Gm_IsSphereOccluded
+   * -------------------
+   *
+   * Determines whether a world space sphere is hidden behind
+   * the rasterized occluders. Spheres crossing the near plane
+   * or the edges of the view are treated as visible wherever
+   * they leave the buffer.
+   */
+  bool Gm_IsSphereOccluded(const OcclusionBuffer& buffer, const Vec3f& center, float radius) {
+    if (buffer.stats.totalOccluderTriangles == 0) {
+      return false;
+    }
+
+    Vec3f view = buffer.matView.transformVec3f(center);
+    float nearZ = view.z - radius;
+    float farZ = view.z + radius;
+
+    if (nearZ < buffer.near) {
+      return false;
+    }
+
+    // Conservative screen bounds, dividing each extent by
+    // whichever sphere depth maximizes it
+    float left = view.x - radius;
+    float right = view.x + radius;
+    float top = view.y + radius;
+    float bottom = view.y - radius;
+    float minX = Gm_ProjectX(buffer, left, left < 0.f ? nearZ : farZ);
+    float maxX = Gm_ProjectX(buffer, right, right > 0.f ? nearZ : farZ);
+    float minY = Gm_ProjectY(buffer, top, top > 0.f ? nearZ : farZ);
+    float maxY = Gm_ProjectY(buffer, bottom, bottom < 0.f ? nearZ : farZ);
+
+    if (minX < 0.f || minY < 0.f || maxX >= (float)buffer.width || maxY >= (float)buffer.height) {
+      return false;
+    }
+
+    s32 x0 = (s32)minX;
+    s32 x1 = (s32)maxX;
+    s32 y0 = (s32)minY;
+    s32 y1 = (s32)maxY;
+    float w = 1.f / nearZ;
+    u32 tilesPerRow = buffer.width / OCCLUSION_TILE_SIZE;
+
+    for (s32 tileY = y0 / OCCLUSION_TILE_SIZE; tileY <= y1 / (s32)OCCLUSION_TILE_SIZE; tileY++) {
+      for (s32 tileX = x0 / OCCLUSION_TILE_SIZE; tileX <= x1 / (s32)OCCLUSION_TILE_SIZE; tileX++) {
+        if (buffer.tileDepth[tileY * tilesPerRow + tileX] > w) {
+          // Every occluder pixel in the tile is in front
+          continue;
+        }
+
+        s32 startX = std::max(x0, tileX * (s32)OCCLUSION_TILE_SIZE);
+        s32 endX = std::min(x1, tileX * (s32)OCCLUSION_TILE_SIZE + (s32)OCCLUSION_TILE_SIZE - 1);
+        s32 startY = std::max(y0, tileY * (s32)OCCLUSION_TILE_SIZE);
+        s32 endY = std::min(y1, tileY * (s32)OCCLUSION_TILE_SIZE + (s32)OCCLUSION_TILE_SIZE - 1);
+
+        for (s32 y = startY; y <= endY; y++) {
+          for (s32 x = startX; x <= endX; x++) {
+            if (buffer.depth[y * buffer.width + x] <= w) {
+              return false;
+            }
+          }
+        }
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * Gm_RasterizeOccluders
+   * ---------------------
+   *
+   * Rasterizes the visible objects of all occluder meshes into
+   * the occlusion buffer. Occluder triangles are transformed in
+   * parallel batches of objects, then rasterized in parallel
+   * across rows of tiles, so no two threads write to the
+   * same pixels.
+   */
+  void Gm_RasterizeOccluders(OcclusionBuffer& buffer, const std::vector<Mesh*>& meshes, const Camera& camera, float aspectRatio) {
+    u64 startTime = Gm_GetMicroseconds();
+
+    // Tiles must cover the buffer exactly, since both rasterization
+    // and occlusion tests index tiles by pixel coordinates
+    assert(buffer.width % OCCLUSION_TILE_SIZE == 0 && buffer.height % OCCLUSION_TILE_SIZE == 0, "Occlusion Buffer dimensions must be multiples of " + std::to_string(OCCLUSION_TILE_SIZE));
+
+    u32 tilesPerRow = buffer.width / OCCLUSION_TILE_SIZE;
+    u32 tileRows = buffer.height / OCCLUSION_TILE_SIZE;
+
+    buffer.depth.assign(buffer.width * buffer.height, 0.f);
+    buffer.tileDepth.assign(tilesPerRow * tileRows, 0.f);
+    buffer.matView = Gm_GetCameraViewMatrix(camera);
+    buffer.scaleY = 1.f / tanf(camera.fov / 2.f * DEGREES_TO_RADIANS);
+    buffer.scaleX = buffer.scaleY / aspectRatio;
+    buffer.stats = OcclusionStats();
+
+    // Reuse batch slots from the previous frame, keeping their
+    // triangle capacity, and drop any slots beyond this frame's
+    u32 totalBatchesUsed = 0;
+
+    for (auto* mesh : meshes) {
+      if (!mesh->isOccluder || mesh->disabled || !mesh->restoreGeometry() || mesh->faceElements.size() == 0) {
+        continue;
+      }
+
+      u32 totalObjects = mesh->useVisibilityIndices ? (u32)mesh->visibleIndices.size() : mesh->objects.totalVisible();
+      u32 totalBatches = (totalObjects + OCCLUDER_BATCH_SIZE - 1) / OCCLUDER_BATCH_SIZE;
+      u32 firstBatch = totalBatchesUsed;
+
+      totalBatchesUsed += totalBatches;
+
+      if (buffer.batchTriangles.size() < totalBatchesUsed) {
+        buffer.batchTriangles.resize(totalBatchesUsed);
+      }
+
+      for (u32 batch = firstBatch; batch < totalBatchesUsed; batch++) {
+        buffer.batchTriangles[batch].clear();
+      }
+
+      Gm_ParallelFor(totalBatches, 1, [&](u32 start, u32 end) {
+        std::vector<Vec3f> viewVertices;
+
+        for (u32 batch = start; batch < end; batch++) {
+          auto& triangles = buffer.batchTriangles[firstBatch + batch];
+          u32 lastObject = std::min((batch + 1) * OCCLUDER_BATCH_SIZE, totalObjects);
+
+          for (u32 i = batch * OCCLUDER_BATCH_SIZE; i < lastObject; i++) {
+            u32 index = mesh->useVisibilityIndices ? mesh->visibleIndices[i] : i;
+
+            Gm_CollectOccluderTriangles(buffer, *mesh, mesh->objects[index], triangles, viewVertices);
+          }
+        }
+      });
+    }
+
+    buffer.batchTriangles.resize(totalBatchesUsed);
+
+    for (auto& triangles : buffer.batchTriangles) {
+      buffer.stats.totalOccluderTriangles += (u32)triangles.size();
+    }
+
+    Gm_ParallelFor(tileRows, 1, [&](u32 start, u32 end) {
+      for (u32 tileY = start; tileY < end; tileY++) {
+        s32 startY = tileY * OCCLUSION_TILE_SIZE;
+        s32 endY = startY + OCCLUSION_TILE_SIZE;
+
+        for (auto& triangles : buffer.batchTriangles) {
+          for (auto& triangle : triangles) {
+            if (triangle.maxY >= startY && triangle.minY < endY) {
+              Gm_RasterizeTriangle(buffer, triangle, startY, endY);
+            }
+          }
+        }
+
+        // Store the farthest occluder depth in each tile
+        for (u32 tileX = 0; tileX < tilesPerRow; tileX++) {
+          float farthest = buffer.depth[startY * buffer.width + tileX * OCCLUSION_TILE_SIZE];
+
+          for (s32 y = startY; y < endY; y++) {
+            for (u32 x = tileX * OCCLUSION_TILE_SIZE; x < (tileX + 1) * OCCLUSION_TILE_SIZE; x++) {
+              farthest = std::min(farthest, buffer.depth[y * buffer.width + x]);
+            }
+          }
+
+          buffer.tileDepth[tileY * tilesPerRow + tileX] = farthest;
+        }
+      }
+    });
+
+    buffer.stats.rasterMicroseconds = Gm_GetMicroseconds() - startTime;
+  }
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+
+#include "math/matrix.h"
+#include "math/vector.h"
+#include "system/camera.h"
+#include "system/type_aliases.h"
+
+namespace Gamma {
+  struct Mesh;
+
+  /**
+   * OcclusionTriangle
+   * -----------------
+   *
+   * An occluder triangle in occlusion buffer space, with
+   * inverse view depths at each vertex.
+   */
+  struct OcclusionTriangle {
+    float x[3];
+    float y[3];
+    float w[3];
+    s32 minY;
+    s32 maxY;
+  };
+
+  /**
+   * OcclusionStats
+   * --------------
+   *
+   * Reports the cost and effectiveness of occlusion culling
+   * for the last rasterized frame.
+   */
+  struct OcclusionStats {
+    u32 totalOccluderTriangles = 0;
+    u32 totalTestedObjects = 0;
+    u32 totalOccludedObjects = 0;
+    u64 rasterMicroseconds = 0;
+    u64 testMicroseconds = 0;
+  };
+
+  /**
+   * OcclusionBuffer
+   * ---------------
+   *
+   * A low-resolution CPU depth buffer of occluder geometry,
+   * storing the inverse view depth of the nearest occluder
+   * at each pixel (0 where there is none). Pixels are grouped
+   * into 8x8 tiles, each storing the inverse depth of its
+   * farthest pixel, so objects can be rejected against whole
+   * tiles before testing individual pixels. width and height
+   * must be multiples of the tile size.
+   *
+   * Uses the camera projection of the frame it was last
+   * rasterized for; see Gm_RasterizeOccluders().
+   */
+  struct OcclusionBuffer {
+    u32 width = 256;
+    u32 height = 128;
+    float near = 0.1f;
+    std::vector<float> depth;
+    std::vector<float> tileDepth;
+    std::vector<std::vector<OcclusionTriangle>> batchTriangles;
+    Matrix4f matView;
+    float scaleX = 1.f;
+    float scaleY = 1.f;
+    u32 frame = 0;
+    OcclusionStats stats;
+  };
+
+  bool Gm_IsSphereOccluded(const OcclusionBuffer& buffer, const Vec3f& center, float radius);
+  void Gm_RasterizeOccluders(OcclusionBuffer& buffer, const std::vector<Mesh*>& meshes, const Camera& camera, float aspectRatio);
+}
\ No newline at end of file
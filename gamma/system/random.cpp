@@ -6,4 +6,8 @@ static std::uniform_real_distribution<float> randomRange(0.f, 1.f);
 
 float Gm_Randomf(float low, float high) {
   return low + randomRange(randomEngine) * (high - low);
+}
+
+void Gm_SeedRandom(u32 seed) {
+  randomEngine.seed(seed);
 }
\ No newline at end of file
@@ -3,4 +3,7 @@
 #include <math.h>
 #include <random>
 
-float Gm_Randomf(float low, float high);
\ No newline at end of file
+#include "system/type_aliases.h"
+
+float Gm_Randomf(float low, float high);
+void Gm_SeedRandom(u32 seed);
\ No newline at end of file
@@ -1,6 +1,8 @@
+#include <algorithm>
 #include <filesystem>
 
 #include "math/utilities.h"
+#include "performance/benchmark.h"
 #include "system/scene.h"
 #include "system/assert.h"
 #include "system/console.h"
@@ -15,7 +17,18 @@ const GmSceneStats Gm_GetSceneStats(GmContext* context) {
   GmSceneStats stats;
 
   for (auto* mesh : context->scene.meshes) {
-    if (mesh->disabled || mesh->objects.totalVisible() == 0) {
+    // Count CPU geometry memory for all meshes, in bytes
+    u32 geometryMemory = mesh->vertices.capacity() * sizeof(Vertex) + mesh->faceElements.capacity() * sizeof(u32);
+
+    stats.geometryMemory += geometryMemory + mesh->transformedVertices.capacity() * sizeof(Vertex);
+
+    if (mesh->isGeometryReleased) {
+      stats.releasedGeometryMemory += mesh->totalVertices * sizeof(Vertex) + mesh->totalFaceElements * sizeof(u32);
+    }
+
+    u32 totalVisible = mesh->useVisibilityIndices ? mesh->visibleIndices.size() : mesh->objects.totalVisible();
+
+    if (mesh->disabled || totalVisible == 0) {
       continue;
     }
 
@@ -25,15 +38,15 @@ const GmSceneStats Gm_GetSceneStats(GmContext* context) {
         stats.tris += (lod.elementCount / 3) * lod.instanceCount;
       }
     } else {
-      stats.verts += mesh->vertices.size() * mesh->objects.totalVisible();
-      stats.tris += (mesh->faceElements.size() / 3) * mesh->objects.totalVisible();
+      stats.verts += mesh->totalVertices * totalVisible;
+      stats.tris += (mesh->totalFaceElements / 3) * totalVisible;
     }
 
     stats.totalMeshes++;
   }
 
-  for (auto* light : context->scene.lights) {
-    if (light->power > 0.f) {
+  for (auto& light : context->scene.lights) {
+    if (light.power > 0.f) {
       stats.totalLights++;
     }
   }
@@ -41,27 +54,77 @@ const GmSceneStats Gm_GetSceneStats(GmContext* context) {
   return stats;
 }
 
+/**
+ * Gm_GetMemorySnapshot
+ * --------------------
+ *
+ * Measures the memory used by each mesh's object pool and
+ * geometry, alongside all tracked memory categories. Without
+ * [includeMeshes], only the category totals are filled in,
+ * which avoids allocating anything, e.g. for per-frame use.
+ */
+MemorySnapshot Gm_GetMemorySnapshot(GmContext* context, bool includeMeshes) {
+  MemorySnapshot snapshot;
+
+  for (u32 i = 0; i < TOTAL_MEMORY_CATEGORIES; i++) {
+    snapshot.bytes[i] = Gm_GetTrackedMemory((MemoryCategory)i);
+  }
+
+  for (auto* mesh : context->scene.meshes) {
+    u64 objectPoolBytes = mesh->objects.getMemoryUsage();
+
+    u64 geometryBytes = (
+      mesh->vertices.capacity() * sizeof(Vertex) +
+      mesh->transformedVertices.capacity() * sizeof(Vertex) +
+      mesh->faceElements.capacity() * sizeof(u32) +
+      mesh->lods.capacity() * sizeof(MeshLod)
+    );
+
+    snapshot.bytes[(u32)MemoryCategory::OBJECT_POOLS] += objectPoolBytes;
+    snapshot.bytes[(u32)MemoryCategory::MESH_GEOMETRY] += geometryBytes;
+
+    if (includeMeshes) {
+      snapshot.meshes.push_back({ mesh->name, objectPoolBytes, geometryBytes });
+    }
+  }
+
+  return snapshot;
+}
+
 void Gm_AddMesh(GmContext* context, const std::string& meshName, u16 maxInstances, Gamma::Mesh* mesh) {
   auto& scene = context->scene;
   auto& meshes = scene.meshes;
   auto& meshMap = scene.meshMap;
 
-  assert(meshMap.find(meshName) == meshMap.end(), "Mesh '" + meshName + "' already exists!");
+  NameId meshId = Gm_InternName(meshName);
+
+  assert(!meshMap.has(meshId.hash), "Mesh '" + meshName + "' already exists!");
 
   mesh->index = (u16)meshes.size();
   mesh->name = meshName;
   mesh->objects.reserve(maxInstances);
 
-  meshMap.emplace(meshName, mesh);
+  mesh->totalVertices = mesh->vertices.size();
+  mesh->totalFaceElements = mesh->faceElements.size();
+
+  Gm_ComputeBoundingRadius(mesh);
+
+  meshMap[meshId.hash] = mesh;
   meshes.push_back(mesh);
 
   if (mesh->type == MeshType::PARTICLES && mesh->particles.useGpuParticles) {
     for (u16 i = 0; i < maxInstances; i++) {
-      Gm_CreateObjectFrom(context, meshName);
+      Gm_CreateObjectFrom(context, mesh->index);
     }
   }
 
   context->renderer->createMesh(mesh);
+
+  // Occluders are rasterized from their CPU geometry every
+  // frame, so it must be kept regardless of retention policy
+  if (!mesh->isOccluder) {
+    mesh->releaseGeometry();
+  }
 }
 
 void Gm_AddProbe(GmContext* context, const std::string& probeName, const Gamma::Vec3f& position) {
@@ -69,11 +132,7 @@ void Gm_AddProbe(GmContext* context, const std::string& probeName, const Gamma::
 }
 
 Gamma::Light& Gm_CreateLight(GmContext* context, Gamma::LightType type) {
-  auto& lights = context->scene.lights;
-
-  lights.push_back(new Light());
-
-  auto& light = *lights.back();
+  auto& light = context->scene.lights.createLight();
 
   light.type = type;
 
@@ -151,32 +210,14 @@ void Gm_UseSceneFile(GmContext* context, const std::string& filename) {
   Gm_FreeYamlObject(&scene);
 }
 
-// @todo refactor with Gm_CreateObjectFrom(GmContext*, u16)
-Gamma::Object& Gm_CreateObjectFrom(GmContext* context, const std::string& meshName) {
-  auto& meshMap = context->scene.meshMap;
-
-  assert(meshMap.find(meshName) != meshMap.end(), "Mesh '" + meshName + "' not found");
-
-  auto& mesh = *meshMap.at(meshName);
-  auto& object = mesh.objects.createObject();
-
-  object._record.meshIndex = mesh.index;
-  object.position = Vec3f(0.0f);
-  object.rotation = Quaternion(1.f, 0, 0, 0);
-  object.scale = Vec3f(1.0f);
-
-  if (mesh.lods.size() > 0) {
-    // Increment the base LoD instance count by default,
-    // which we use for vert/tri counts in scene stats.
-    // Gm_UseLodByDistance can control the per-LoD
-    // instance counts during the update loop.
-    mesh.lods[0].instanceCount++;
-  }
+Gamma::Object& Gm_CreateObjectFrom(GmContext* context, Gamma::NameId meshName) {
+  return Gm_CreateObjectFrom(context, Gm_GetMesh(context, meshName)->index);
+}
 
-  return object;
+Gamma::Object& Gm_CreateObjectFrom(GmContext* context, Gamma::MeshHandle handle) {
+  return Gm_CreateObjectFrom(context, handle.index);
 }
 
-// @todo refactor with Gm_CreateObjectFrom(GmContext*, const std::string&)
 Gamma::Object& Gm_CreateObjectFrom(GmContext* context, u16 meshIndex) {
   assert(context->scene.meshes.size() > meshIndex, "Mesh '" + std::to_string(meshIndex) + "' not found");
 
@@ -213,46 +254,74 @@ void Gm_Commit(GmContext* context, const Gamma::Object& object) {
   objects.setColorById(record.id, object.color);
 }
 
-Gamma::ObjectPool& Gm_GetObjects(GmContext* context, const std::string& meshName) {
+Gamma::Mesh* Gm_GetMesh(GmContext* context, Gamma::NameId meshName) {
+  auto* entry = context->scene.meshMap.find(meshName.hash);
+
   // @todo #if GAMMA_DEVELOPER_MODE
-  Gamma::assert(context->scene.meshMap.find(meshName) != context->scene.meshMap.end(), "Mesh '" + meshName + "' not found");
+  Gamma::assert(entry != nullptr, "Mesh '" + Gm_GetInternedName(meshName) + "' not found");
+
+  return *entry;
+}
+
+Gamma::Mesh* Gm_GetMesh(GmContext* context, Gamma::MeshHandle handle) {
+  auto& meshes = context->scene.meshes;
+
+  Gamma::assert(handle.index < meshes.size(), "Mesh '" + std::to_string(handle.index) + "' not found");
+
+  return meshes[handle.index];
+}
+
+Gamma::MeshHandle Gm_GetMeshHandle(GmContext* context, Gamma::NameId meshName) {
+  return { Gm_GetMesh(context, meshName)->index };
+}
+
+Gamma::ObjectPool& Gm_GetObjects(GmContext* context, Gamma::NameId meshName) {
+  return Gm_GetMesh(context, meshName)->objects;
+}
+
+Gamma::ObjectPool& Gm_GetObjects(GmContext* context, Gamma::MeshHandle handle) {
+  return Gm_GetMesh(context, handle)->objects;
+}
+
+bool Gm_IsMeshObject(GmContext* context, const Gamma::Object& object, Gamma::NameId meshName) {
+  return object._record.meshIndex == Gm_GetMesh(context, meshName)->index;
+}
 
-  return context->scene.meshMap[meshName]->objects;
+bool Gm_IsMeshObject(GmContext* context, const Gamma::Object& object, Gamma::MeshHandle handle) {
+  return object._record.meshIndex == handle.index;
 }
 
 void Gm_SaveObject(GmContext* context, const std::string& objectName, const Gamma::Object& object) {
-  context->scene.objectStore[objectName] = object._record;
+  context->scene.objectStore[Gm_InternName(objectName).hash] = object._record;
 }
 
 void Gm_SaveLight(GmContext* context, const std::string& lightName, Gamma::Light* light) {
-  context->scene.lightStore[lightName] = light;
+  context->scene.lightStore[Gm_InternName(lightName).hash] = light->_handle;
 }
 
-bool Gm_HasObject(GmContext* context, const std::string& objectName) {
+bool Gm_HasObject(GmContext* context, Gamma::NameId objectName) {
   return Gm_FindObject(context, objectName) != nullptr;
 }
 
-Gamma::Object* Gm_FindObject(GmContext* context, const std::string& objectName) {
+Gamma::Object* Gm_FindObject(GmContext* context, Gamma::NameId objectName) {
   auto& scene = context->scene;
-  auto& store = scene.objectStore;
+  auto* record = scene.objectStore.find(objectName.hash);
 
-  if (store.find(objectName) == store.end()) {
+  if (record == nullptr) {
     return nullptr;
   }
 
-  auto& record = store.at(objectName);
-  auto& mesh = scene.meshes[record.meshIndex];
+  auto& mesh = scene.meshes[record->meshIndex];
 
-  return mesh->objects.getByRecord(record);
+  return mesh->objects.getByRecord(*record);
 }
 
-Gamma::Object& Gm_GetObject(GmContext* context, const std::string& objectName) {
-  auto& scene = context->scene;
-  // @todo assert that the object exists
-  auto& record = scene.objectStore.at(objectName);
-  auto& mesh = scene.meshes[record.meshIndex];
+Gamma::Object& Gm_GetObject(GmContext* context, Gamma::NameId objectName) {
+  auto* object = Gm_FindObject(context, objectName);
+
+  Gamma::assert(object != nullptr, "Object '" + Gm_GetInternedName(objectName) + "' not found");
 
-  return *mesh->objects.getByRecord(record);
+  return *object;
 }
 
 Gamma::Object* Gm_GetObjectByRecord(GmContext* context, const Gamma::ObjectRecord& record) {
@@ -265,11 +334,24 @@ Gamma::Object* Gm_GetObjectByRecord(GmContext* context, const Gamma::ObjectRecor
   return meshes[record.meshIndex]->objects.getByRecord(record);
 }
 
-Gamma::Light& Gm_GetLight(GmContext* context, const std::string& lightName) {
-  auto& lightStore = context->scene.lightStore;
-  // @todo assert that the light exists
+Gamma::Light& Gm_GetLight(GmContext* context, Gamma::NameId lightName) {
+  auto* light = context->scene.lights.getByHandle(Gm_GetLightHandle(context, lightName));
 
-  return *lightStore.at(lightName);
+  Gamma::assert(light != nullptr, "Light '" + Gm_GetInternedName(lightName) + "' was removed");
+
+  return *light;
+}
+
+Gamma::LightHandle Gm_GetLightHandle(GmContext* context, Gamma::NameId lightName) {
+  auto* handle = context->scene.lightStore.find(lightName.hash);
+
+  Gamma::assert(handle != nullptr, "Light '" + Gm_GetInternedName(lightName) + "' not found");
+
+  return *handle;
+}
+
+Gamma::Light* Gm_GetLightByHandle(GmContext* context, const Gamma::LightHandle& handle) {
+  return context->scene.lights.getByHandle(handle);
 }
 
 void Gm_RemoveObject(GmContext* context, const Gamma::Object& object) {
@@ -285,9 +367,21 @@ void Gm_RemoveLight(GmContext* context, Gamma::Light* light) {
 
   renderer->destroyShadowMap(light);
 
-  Gm_VectorRemove(scene.lights, light);
+  // Remove any saved names for the light. Erasing shifts
+  // entries within the map, so collect the keys first.
+  std::vector<u32> lightKeys;
+
+  for (auto& entry : scene.lightStore) {
+    if (entry.value.id == light->_handle.id) {
+      lightKeys.push_back(entry.key);
+    }
+  }
+
+  for (u32 key : lightKeys) {
+    scene.lightStore.erase(key);
+  }
 
-  delete light;
+  scene.lights.remove(light);
 }
 
 // @incomplete (needs testing)
@@ -302,16 +396,14 @@ void Gm_ResetScene(GmContext* context) {
     delete mesh;
   }
 
-  for (auto* light : scene.lights) {
+  for (auto& light : scene.lights) {
     if (
-      light->type == LightType::DIRECTIONAL_SHADOWCASTER ||
-      light->type == LightType::POINT_SHADOWCASTER ||
-      light->type == LightType::SPOT_SHADOWCASTER
+      light.type == LightType::DIRECTIONAL_SHADOWCASTER ||
+      light.type == LightType::POINT_SHADOWCASTER ||
+      light.type == LightType::SPOT_SHADOWCASTER
     ) {
-      context->renderer->destroyShadowMap(light);
+      context->renderer->destroyShadowMap(&light);
     }
-
-    delete light;
   }
 
   for (auto& [ name, position ] : scene.probeMap) {
@@ -319,7 +411,7 @@ void Gm_ResetScene(GmContext* context) {
   }
 
   scene.meshes.clear();
-  scene.lights.clear();
+  scene.lights.free();
   scene.meshMap.clear();
   scene.probeMap.clear();
   scene.objectStore.clear();
@@ -404,20 +496,76 @@ void Gm_HandleFreeCameraMode(GmContext* context, float speed, float dt) {
   }
 }
 
-void Gm_UseFrustumCulling(GmContext* context, const std::initializer_list<std::string>& meshNames) {
-  auto& meshMap = context->scene.meshMap;
+void Gm_UseFrustumCulling(GmContext* context, const std::initializer_list<Gamma::NameId>& meshNames) {
+  auto& scene = context->scene;
+
+  for (auto meshName : meshNames) {
+    auto& mesh = *Gm_GetMesh(context, meshName);
+
+    if (mesh.useVisibilityIndices) {
+      mesh.objects.collectVisibleIndices(scene.camera, mesh.visibleIndices);
+
+      mesh.visibleIndicesFrame = scene.frame + 1;
+    } else {
+      mesh.objects.partitionByVisibility(scene.camera);
+    }
+  }
+}
+
+// Resets a mesh's visible object indices to all active objects,
+// unless they have already been built for the current frame
+static void Gm_PrepareVisibleIndices(GmContext* context, Mesh& mesh) {
+  auto& scene = context->scene;
+  auto& indices = mesh.visibleIndices;
+
+  if (mesh.visibleIndicesFrame != scene.frame + 1) {
+    indices.resize(mesh.objects.totalActive());
+
+    for (u32 i = 0; i < indices.size(); i++) {
+      indices[i] = i;
+    }
+
+    mesh.visibleIndicesFrame = scene.frame + 1;
+  }
+}
+
+// Groups a mesh's visible object indices by LoD, starting from
+// the frustum-culled indices for the current frame if available,
+// or from all active objects otherwise
+static void Gm_UseLodByDistanceWithIndices(GmContext* context, Mesh& mesh, float distance) {
+  auto& scene = context->scene;
+  auto& indices = mesh.visibleIndices;
+
+  Gm_PrepareVisibleIndices(context, mesh);
 
-  for (auto& meshName : meshNames) {
-    meshMap[meshName]->objects.partitionByVisibility(context->scene.camera);
+  u32 instanceOffset = 0;
+
+  for (u32 lodIndex = 0; lodIndex < mesh.lods.size(); lodIndex++) {
+    auto& lod = mesh.lods[lodIndex];
+
+    lod.instanceOffset = instanceOffset;
+
+    if (lodIndex < mesh.lods.size() - 1) {
+      instanceOffset = mesh.objects.partitionIndicesByDistance(indices.data(), instanceOffset, (u32)indices.size(), distance * float(lodIndex + 1), scene.camera.position);
+    } else {
+      instanceOffset = (u32)indices.size();
+    }
+
+    lod.instanceCount = instanceOffset - lod.instanceOffset;
   }
 }
 
-void Gm_UseLodByDistance(GmContext* context, float distance, const std::initializer_list<std::string>& meshNames) {
-  auto& meshMap = context->scene.meshMap;
+void Gm_UseLodByDistance(GmContext* context, float distance, const std::initializer_list<Gamma::NameId>& meshNames) {
   auto& camera = context->scene.camera;
 
-  for (auto& meshName : meshNames) {
-    auto& mesh = *meshMap[meshName];
+  for (auto meshName : meshNames) {
+    auto& mesh = *Gm_GetMesh(context, meshName);
+
+    if (mesh.useVisibilityIndices) {
+      Gm_UseLodByDistanceWithIndices(context, mesh, distance);
+
+      continue;
+    }
 
     u32 instanceOffset = 0;
 
@@ -441,6 +589,92 @@ void Gm_UseLodByDistance(GmContext* context, float distance, const std::initiali
   }
 }
 
+// Hides the visible instances of each mesh which are behind the
+// visible instances of occluder meshes (see MeshAttributes::isOccluder).
+// Occluders are rasterized on the first call each frame, so culling
+// should happen in the order: frustum culling, occluder meshes'
+// LoDs (if any), occlusion culling, then LoDs for other meshes.
+// Occluder meshes are never tested against themselves.
+void Gm_UseOcclusionCulling(GmContext* context, const std::initializer_list<Gamma::NameId>& meshNames) {
+  auto& scene = context->scene;
+  auto& occlusion = scene.occlusion;
+
+  if (occlusion.frame != scene.frame + 1) {
+    auto& size = context->window.size;
+    float aspectRatio = size.height > 0 ? (float)size.width / (float)size.height : 1.f;
+
+    Gm_RasterizeOccluders(occlusion, scene.meshes, scene.camera, aspectRatio);
+
+    occlusion.frame = scene.frame + 1;
+  }
+
+  u64 startTime = Gm_GetMicroseconds();
+
+  for (auto meshName : meshNames) {
+    auto& mesh = *Gm_GetMesh(context, meshName);
+
+    if (mesh.isOccluder || mesh.disabled) {
+      continue;
+    }
+
+    if (mesh.useVisibilityIndices) {
+      Gm_PrepareVisibleIndices(context, mesh);
+
+      occlusion.stats.totalTestedObjects += (u32)mesh.visibleIndices.size();
+      occlusion.stats.totalOccludedObjects += mesh.objects.cullOccludedIndices(occlusion, mesh, mesh.visibleIndices);
+    } else {
+      occlusion.stats.totalTestedObjects += mesh.objects.totalVisible();
+      occlusion.stats.totalOccludedObjects += mesh.objects.partitionByOcclusion(occlusion, mesh);
+    }
+  }
+
+  occlusion.stats.testMicroseconds += Gm_GetMicroseconds() - startTime;
+}
+
+// Sorts the visible instances of each mesh by view depth, within
+// each LoD group if the mesh has LoDs. Translucent particles and
+// refractive meshes are sorted back-to-front for blending; other
+// meshes are sorted front-to-back to reduce overdraw. Should be
+// called after Gm_UseFrustumCulling()/Gm_UseLodByDistance().
+void Gm_UseDepthSorting(GmContext* context, const std::initializer_list<Gamma::NameId>& meshNames) {
+  auto& camera = context->scene.camera;
+
+  for (auto meshName : meshNames) {
+    auto& mesh = *Gm_GetMesh(context, meshName);
+
+    if (mesh.type == MeshType::PARTICLES && mesh.particles.useGpuParticles) {
+      // GPU particle positions are unknown on the CPU
+      continue;
+    }
+
+    auto order = mesh.type == MeshType::PARTICLES || mesh.type == MeshType::REFRACTIVE
+      ? DepthSortOrder::BACK_TO_FRONT
+      : DepthSortOrder::FRONT_TO_BACK;
+
+    if (mesh.useVisibilityIndices) {
+      Gm_PrepareVisibleIndices(context, mesh);
+    }
+
+    u32 totalVisible = mesh.useVisibilityIndices ? (u32)mesh.visibleIndices.size() : mesh.objects.totalVisible();
+    u32 totalGroups = mesh.lods.size() > 0 ? (u32)mesh.lods.size() : 1;
+
+    for (u32 i = 0; i < totalGroups; i++) {
+      u32 start = mesh.lods.size() > 0 ? mesh.lods[i].instanceOffset : 0;
+      u32 end = mesh.lods.size() > 0 ? start + mesh.lods[i].instanceCount : totalVisible;
+
+      // Guard against LoD groups from a previous frame
+      start = std::min(start, totalVisible);
+      end = std::min(end, totalVisible);
+
+      if (mesh.useVisibilityIndices) {
+        mesh.objects.sortIndicesByDepth(mesh.visibleIndices.data(), start, end, camera, order);
+      } else {
+        mesh.objects.sortByDepth((u16)start, (u16)end, camera, order);
+      }
+    }
+  }
+}
+
 void Gm_RenderImage(GmContext* context, SDL_Surface* image, u32 x, u32 y, u32 w, u32 h) {
   context->scene.ui.surfaces.push_back({ image, x, y, w, h });
 }
@@ -7,9 +7,14 @@
 #include <string>
 #include <vector>
 
+#include "performance/memory.h"
 #include "system/camera.h"
 #include "system/entities.h"
+#include "system/FlatMap.h"
 #include "system/InputSystem.h"
+#include "system/LightPool.h"
+#include "system/names.h"
+#include "system/occlusion.h"
 #include "system/Signaler.h"
 #include "system/traits.h"
 #include "system/type_aliases.h"
@@ -21,16 +26,18 @@
 #define commit(object) Gm_Commit(context, object)
 #define save_light(lightName, light) Gm_SaveLight(context, lightName, light)
 #define get_object_by_record(record) Gm_GetObjectByRecord(context, record)
-#define is_mesh_object(object, meshName) object._record.meshIndex == context->scene.meshMap.at(meshName)->index
+#define is_mesh_object(object, meshName) Gm_IsMeshObject(context, object, meshName)
 #define get_light(lightName) Gm_GetLight(context, lightName)
 #define remove_object(object) Gm_RemoveObject(context, object)
 #define remove_light(light) Gm_RemoveLight(context, light)
-#define mesh(meshName) context->scene.meshMap.at(meshName)
+#define mesh(meshName) Gm_GetMesh(context, meshName)
 #define objects(meshName) Gm_GetObjects(context, meshName)
 #define point_camera_at(...) Gm_PointCameraAt(context, __VA_ARGS__)
 #define smoothly_point_camera_at(...) Gm_SmoothlyPointCameraAt(context, __VA_ARGS__)
 #define use_frustum_culling(...) Gm_UseFrustumCulling(context, __VA_ARGS__)
+#define use_occlusion_culling(...) Gm_UseOcclusionCulling(context, __VA_ARGS__)
 #define use_lod_by_distance(distance, ...) Gm_UseLodByDistance(context, distance, __VA_ARGS__)
+#define use_depth_sorting(...) Gm_UseDepthSorting(context, __VA_ARGS__)
 
 #define render_image(image, x, y, w, h) Gm_RenderImage(context, image, x, y, w, h)
 #define render_text(font, text, x, y) Gm_RenderText(context, font, text, x, y)
@@ -55,6 +62,8 @@ struct GmSceneStats {
   u32 tris = 0;
   u32 totalLights = 0;
   u32 totalMeshes = 0;
+  u32 geometryMemory = 0;
+  u32 releasedGeometryMemory = 0;
 };
 
 struct RenderSurface {
@@ -81,13 +90,13 @@ struct GmScene {
   Gamma::Camera camera;
   Gamma::InputSystem input;
   std::vector<Gamma::Mesh*> meshes;
-  std::vector<Gamma::Light*> lights;
-  std::map<std::string, Gamma::Mesh*> meshMap;
+  Gamma::LightPool lights;
+  Gamma::FlatMap<Gamma::Mesh*> meshMap;
   std::map<std::string, Gamma::Vec3f> probeMap;
-  std::map<std::string, Gamma::ObjectRecord> objectStore;
-  // @todo when recycling a light, its lightStore entry should be removed
-  std::map<std::string, Gamma::Light*> lightStore;
+  Gamma::FlatMap<Gamma::ObjectRecord> objectStore;
+  Gamma::FlatMap<Gamma::LightHandle> lightStore;
   Gamma::Vec3f freeCameraVelocity = Gamma::Vec3f(0.0f);
+  Gamma::OcclusionBuffer occlusion;
   u32 frame = 0;
   float sceneTime = 0.0f;
   std::string clouds;
@@ -117,21 +126,31 @@ struct GmScene {
 };
 
 const GmSceneStats Gm_GetSceneStats(GmContext* context);
+Gamma::MemorySnapshot Gm_GetMemorySnapshot(GmContext* context, bool includeMeshes = true);
 void Gm_AddMesh(GmContext* context, const std::string& meshName, u16 maxInstances, Gamma::Mesh* mesh);
 void Gm_AddProbe(GmContext* context, const std::string& probeName, const Gamma::Vec3f& position);
 Gamma::Light& Gm_CreateLight(GmContext* context, Gamma::LightType type);
 void Gm_UseSceneFile(GmContext* context, const std::string& filename);
-Gamma::Object& Gm_CreateObjectFrom(GmContext* context, const std::string& meshName);
+Gamma::Object& Gm_CreateObjectFrom(GmContext* context, Gamma::NameId meshName);
+Gamma::Object& Gm_CreateObjectFrom(GmContext* context, Gamma::MeshHandle handle);
 Gamma::Object& Gm_CreateObjectFrom(GmContext* context, u16 meshIndex);
 void Gm_Commit(GmContext* context, const Gamma::Object& object);
-Gamma::ObjectPool& Gm_GetObjects(GmContext* context, const std::string& meshName);
+Gamma::Mesh* Gm_GetMesh(GmContext* context, Gamma::NameId meshName);
+Gamma::Mesh* Gm_GetMesh(GmContext* context, Gamma::MeshHandle handle);
+Gamma::MeshHandle Gm_GetMeshHandle(GmContext* context, Gamma::NameId meshName);
+Gamma::ObjectPool& Gm_GetObjects(GmContext* context, Gamma::NameId meshName);
+Gamma::ObjectPool& Gm_GetObjects(GmContext* context, Gamma::MeshHandle handle);
+bool Gm_IsMeshObject(GmContext* context, const Gamma::Object& object, Gamma::NameId meshName);
+bool Gm_IsMeshObject(GmContext* context, const Gamma::Object& object, Gamma::MeshHandle handle);
 void Gm_SaveObject(GmContext* context, const std::string& objectName, const Gamma::Object& object);
 void Gm_SaveLight(GmContext* context, const std::string& lightName, Gamma::Light* light);
-bool Gm_HasObject(GmContext* context, const std::string& objectName);
-Gamma::Object* Gm_FindObject(GmContext* context, const std::string& objectName);
-Gamma::Object& Gm_GetObject(GmContext* context, const std::string& objectName);
+bool Gm_HasObject(GmContext* context, Gamma::NameId objectName);
+Gamma::Object* Gm_FindObject(GmContext* context, Gamma::NameId objectName);
+Gamma::Object& Gm_GetObject(GmContext* context, Gamma::NameId objectName);
 Gamma::Object* Gm_GetObjectByRecord(GmContext* context, const Gamma::ObjectRecord& record);
-Gamma::Light& Gm_GetLight(GmContext* context, const std::string& lightName);
+Gamma::Light& Gm_GetLight(GmContext* context, Gamma::NameId lightName);
+Gamma::LightHandle Gm_GetLightHandle(GmContext* context, Gamma::NameId lightName);
+Gamma::Light* Gm_GetLightByHandle(GmContext* context, const Gamma::LightHandle& handle);
 void Gm_RemoveObject(GmContext* context, const Gamma::Object& object);
 void Gm_RemoveLight(GmContext* context, Gamma::Light* light);
 void Gm_ResetScene(GmContext* context);
@@ -142,8 +161,10 @@ void Gm_SmoothlyPointCameraAt(GmContext* context, const Gamma::Object& object, f
 void Gm_SmoothlyPointCameraAt(GmContext* context, const Gamma::Vec3f& position, float alpha, bool upsideDown = false);
 void Gm_HandleFreeCameraMode(GmContext* context, float speed, float dt);
 
-void Gm_UseFrustumCulling(GmContext* context, const std::initializer_list<std::string>& meshNames);
-void Gm_UseLodByDistance(GmContext* context, float distance, const std::initializer_list<std::string>& meshNames);
+void Gm_UseFrustumCulling(GmContext* context, const std::initializer_list<Gamma::NameId>& meshNames);
+void Gm_UseOcclusionCulling(GmContext* context, const std::initializer_list<Gamma::NameId>& meshNames);
+void Gm_UseLodByDistance(GmContext* context, float distance, const std::initializer_list<Gamma::NameId>& meshNames);
+void Gm_UseDepthSorting(GmContext* context, const std::initializer_list<Gamma::NameId>& meshNames);
 
 void Gm_RenderImage(GmContext* context, SDL_Surface* image, u32 x, u32 y, u32 w, u32 h);
 void Gm_RenderText(GmContext* context, TTF_Font* font, std::string text, u32 x, u32 y);
\ No newline at end of file
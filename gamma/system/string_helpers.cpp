@@ -12,8 +12,8 @@ using namespace Gamma;
  */
 std::vector<std::string> Gm_SplitString(const std::string& str, const std::string& delimiter) {
   std::vector<std::string> values;
-  u32 offset = 0;
-  u32 found = 0;
+  size_t offset = 0;
+  size_t found = 0;
 
   // Add each delimited string segment to the list
   while ((found = str.find(delimiter, offset)) != std::string::npos) {
@@ -59,16 +59,14 @@ std::string Gm_JoinString(const std::vector<std::string>& segments, const std::s
  * @todo handle tab characters
  */
 std::string Gm_TrimString(const std::string& str) {
-  std::string trimmed;
-  u32 start = 0;
-  u32 end = str.size();
+  size_t start = 0;
+  size_t end = str.size();
 
-  for (;;) {
-    if (str[start] == ' ') start++;
-    else if (str[--end] != ' ')  break;
-  }
+  // Empty or whitespace-only strings trim to an empty string
+  while (start < end && str[start] == ' ') start++;
+  while (end > start && str[end - 1] == ' ') end--;
 
-  return str.substr(start, end - start + 1);
+  return str.substr(start, end - start);
 }
 
 /**
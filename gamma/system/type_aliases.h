@@ -7,6 +7,7 @@ typedef void* SDL_GLContext;
 typedef int GLint;
 typedef unsigned int GLuint;
 typedef unsigned int GLenum;
+typedef struct __GLsync* GLsync;
 
 typedef signed char s8;
 typedef signed short s16;
@@ -1,35 +1,56 @@
 #include <cctype>
+#include <map>
 #include <vector>
 
+#include "performance/memory.h"
 #include "system/assert.h"
 #include "system/file.h"
 #include "system/string_helpers.h"
 #include "system/yaml_parser.h"
 
 namespace Gamma {
+  // Approximate overhead of each std::map node
+  constexpr static u32 YAML_MAP_NODE_OVERHEAD = 32;
+
+  /**
+   * Estimated sizes of parsed YAML trees, by root object,
+   * so their memory can be untracked when they're freed.
+   */
+  static std::map<const YamlObject*, u64> yamlTreeSizes;
+
   /**
    * Gm_ParsePrimitiveValue
    * ----------------------
    *
    * @todo description
    */
-  static void* Gm_ParsePrimitiveValue(const std::string& str) {
+  static void* Gm_ParsePrimitiveValue(const std::string& str, u64& bytes) {
     // Check for boolean literals
     if (str == "true") {
+      bytes += sizeof(bool);
+
       return new bool(true);
     } else if (str == "false") {
+      bytes += sizeof(bool);
+
       return new bool(false);
     }
 
     // Check for numbers
     if (std::isdigit(str[0])) {
+      bytes += sizeof(int);
+
       // @todo use std::stof if the string contains a '.'
       return new int(std::stoi(str));
     }
 
     // Fall back to string
     // @todo strip leading/trailing quotes
-    return new std::string(str);
+    auto* value = new std::string(str);
+
+    bytes += sizeof(std::string) + value->capacity();
+
+    return value;
   }
 
   /**
@@ -41,6 +62,7 @@ namespace Gamma {
     std::string fileContents = Gm_LoadFileContents(path);
     auto lines = Gm_SplitString(fileContents, "\n");
     auto* root = new YamlObject();
+    u64 bytes = sizeof(YamlObject);
 
     objectStack.push_back(root);
 
@@ -57,6 +79,8 @@ namespace Gamma {
         if (trimmedLine.back() == '{') {
           // Nested object property
           property.object = new YamlObject();
+
+          bytes += sizeof(YamlObject);
         } else if (trimmedLine.back() == '[') {
           // Specialization for array leaf properties
           auto array = new YamlArray<void*>();
@@ -71,19 +95,21 @@ namespace Gamma {
 
             // @todo strip leading/trailing quotes
 
-            array->push_back(Gm_ParsePrimitiveValue(incomingLine));
+            array->push_back(Gm_ParsePrimitiveValue(incomingLine, bytes));
 
             incomingLine = Gm_TrimString(lines[++i]);
           }
 
           property.value = array;
+
+          bytes += sizeof(YamlArray<void*>) + array->capacity() * sizeof(void*);
         } else {
           // Other leaf properties (strings, numbers, or booleans)
           u32 vStart = trimmedLine.find(":") + 1;
           u32 vLength = trimmedLine.find(",") - vStart;
           auto value = Gm_TrimString(trimmedLine.substr(vStart, vLength));
 
-          property.value = Gm_ParsePrimitiveValue(value);
+          property.value = Gm_ParsePrimitiveValue(value, bytes);
         }
 
         // Assign the property to the current object
@@ -92,6 +118,8 @@ namespace Gamma {
 
         currentObject[propertyName] = property;
 
+        bytes += sizeof(YamlObject::value_type) + YAML_MAP_NODE_OVERHEAD + propertyName.capacity();
+
         if (property.object != nullptr) {
           // Push nested objects onto the stack so they can
           // represent the current object on the next cycle
@@ -105,6 +133,10 @@ namespace Gamma {
 
     assert(objectStack.size() == 0, "Malformed YAML file");
 
+    yamlTreeSizes[root] = bytes;
+
+    Gm_TrackMemory(MemoryCategory::YAML, bytes);
+
     return *root;
   }
 
@@ -121,6 +153,14 @@ namespace Gamma {
    * --------------------
    */
   void Gm_FreeYamlObject(YamlObject* object) {
+    auto treeSize = yamlTreeSizes.find(object);
+
+    if (treeSize != yamlTreeSizes.end()) {
+      Gm_TrackMemory(MemoryCategory::YAML, -(s64)treeSize->second);
+
+      yamlTreeSizes.erase(treeSize);
+    }
+
     for (auto& [ key, property ] : *object) {
       if (property.object != nullptr) {
         Gm_FreeYamlObject(property.object);
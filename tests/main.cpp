@@ -0,0 +1,1006 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "math/constants.h"
+#include "math/matrix.h"
+#include "math/vector.h"
+#include "physics/broadphase.h"
+#include "system/camera.h"
+#include "system/culling.h"
+#include "system/depth_sort.h"
+#include "system/entities.h"
+#include "system/FlatMap.h"
+#include "system/light_clusters.h"
+#include "system/ObjectPool.h"
+#include "system/occlusion.h"
+
+using namespace Gamma;
+
+/**
+ * TestCase
+ * --------
+ *
+ * A named headless test. test() returns false if any of
+ * its checks failed, after printing what went wrong.
+ */
+struct TestCase {
+  std::string name;
+  std::function<bool()> test;
+};
+
+static std::mt19937 rng(1234);
+
+static float Gm_RandomInRange(float low, float high) {
+  return std::uniform_real_distribution<float>(low, high)(rng);
+}
+
+static bool Gm_Check(bool condition, const std::string& message) {
+  if (!condition) {
+    printf("  FAILED: %s\n", message.c_str());
+  }
+
+  return condition;
+}
+
+/**
+ * LightClusterView
+ * ----------------
+ *
+ * A camera and resolution to bin lights against, with the
+ * projection scales needed to place view-space points in
+ * clusters.
+ */
+struct LightClusterView {
+  Camera camera;
+  Area<u32> resolution = { 1920, 1080 };
+  Matrix4f matView;
+  float scaleX = 1.f;
+  float scaleY = 1.f;
+
+  LightClusterView() {
+    camera.position = Vec3f(0, 50.f, -200.f);
+    camera.orientation.pitch = 0.2f;
+    camera.orientation.yaw = 0.3f;
+
+    matView = Gm_GetCameraViewMatrix(camera);
+    scaleY = 1.f / tanf(camera.fov / 2.f * DEGREES_TO_RADIANS);
+    scaleX = scaleY / ((float)resolution.width / (float)resolution.height);
+  }
+};
+
+/**
+ * Gm_GetPointCluster
+ * ------------------
+ *
+ * Finds the cluster containing a world-space point, if the
+ * point is inside the view frustum.
+ */
+static bool Gm_GetPointCluster(const LightClusters& lightClusters, const LightClusterView& view, const Vec3f& point, u32& clusterIndex) {
+  Vec3f local = view.matView.transformVec3f(point);
+
+  if (local.z < lightClusters.near) {
+    return false;
+  }
+
+  float ndcX = view.scaleX * local.x / local.z;
+  float ndcY = view.scaleY * local.y / local.z;
+
+  if (fabsf(ndcX) > 1.f || fabsf(ndcY) > 1.f) {
+    return false;
+  }
+
+  u32 x = std::min((u32)floorf((ndcX * 0.5f + 0.5f) * lightClusters.width), lightClusters.width - 1);
+  u32 y = std::min((u32)floorf((ndcY * 0.5f + 0.5f) * lightClusters.height), lightClusters.height - 1);
+  u32 z = Gm_GetLightClusterSlice(lightClusters, local.z);
+
+  clusterIndex = Gm_GetLightClusterIndex(lightClusters, x, y, z);
+
+  return true;
+}
+
+static bool Gm_IsLightInCluster(const LightClusters& lightClusters, u32 clusterIndex, u32 lightIndex) {
+  auto& cluster = lightClusters.clusters[clusterIndex];
+
+  for (u32 i = cluster.offset; i < cluster.offset + cluster.count; i++) {
+    if (lightClusters.lightIndices[i] == lightIndex) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static u32 Gm_CountLightClusters(const LightClusters& lightClusters, u32 lightIndex) {
+  u32 total = 0;
+
+  for (u32 i = 0; i < lightClusters.clusters.size(); i++) {
+    if (Gm_IsLightInCluster(lightClusters, i, lightIndex)) {
+      total++;
+    }
+  }
+
+  return total;
+}
+
+/**
+ * Gm_CheckLightClustersAgainstBruteForce
+ * --------------------------------------
+ *
+ * Samples points throughout each light's sphere and checks
+ * that every cluster containing a sample lists the light.
+ * Binning is conservative, so lights may also be listed in
+ * clusters near their sphere, but never missing from one
+ * their sphere reaches.
+ */
+static bool Gm_CheckLightClustersAgainstBruteForce(const LightClusters& lightClusters, const LightClusterView& view, const std::vector<Light*>& lights) {
+  constexpr static s32 SAMPLES = 5;
+  bool passed = true;
+
+  for (u32 i = 0; i < lights.size(); i++) {
+    auto& light = *lights[i];
+
+    if (light.power == 0.f) {
+      continue;
+    }
+
+    // Keep samples just inside the sphere, so they aren't
+    // affected by rounding at its edges
+    float step = light.radius * 0.99f / (float)SAMPLES;
+
+    for (s32 x = -SAMPLES; x <= SAMPLES; x++) {
+      for (s32 y = -SAMPLES; y <= SAMPLES; y++) {
+        for (s32 z = -SAMPLES; z <= SAMPLES; z++) {
+          Vec3f offset = Vec3f((float)x, (float)y, (float)z) * step;
+          u32 clusterIndex;
+
+          if (offset.magnitude() > light.radius * 0.99f) {
+            continue;
+          }
+
+          if (Gm_GetPointCluster(lightClusters, view, light.position + offset, clusterIndex) && !Gm_IsLightInCluster(lightClusters, clusterIndex, i)) {
+            passed = Gm_Check(false, "light " + std::to_string(i) + " is missing from cluster " + std::to_string(clusterIndex));
+
+            // One failure per light is enough to report
+            x = y = z = SAMPLES;
+          }
+        }
+      }
+    }
+  }
+
+  // Each cluster's light indices should be ascending,
+  // with no duplicates
+  for (auto& cluster : lightClusters.clusters) {
+    for (u32 i = cluster.offset + 1; i < cluster.offset + cluster.count; i++) {
+      if (lightClusters.lightIndices[i - 1] >= lightClusters.lightIndices[i]) {
+        return Gm_Check(false, "cluster light indices are out of order");
+      }
+    }
+  }
+
+  return passed;
+}
+
+static void Gm_AddLightClusterTests(std::vector<TestCase>& tests) {
+  tests.push_back({
+    "light_clusters/matches_brute_force",
+    []() {
+      std::vector<Light> lights(300);
+      std::vector<Light*> lightPointers;
+      LightClusters lightClusters;
+      LightClusterView view;
+
+      for (auto& light : lights) {
+        light.position = Vec3f(Gm_RandomInRange(-1500.f, 1500.f), Gm_RandomInRange(-500.f, 500.f), Gm_RandomInRange(-500.f, 3000.f));
+        light.radius = Gm_RandomInRange(5.f, 400.f);
+
+        lightPointers.push_back(&light);
+      }
+
+      Gm_BuildLightClusters(lightClusters, lightPointers, view.camera, view.resolution);
+
+      return Gm_CheckLightClustersAgainstBruteForce(lightClusters, view, lightPointers);
+    }
+  });
+
+  tests.push_back({
+    "light_clusters/skips_zero_power_lights",
+    []() {
+      Light visible;
+      Light unpowered;
+      LightClusters lightClusters;
+      LightClusterView view;
+      Vec3f ahead = view.camera.position + view.camera.orientation.getDirection() * 500.f;
+
+      visible.position = ahead;
+      unpowered.position = ahead;
+      unpowered.power = 0.f;
+
+      std::vector<Light*> lights = { &visible, &unpowered };
+
+      Gm_BuildLightClusters(lightClusters, lights, view.camera, view.resolution);
+
+      return (
+        Gm_Check(Gm_CountLightClusters(lightClusters, 0) > 0, "the powered light should be binned") &&
+        Gm_Check(Gm_CountLightClusters(lightClusters, 1) == 0, "the zero-power light should not be binned") &&
+        Gm_CheckLightClustersAgainstBruteForce(lightClusters, view, lights)
+      );
+    }
+  });
+
+  tests.push_back({
+    "light_clusters/skips_lights_behind_camera",
+    []() {
+      Light behind;
+      Light straddling;
+      LightClusters lightClusters;
+      LightClusterView view;
+      Vec3f direction = view.camera.orientation.getDirection();
+
+      behind.position = view.camera.position - direction * 100.f;
+      behind.radius = 50.f;
+
+      // Reaches past the near plane, so is still visible
+      straddling.position = view.camera.position - direction * 20.f;
+      straddling.radius = 50.f;
+
+      std::vector<Light*> lights = { &behind, &straddling };
+
+      Gm_BuildLightClusters(lightClusters, lights, view.camera, view.resolution);
+
+      return (
+        Gm_Check(Gm_CountLightClusters(lightClusters, 0) == 0, "the light behind the camera should not be binned") &&
+        Gm_Check(Gm_CountLightClusters(lightClusters, 1) > 0, "the light straddling the camera should be binned") &&
+        Gm_CheckLightClustersAgainstBruteForce(lightClusters, view, lights)
+      );
+    }
+  });
+}
+
+/**
+ * Gm_EstimateOverdraw
+ * -------------------
+ *
+ * Rasterizes the screen-space bounds of a pool's visible
+ * objects in pool order, each at its nearest view depth,
+ * and returns how many times each covered pixel passed
+ * the depth test on average.
+ */
+static float Gm_EstimateOverdraw(ObjectPool& pool, const Camera& camera) {
+  constexpr static s32 WIDTH = 320;
+  constexpr static s32 HEIGHT = 180;
+  std::vector<float> depthBuffer(WIDTH * HEIGHT, INFINITY);
+  Matrix4f matView = Gm_GetCameraViewMatrix(camera);
+  float scaleY = 1.f / tanf(camera.fov / 2.f * DEGREES_TO_RADIANS);
+  float scaleX = scaleY / ((float)WIDTH / (float)HEIGHT);
+  u64 depthWrites = 0;
+  u64 coveredPixels = 0;
+
+  for (u32 i = 0; i < pool.totalVisible(); i++) {
+    auto& object = pool[i];
+    Vec3f local = matView.transformVec3f(object.position);
+    float radius = object.scale.x * sqrtf(3.f);
+    float depth = local.z - radius;
+
+    if (depth <= 0.f) {
+      continue;
+    }
+
+    // Project the bounding square into pixel coordinates
+    float x = (scaleX * local.x / local.z * 0.5f + 0.5f) * WIDTH;
+    float y = (scaleY * local.y / local.z * 0.5f + 0.5f) * HEIGHT;
+    float halfWidth = scaleX * radius / depth * 0.5f * WIDTH;
+    float halfHeight = scaleY * radius / depth * 0.5f * HEIGHT;
+    s32 minX = std::max((s32)(x - halfWidth), 0);
+    s32 maxX = std::min((s32)(x + halfWidth), WIDTH - 1);
+    s32 minY = std::max((s32)(y - halfHeight), 0);
+    s32 maxY = std::min((s32)(y + halfHeight), HEIGHT - 1);
+
+    for (s32 py = minY; py <= maxY; py++) {
+      for (s32 px = minX; px <= maxX; px++) {
+        float& current = depthBuffer[py * WIDTH + px];
+
+        if (depth < current) {
+          if (current == INFINITY) {
+            coveredPixels++;
+          }
+
+          current = depth;
+          depthWrites++;
+        }
+      }
+    }
+  }
+
+  return (float)depthWrites / (float)std::max(coveredPixels, (u64)1);
+}
+
+static void Gm_AddDepthSortTests(std::vector<TestCase>& tests) {
+  tests.push_back({
+    "depth_sort/sorts_values_by_depth",
+    []() {
+      constexpr static u32 TOTAL = 20000;
+      std::vector<float> depths(TOTAL);
+      std::vector<u32> values(TOTAL);
+      bool passed = true;
+
+      for (auto order : { DepthSortOrder::FRONT_TO_BACK, DepthSortOrder::BACK_TO_FRONT }) {
+        for (u32 i = 0; i < TOTAL; i++) {
+          depths[i] = Gm_RandomInRange(0.f, 1000.f);
+          values[i] = i;
+        }
+
+        std::vector<float> valueDepths = depths;
+
+        Gm_SortByDepth(depths.data(), values.data(), TOTAL, order);
+
+        // Depths are quantized to 16 bits over their range,
+        // so allow values within one key of each other in
+        // either order
+        float tolerance = 1000.f / 65535.f;
+
+        for (u32 i = 1; i < TOTAL; i++) {
+          float previous = valueDepths[values[i - 1]];
+          float current = valueDepths[values[i]];
+          bool isOrdered = order == DepthSortOrder::FRONT_TO_BACK ? previous <= current + tolerance : previous + tolerance >= current;
+
+          if (!isOrdered) {
+            passed = Gm_Check(false, "values are out of order at index " + std::to_string(i));
+
+            break;
+          }
+        }
+      }
+
+      return passed;
+    }
+  });
+
+  tests.push_back({
+    "depth_sort/front_to_back_reduces_overdraw",
+    []() {
+      // A crowd of objects in front of the camera, scaled with
+      // distance so they overlap heavily on screen
+      constexpr static u32 TOTAL_OBJECTS = 400;
+      // ObjectPools are too large for the stack
+      auto* pool = new ObjectPool();
+      Camera camera;
+      Vec3f direction = camera.orientation.getDirection();
+
+      pool->reserve(TOTAL_OBJECTS);
+
+      for (u32 i = 0; i < TOTAL_OBJECTS; i++) {
+        auto& object = pool->createObject();
+        float distance = Gm_RandomInRange(50.f, 2000.f);
+
+        object.position = camera.position + direction * distance + Vec3f(Gm_RandomInRange(-0.2f, 0.2f), Gm_RandomInRange(-0.1f, 0.1f), 0.f) * distance;
+        object.scale = Vec3f(distance * 0.05f);
+        object.rotation = Quaternion(1.f, 0, 0, 0);
+      }
+
+      pool->showAll();
+
+      float poolOrderOverdraw = Gm_EstimateOverdraw(*pool, camera);
+
+      pool->sortByDepth(0, pool->totalVisible(), camera, DepthSortOrder::FRONT_TO_BACK);
+
+      float frontToBackOverdraw = Gm_EstimateOverdraw(*pool, camera);
+
+      pool->sortByDepth(0, pool->totalVisible(), camera, DepthSortOrder::BACK_TO_FRONT);
+
+      float backToFrontOverdraw = Gm_EstimateOverdraw(*pool, camera);
+
+      printf("  Estimated overdraw: %.2fx back-to-front, %.2fx pool order, %.2fx front-to-back\n", backToFrontOverdraw, poolOrderOverdraw, frontToBackOverdraw);
+
+      delete pool;
+
+      return (
+        Gm_Check(frontToBackOverdraw >= 1.f, "overdraw can't be below 1x") &&
+        Gm_Check(frontToBackOverdraw < poolOrderOverdraw, "front-to-back should have less overdraw than pool order") &&
+        Gm_Check(poolOrderOverdraw < backToFrontOverdraw, "pool order should have less overdraw than back-to-front")
+      );
+    }
+  });
+}
+
+/**
+ * Gm_CheckPoolRanges
+ * ------------------
+ *
+ * Checks the sizes of an object pool's visible, active and
+ * inactive ranges, and that every object in the pool can
+ * still be found by its ID.
+ */
+static bool Gm_CheckPoolRanges(ObjectPool& pool, u16 visible, u16 active, u16 inactive) {
+  if (
+    !Gm_Check(pool.totalVisible() == visible, "expected " + std::to_string(visible) + " visible objects, found " + std::to_string(pool.totalVisible())) ||
+    !Gm_Check(pool.totalActive() == active, "expected " + std::to_string(active) + " active objects, found " + std::to_string(pool.totalActive())) ||
+    !Gm_Check(pool.totalInactive() == inactive, "expected " + std::to_string(inactive) + " inactive objects, found " + std::to_string(pool.totalInactive()))
+  ) {
+    return false;
+  }
+
+  for (u32 i = 0; i < u32(active + inactive); i++) {
+    u16 id = pool[i]._record.id;
+
+    if (!Gm_Check(pool.getById(id) == &pool[i], "object " + std::to_string(id) + " is not found at index " + std::to_string(i))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Gm_IsObjectInRange
+ * ------------------
+ *
+ * Determines whether an object is stored within a range of
+ * pool indices, e.g. [0, totalVisible()) for visible objects.
+ */
+static bool Gm_IsObjectInRange(ObjectPool& pool, u16 objectId, u32 start, u32 end) {
+  auto* object = pool.getById(objectId);
+
+  if (object == nullptr) {
+    return false;
+  }
+
+  u32 index = u32(object - &pool[0]);
+
+  return index >= start && index < end;
+}
+
+static void Gm_AddObjectPoolTests(std::vector<TestCase>& tests) {
+  tests.push_back({
+    "object_pool/creates_visible_objects_ahead_of_culled_objects",
+    []() {
+      // ObjectPools are too large for the stack
+      auto* pool = new ObjectPool();
+
+      pool->reserve(8);
+
+      for (u32 i = 0; i < 4; i++) {
+        pool->createObject();
+      }
+
+      // Cull objects 2 and 3
+      pool->setTotalVisible(2);
+
+      u16 id = pool->createObject()._record.id;
+
+      bool passed = (
+        Gm_CheckPoolRanges(*pool, 3, 5, 0) &&
+        Gm_Check(Gm_IsObjectInRange(*pool, id, 0, 3), "a new object should be visible") &&
+        Gm_Check(Gm_IsObjectInRange(*pool, 2, 3, 5) && Gm_IsObjectInRange(*pool, 3, 3, 5), "culled objects should stay culled")
+      );
+
+      pool->free();
+
+      delete pool;
+
+      return passed;
+    }
+  });
+
+  tests.push_back({
+    "object_pool/deactivates_and_activates_objects",
+    []() {
+      auto* pool = new ObjectPool();
+
+      pool->reserve(8);
+
+      for (u32 i = 0; i < 5; i++) {
+        pool->createObject();
+      }
+
+      // Cull objects 3 and 4
+      pool->setTotalVisible(3);
+
+      bool passed = true;
+
+      // Visible -> inactive
+      pool->deactivateById(1);
+
+      passed = passed && Gm_CheckPoolRanges(*pool, 2, 4, 1) && Gm_Check(Gm_IsObjectInRange(*pool, 1, 4, 5), "object 1 should be inactive");
+
+      // Culled -> inactive
+      pool->deactivateById(4);
+
+      passed = passed && Gm_CheckPoolRanges(*pool, 2, 3, 2) && Gm_Check(Gm_IsObjectInRange(*pool, 4, 3, 5), "object 4 should be inactive");
+
+      // Deactivating an inactive object does nothing
+      pool->deactivateById(1);
+
+      passed = passed && Gm_CheckPoolRanges(*pool, 2, 3, 2);
+
+      // Creating an object keeps the inactive range intact
+      u16 id = pool->createObject()._record.id;
+
+      passed = passed && Gm_CheckPoolRanges(*pool, 3, 4, 2) && Gm_Check(Gm_IsObjectInRange(*pool, id, 0, 3), "a new object should be visible");
+
+      // Inactive -> visible
+      pool->activateById(4);
+
+      passed = passed && Gm_CheckPoolRanges(*pool, 4, 5, 1) && Gm_Check(Gm_IsObjectInRange(*pool, 4, 0, 4), "object 4 should be visible");
+
+      // Activating an active object does nothing
+      pool->activateById(4);
+
+      passed = passed && Gm_CheckPoolRanges(*pool, 4, 5, 1) && Gm_Check(Gm_IsObjectInRange(*pool, 3, 4, 5), "object 3 should still be culled");
+
+      pool->free();
+
+      delete pool;
+
+      return passed;
+    }
+  });
+
+  tests.push_back({
+    "object_pool/acquires_inactive_objects",
+    []() {
+      auto* pool = new ObjectPool();
+
+      pool->reserve(4);
+
+      for (u32 i = 0; i < 3; i++) {
+        pool->createObject();
+      }
+
+      bool passed = Gm_Check(pool->acquireInactiveObject() == nullptr, "no object should be acquired without inactive objects");
+
+      pool->setTotalVisible(2);
+      pool->deactivateById(0);
+
+      ObjectRecord record = pool->getById(0)->_record;
+      auto* object = pool->acquireInactiveObject();
+
+      passed = passed && (
+        Gm_Check(object != nullptr && object->_record.id == 0, "the inactive object should be acquired") &&
+        Gm_Check(object->_record.generation == record.generation + 1, "the acquired object's generation should be incremented") &&
+        Gm_Check(pool->getByRecord(record) == nullptr, "records of the object's previous use should be stale") &&
+        Gm_CheckPoolRanges(*pool, 2, 3, 0) &&
+        Gm_Check(Gm_IsObjectInRange(*pool, 0, 0, 2), "the acquired object should be visible") &&
+        Gm_Check(Gm_IsObjectInRange(*pool, 2, 2, 3), "object 2 should still be culled")
+      );
+
+      pool->free();
+
+      delete pool;
+
+      return passed;
+    }
+  });
+
+  tests.push_back({
+    "object_pool/removes_objects_from_each_range",
+    []() {
+      auto* pool = new ObjectPool();
+
+      pool->reserve(8);
+
+      for (u32 i = 0; i < 6; i++) {
+        pool->createObject();
+      }
+
+      // Objects 0-1 visible, 2-3 culled, 4-5 inactive
+      pool->setTotalVisible(4);
+      pool->deactivateById(4);
+      pool->deactivateById(5);
+      pool->setTotalVisible(2);
+
+      bool passed = Gm_CheckPoolRanges(*pool, 2, 4, 2);
+
+      pool->removeById(0);
+
+      passed = passed && Gm_CheckPoolRanges(*pool, 1, 3, 2) && Gm_Check(pool->getById(0) == nullptr, "object 0 should be removed");
+
+      pool->removeById(2);
+
+      passed = passed && Gm_CheckPoolRanges(*pool, 1, 2, 2) && Gm_Check(pool->getById(2) == nullptr, "object 2 should be removed");
+
+      pool->removeById(4);
+
+      passed = passed && (
+        Gm_CheckPoolRanges(*pool, 1, 2, 1) &&
+        Gm_Check(pool->getById(4) == nullptr, "object 4 should be removed") &&
+        Gm_Check(Gm_IsObjectInRange(*pool, 1, 0, 1), "object 1 should still be visible") &&
+        Gm_Check(Gm_IsObjectInRange(*pool, 3, 1, 2), "object 3 should still be culled") &&
+        Gm_Check(Gm_IsObjectInRange(*pool, 5, 2, 3), "object 5 should still be inactive")
+      );
+
+      pool->free();
+
+      delete pool;
+
+      return passed;
+    }
+  });
+}
+
+/**
+ * OcclusionScene
+ * --------------
+ *
+ * A wall occluder 100 units in front of the default camera,
+ * rasterized into an occlusion buffer. Positions are given
+ * in view terms: ahead() along the camera direction, and
+ * right() across it.
+ */
+struct OcclusionScene {
+  Camera camera;
+  Mesh* wall = nullptr;
+  OcclusionBuffer buffer;
+
+  OcclusionScene() {
+    wall = Mesh::Cube();
+    wall->isOccluder = true;
+    wall->objects.reserve(1);
+
+    auto& object = wall->objects.createObject();
+
+    // A 60x60 wall, 2 units thick
+    object.position = ahead(100.f);
+    object.scale = Vec3f(30.f, 30.f, 1.f);
+    object.rotation = Quaternion(1.f, 0, 0, 0);
+
+    std::vector<Mesh*> meshes = { wall };
+
+    Gm_RasterizeOccluders(buffer, meshes, camera, 16.f / 9.f);
+  }
+
+  ~OcclusionScene() {
+    Gm_FreeMesh(wall);
+
+    delete wall;
+  }
+
+  Vec3f ahead(float distance) const {
+    return camera.position + camera.orientation.getDirection() * distance;
+  }
+
+  Vec3f right(float distance) const {
+    return camera.orientation.getRightDirection() * distance;
+  }
+};
+
+/**
+ * Gm_CreateOcclusionTargets
+ * -------------------------
+ *
+ * Creates a mesh with six objects alternating between
+ * positions behind the wall and beside it.
+ */
+static Mesh* Gm_CreateOcclusionTargets(const OcclusionScene& scene) {
+  auto* mesh = Mesh::Cube();
+
+  Gm_ComputeBoundingRadius(mesh);
+  mesh->objects.reserve(6);
+
+  for (u32 i = 0; i < 6; i++) {
+    auto& object = mesh->objects.createObject();
+    bool isBehindWall = i % 2 == 0;
+
+    object.position = scene.ahead(300.f + (float)i * 10.f) + (isBehindWall ? Vec3f(0.f) : scene.right(150.f));
+    object.scale = Vec3f(5.f);
+    object.rotation = Quaternion(1.f, 0, 0, 0);
+  }
+
+  return mesh;
+}
+
+static void Gm_AddOcclusionTests(std::vector<TestCase>& tests) {
+  tests.push_back({
+    "occlusion/sphere_behind_wall_is_occluded",
+    []() {
+      OcclusionScene scene;
+
+      return (
+        Gm_Check(scene.buffer.stats.totalOccluderTriangles > 0, "the wall should be rasterized") &&
+        Gm_Check(Gm_IsSphereOccluded(scene.buffer, scene.ahead(300.f), 10.f), "a sphere behind the wall should be occluded")
+      );
+    }
+  });
+
+  tests.push_back({
+    "occlusion/visible_spheres_are_not_occluded",
+    []() {
+      OcclusionScene scene;
+
+      return (
+        Gm_Check(!Gm_IsSphereOccluded(scene.buffer, scene.ahead(50.f), 5.f), "a sphere in front of the wall should be visible") &&
+        Gm_Check(!Gm_IsSphereOccluded(scene.buffer, scene.ahead(100.f), 10.f), "a sphere straddling the wall should be visible") &&
+        Gm_Check(!Gm_IsSphereOccluded(scene.buffer, scene.ahead(300.f) + scene.right(150.f), 10.f), "a sphere beside the wall should be visible") &&
+        Gm_Check(!Gm_IsSphereOccluded(scene.buffer, scene.ahead(300.f) + scene.right(1000.f), 10.f), "an off-screen sphere should not be occluded")
+      );
+    }
+  });
+
+  tests.push_back({
+    "occlusion/culls_occluded_indices_in_order",
+    []() {
+      OcclusionScene scene;
+      auto* mesh = Gm_CreateOcclusionTargets(scene);
+      std::vector<u32> visibleIndices = { 0, 1, 2, 3, 4, 5 };
+      u32 totalCulled = mesh->objects.cullOccludedIndices(scene.buffer, *mesh, visibleIndices);
+      bool passed = (
+        Gm_Check(totalCulled == 3, "3 indices should be culled, not " + std::to_string(totalCulled)) &&
+        Gm_Check(visibleIndices == std::vector<u32>({ 1, 3, 5 }), "only the objects beside the wall should remain, in order")
+      );
+
+      Gm_FreeMesh(mesh);
+
+      delete mesh;
+
+      return passed;
+    }
+  });
+
+  tests.push_back({
+    "occlusion/partitions_occluded_objects",
+    []() {
+      OcclusionScene scene;
+      auto* mesh = Gm_CreateOcclusionTargets(scene);
+      auto& objects = mesh->objects;
+      u16 totalOccluded = objects.partitionByOcclusion(scene.buffer, *mesh);
+      bool passed = (
+        Gm_Check(totalOccluded == 3, "3 objects should be occluded, not " + std::to_string(totalOccluded)) &&
+        Gm_Check(objects.totalVisible() == 3, "3 objects should remain visible") &&
+        Gm_Check(objects.totalActive() == 6, "occluded objects should stay active")
+      );
+
+      for (u32 i = 0; i < objects.totalActive(); i++) {
+        bool isOccluded = Gm_IsSphereOccluded(scene.buffer, objects[i].position, Gm_GetObjectBoundingRadius(*mesh, objects[i]));
+
+        if (isOccluded != (i >= objects.totalVisible())) {
+          passed = Gm_Check(false, "object " + std::to_string(i) + " is in the wrong range");
+        }
+      }
+
+      Gm_FreeMesh(mesh);
+
+      delete mesh;
+
+      return passed;
+    }
+  });
+}
+
+/**
+ * Gm_FindCollidingKeys
+ * --------------------
+ *
+ * Finds keys whose ideal slot in a 16-slot FlatMap is the
+ * given slot, mirroring the map's Fibonacci hashing.
+ */
+static std::vector<u32> Gm_FindCollidingKeys(u32 slot, u32 total) {
+  std::vector<u32> keys;
+
+  for (u32 key = 1; keys.size() < total; key++) {
+    if (((key * 2654435769u) >> 28) == slot) {
+      keys.push_back(key);
+    }
+  }
+
+  return keys;
+}
+
+static void Gm_AddFlatMapTests(std::vector<TestCase>& tests) {
+  tests.push_back({
+    "flat_map/erases_colliding_keys_across_wraparound",
+    []() {
+      // Three keys wanting the last slot wrap around to fill
+      // slots 15, 0 and 1, pushing a key wanting slot 0 into
+      // slot 2. Erasing any of them must shift the rest back
+      // without stranding entries behind an empty slot.
+      auto lastSlotKeys = Gm_FindCollidingKeys(15, 3);
+      auto firstSlotKeys = Gm_FindCollidingKeys(0, 1);
+      std::vector<u32> keys = { lastSlotKeys[0], lastSlotKeys[1], lastSlotKeys[2], firstSlotKeys[0] };
+
+      for (u32 erased = 0; erased < keys.size(); erased++) {
+        FlatMap<u32> map;
+
+        for (u32 i = 0; i < keys.size(); i++) {
+          map[keys[i]] = i + 1;
+        }
+
+        map.erase(keys[erased]);
+
+        if (!Gm_Check(map.size() == keys.size() - 1, "erasing key " + std::to_string(erased) + " should leave " + std::to_string(keys.size() - 1) + " entries")) {
+          return false;
+        }
+
+        for (u32 i = 0; i < keys.size(); i++) {
+          auto* value = map.find(keys[i]);
+
+          if (i == erased) {
+            if (!Gm_Check(value == nullptr, "key " + std::to_string(i) + " should be erased")) {
+              return false;
+            }
+          } else if (!Gm_Check(value != nullptr && *value == i + 1, "key " + std::to_string(i) + " should survive erasing key " + std::to_string(erased))) {
+            return false;
+          }
+        }
+      }
+
+      return true;
+    }
+  });
+
+  tests.push_back({
+    "flat_map/matches_unordered_map",
+    []() {
+      // Keys are drawn from a small pool, so inserts, erases
+      // and misses all happen often. Small consecutive keys
+      // hash without colliding, so the pool is random.
+      FlatMap<u32> map;
+      std::unordered_map<u32, u32> expected;
+      std::vector<u32> keys;
+
+      for (u32 i = 0; i < 200; i++) {
+        keys.push_back((u32)rng());
+      }
+
+      for (u32 i = 0; i < 20000; i++) {
+        u32 key = keys[(u32)rng() % keys.size()];
+
+        if (Gm_RandomInRange(0.f, 1.f) < 0.5f) {
+          map[key] = i;
+          expected[key] = i;
+        } else {
+          map.erase(key);
+          expected.erase(key);
+        }
+      }
+
+      if (!Gm_Check(map.size() == expected.size(), "expected " + std::to_string(expected.size()) + " entries, found " + std::to_string(map.size()))) {
+        return false;
+      }
+
+      for (u32 key : keys) {
+        auto* value = map.find(key);
+        auto entry = expected.find(key);
+
+        if (entry == expected.end()) {
+          if (!Gm_Check(value == nullptr, "key " + std::to_string(key) + " should not be found")) {
+            return false;
+          }
+        } else if (!Gm_Check(value != nullptr && *value == entry->second, "key " + std::to_string(key) + " should map to " + std::to_string(entry->second))) {
+          return false;
+        }
+      }
+
+      return true;
+    }
+  });
+}
+
+/**
+ * Gm_CheckCollisionPairsAgainstBruteForce
+ * ---------------------------------------
+ *
+ * Compares the pairs found through a collision grid with
+ * those found by testing every collider against every other,
+ * including colliders larger than a grid cell and a collider
+ * large enough to be tested against the whole grid.
+ */
+static bool Gm_CheckCollisionPairsAgainstBruteForce(CollisionShape shape) {
+  CollisionGrid grid;
+  CollisionLayer gridLayer;
+  CollisionLayer queryLayer;
+  std::vector<CollisionPair> pairs;
+  std::vector<std::pair<u32, u32>> found;
+  std::vector<std::pair<u32, u32>> expected;
+
+  grid.cellSize = 16.f;
+  // Few buckets, so distant cells share buckets
+  grid.totalBuckets = 64;
+
+  for (u32 i = 0; i < 400; i++) {
+    float size = i % 50 == 0 ? 40.f : Gm_RandomInRange(1.f, 6.f);
+
+    Gm_AddCollider(gridLayer, i, Gm_RandomInRange(-200.f, 200.f), Gm_RandomInRange(-200.f, 200.f), size);
+  }
+
+  for (u32 i = 0; i < 200; i++) {
+    float size = i % 50 == 0 ? 30.f : Gm_RandomInRange(1.f, 6.f);
+
+    Gm_AddCollider(queryLayer, 1000 + i, Gm_RandomInRange(-200.f, 200.f), Gm_RandomInRange(-200.f, 200.f), size);
+  }
+
+  // Spans far more cells than a query visits bucket by bucket
+  Gm_AddCollider(queryLayer, 2000, 0.f, 0.f, 300.f);
+
+  Gm_BuildCollisionGrid(grid, gridLayer);
+  Gm_FindCollisionPairs(grid, queryLayer, shape, pairs);
+
+  for (auto& pair : pairs) {
+    found.push_back({ pair.a, pair.b });
+  }
+
+  for (u32 i = 0; i < queryLayer.ids.size(); i++) {
+    for (u32 j = 0; j < gridLayer.ids.size(); j++) {
+      float dx = gridLayer.x[j] - queryLayer.x[i];
+      float dz = gridLayer.z[j] - queryLayer.z[i];
+      float reach = gridLayer.size[j] + queryLayer.size[i];
+      bool isOverlapping = shape == CollisionShape::AABB
+        ? fabsf(dx) <= reach && fabsf(dz) <= reach
+        : dx * dx + dz * dz <= reach * reach;
+
+      if (isOverlapping) {
+        expected.push_back({ gridLayer.ids[j], queryLayer.ids[i] });
+      }
+    }
+  }
+
+  std::sort(found.begin(), found.end());
+  std::sort(expected.begin(), expected.end());
+
+  u32 totalLargePairs = (u32)std::count_if(expected.begin(), expected.end(), [](auto& pair) {
+    return pair.second == 2000;
+  });
+
+  return (
+    Gm_Check(totalLargePairs > 0, "the largest collider should overlap grid colliders") &&
+    Gm_Check(std::adjacent_find(found.begin(), found.end()) == found.end(), "no pair should be reported twice") &&
+    Gm_Check(found == expected, "expected " + std::to_string(expected.size()) + " pairs, found " + std::to_string(found.size()))
+  );
+}
+
+static void Gm_AddBroadphaseTests(std::vector<TestCase>& tests) {
+  tests.push_back({
+    "broadphase/aabb_pairs_match_brute_force",
+    []() {
+      return Gm_CheckCollisionPairsAgainstBruteForce(CollisionShape::AABB);
+    }
+  });
+
+  tests.push_back({
+    "broadphase/circle_pairs_match_brute_force",
+    []() {
+      return Gm_CheckCollisionPairsAgainstBruteForce(CollisionShape::CIRCLE);
+    }
+  });
+}
+
+int main(int argc, char* argv[]) {
+  const char* filter = argc > 1 ? argv[1] : nullptr;
+  std::vector<TestCase> tests;
+  u32 totalFailed = 0;
+
+  Gm_AddLightClusterTests(tests);
+  Gm_AddDepthSortTests(tests);
+  Gm_AddObjectPoolTests(tests);
+  Gm_AddOcclusionTests(tests);
+  Gm_AddFlatMapTests(tests);
+  Gm_AddBroadphaseTests(tests);
+
+  for (auto& test : tests) {
+    if (filter != nullptr && test.name.find(filter) == std::string::npos) {
+      continue;
+    }
+
+    bool passed = test.test();
+
+    printf("%-50s %s\n", test.name.c_str(), passed ? "passed" : "FAILED");
+
+    if (!passed) {
+      totalFailed++;
+    }
+  }
+
+  if (totalFailed > 0) {
+    printf("\n%u test(s) failed\n", totalFailed);
+
+    return 1;
+  }
+
+  return 0;
+}
\ No newline at end of file